@@ -0,0 +1,1182 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <inttypes.h>
+#include "pberr.h"
+#include "pbjson.h"
+
+// Number of structures in the array of the benchmark JSON
+#define BENCH_NBSTRUCT 50000
+// Number of times each measure is repeated
+#define BENCH_NBREPEAT 5
+
+// Return the current time in seconds
+double BenchGetTime() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Return the size in bytes of the file 'path'
+long BenchGetFileSize(const char* const path) {
+  FILE* fd = fopen(path, "r");
+  fseek(fd, 0, SEEK_END);
+  long size = ftell(fd);
+  fclose(fd);
+  return size;
+}
+
+// Create a JSON made of an array of BENCH_NBSTRUCT structures similar 
+// to the ones of the unit tests
+JSONNode* BenchCreateJSON() {
+  JSONNode* json = JSONCreate();
+  JSONArrayStruct setStruct = JSONArrayStructCreateStatic();
+  char val[100];
+  for (int i = 0; i < BENCH_NBSTRUCT; ++i) {
+    JSONNode* elem = JSONCreate();
+    sprintf(val, "%d", i);
+    JSONAddProp(elem, "_intVal", val);
+    sprintf(val, "%f", (float)i * 0.5);
+    JSONAddProp(elem, "_floatVal", val);
+    JSONArrayVal setVal = JSONArrayValCreateStatic();
+    for (int j = 0; j < 3; ++j) {
+      sprintf(val, "%d", i + j);
+      JSONArrayValAdd(&setVal, val);
+    }
+    JSONAddProp(elem, "_intArr", &setVal);
+    JSONArrayValFlush(&setVal);
+    JSONArrayStructAdd(&setStruct, elem);
+  }
+  JSONAddProp(json, "_structArr", &setStruct);
+  JSONArrayStructFlush(&setStruct);
+  return json;
+}
+
+// Save the benchmark JSON in the file 'path' in compact or readable 
+// form
+void BenchCreateFile(const char* const path, const bool compact) {
+  JSONNode* json = BenchCreateJSON();
+  FILE* fd = fopen(path, "w");
+  if (!JSONSave(json, fd, compact)) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONSave failed");
+    PBErrCatch(JSONErr);
+  }
+  fclose(fd);
+  JSONFree(&json);
+}
+
+// Measure the throughput of reading the file 'path' one char at a time 
+// with fscanf, which was the way the loader used to read its input
+// Return the throughput in MB/s
+double BenchFscanf(const char* const path) {
+  long size = BenchGetFileSize(path);
+  double start = BenchGetTime();
+  for (int i = BENCH_NBREPEAT; i--;) {
+    FILE* fd = fopen(path, "r");
+    char c;
+    while (fscanf(fd, "%c", &c) != EOF);
+    fclose(fd);
+  }
+  double delay = BenchGetTime() - start;
+  return (double)size * BENCH_NBREPEAT / delay / 1e6;
+}
+
+// Measure the throughput of JSONLoad on the file 'path'
+// Return the throughput in MB/s
+double BenchJSONLoad(const char* const path) {
+  long size = BenchGetFileSize(path);
+  double delay = 0.0;
+  for (int i = BENCH_NBREPEAT; i--;) {
+    FILE* fd = fopen(path, "r");
+    JSONNode* json = JSONCreate();
+    double start = BenchGetTime();
+    if (!JSONLoad(json, fd)) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONLoad failed");
+      PBErrCatch(JSONErr);
+    }
+    delay += BenchGetTime() - start;
+    JSONFree(&json);
+    fclose(fd);
+  }
+  return (double)size * BENCH_NBREPEAT / delay / 1e6;
+}
+
+// Measure the throughput of JSONLoad on the file 'path' with the nodes
+// allocated in an arena, including the release of the tree
+// Return the throughput in MB/s
+double BenchJSONLoadArena(const char* const path) {
+  long size = BenchGetFileSize(path);
+  double delay = 0.0;
+  JSONArena* arena = JSONArenaCreate();
+  for (int i = BENCH_NBREPEAT; i--;) {
+    FILE* fd = fopen(path, "r");
+    double start = BenchGetTime();
+    JSONNode* json = JSONCreateInArena(arena);
+    if (!JSONLoad(json, fd)) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONLoad failed");
+      PBErrCatch(JSONErr);
+    }
+    JSONArenaReset(arena);
+    delay += BenchGetTime() - start;
+    fclose(fd);
+  }
+  JSONArenaFree(&arena);
+  return (double)size * BENCH_NBREPEAT / delay / 1e6;
+}
+
+// Measure the throughput of JSONLoadMapped on the file 'path', the 
+// tree being released with the arena which also unmaps the file
+double BenchJSONLoadMapped(const char* const path) {
+  long size = BenchGetFileSize(path);
+  double delay = 0.0;
+  JSONArena* arena = JSONArenaCreate();
+  for (int i = BENCH_NBREPEAT; i--;) {
+    double start = BenchGetTime();
+    JSONNode* json = JSONCreateInArena(arena);
+    if (!JSONLoadMapped(json, path)) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONLoadMapped failed");
+      PBErrCatch(JSONErr);
+    }
+    JSONArenaReset(arena);
+    delay += BenchGetTime() - start;
+  }
+  JSONArenaFree(&arena);
+  return (double)size * BENCH_NBREPEAT / delay / 1e6;
+}
+
+// Callback of the event handler of BenchJSONParse, counting the values
+bool BenchCountVal(void* const data, const char* const str, 
+  const size_t len) {
+  (void)str;
+  (void)len;
+  ++(*(long*)data);
+  return true;
+}
+
+// Measure the throughput of JSONParse on the file 'path', counting the 
+// values without building the tree
+// Return the throughput in MB/s
+double BenchJSONParse(const char* const path) {
+  long size = BenchGetFileSize(path);
+  double delay = 0.0;
+  for (int i = BENCH_NBREPEAT; i--;) {
+    FILE* fd = fopen(path, "r");
+    long nbVal = 0;
+    JSONEventHandler handler = {._val = BenchCountVal, ._data = &nbVal};
+    double start = BenchGetTime();
+    if (!JSONParse(&handler, fd) || nbVal != 5 * BENCH_NBSTRUCT) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONParse failed");
+      PBErrCatch(JSONErr);
+    }
+    delay += BenchGetTime() - start;
+    fclose(fd);
+  }
+  return (double)size * BENCH_NBREPEAT / delay / 1e6;
+}
+
+// Measure the throughput of JSONFeed on the file 'path', fed by chunks
+// of the size of a network packet
+// Return the throughput in MB/s
+double BenchJSONFeed(const char* const path) {
+  long size = BenchGetFileSize(path);
+  double delay = 0.0;
+  char chunk[1460];
+  for (int i = BENCH_NBREPEAT; i--;) {
+    FILE* fd = fopen(path, "r");
+    JSONNode* json = JSONCreate();
+    double start = BenchGetTime();
+    JSONFeeder* feeder = JSONFeederCreate(json);
+    JSONFeedRet ret = JSONFeedNeedMore;
+    size_t len = 0;
+    while (ret == JSONFeedNeedMore && 
+      (len = fread(chunk, sizeof(char), sizeof(chunk), fd)) > 0)
+      ret = JSONFeed(feeder, chunk, len, NULL);
+    JSONFeederFree(&feeder);
+    delay += BenchGetTime() - start;
+    if (ret != JSONFeedComplete) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONFeed failed");
+      PBErrCatch(JSONErr);
+    }
+    JSONFree(&json);
+    fclose(fd);
+  }
+  return (double)size * BENCH_NBREPEAT / delay / 1e6;
+}
+
+void BenchLoad() {
+  const char* paths[2] = 
+    {"./benchJsonReadable.txt", "./benchJsonCompact.txt"};
+  for (int iPath = 0; iPath < 2; ++iPath) {
+    BenchCreateFile(paths[iPath], (iPath == 1));
+    printf("%s (%ld bytes)\n", paths[iPath], 
+      BenchGetFileSize(paths[iPath]));
+    printf("  fscanf char by char: %8.2f MB/s\n", 
+      BenchFscanf(paths[iPath]));
+    printf("  JSONLoad:            %8.2f MB/s\n", 
+      BenchJSONLoad(paths[iPath]));
+    printf("  JSONLoad (arena):    %8.2f MB/s\n", 
+      BenchJSONLoadArena(paths[iPath]));
+    printf("  JSONLoadMapped:      %8.2f MB/s\n", 
+      BenchJSONLoadMapped(paths[iPath]));
+    printf("  JSONFeed (chunks):   %8.2f MB/s\n", 
+      BenchJSONFeed(paths[iPath]));
+    printf("  JSONParse (events):  %8.2f MB/s\n", 
+      BenchJSONParse(paths[iPath]));
+    remove(paths[iPath]);
+  }
+  printf("BenchLoad OK\n");
+}
+
+// Measure the throughput of the loader and the event parser on the 
+// readable and compact benchmark files with each instruction set used
+// to skip the spaces and scan the strings
+void BenchScan() {
+  const char* paths[2] = 
+    {"./benchJsonReadable.txt", "./benchJsonCompact.txt"};
+  const char* names[3] = {"scalar", "SSE2  ", "AVX2  "};
+  JSONSimd best = JSONGetSimd();
+  for (int iPath = 0; iPath < 2; ++iPath) {
+    BenchCreateFile(paths[iPath], (iPath == 1));
+    printf("%s (%ld bytes)\n", paths[iPath], 
+      BenchGetFileSize(paths[iPath]));
+    for (int iSimd = JSONSimdScalar; iSimd <= (int)best; ++iSimd) {
+      (void)JSONSetSimd((JSONSimd)iSimd);
+      printf("  %s JSONLoad (arena): %8.2f MB/s, "
+        "JSONParse (events): %8.2f MB/s\n", names[iSimd], 
+        BenchJSONLoadArena(paths[iPath]), BenchJSONParse(paths[iPath]));
+    }
+    remove(paths[iPath]);
+  }
+  (void)JSONSetSimd(best);
+  printf("BenchScan OK\n");
+}
+
+// Number of top level properties of the file of BenchLazy, and 
+// number of them accessed after loading
+#define BENCH_NBLAZYPROP 1000
+#define BENCH_NBLAZYACCESS 50
+
+// Measure the time to load a file made of BENCH_NBLAZYPROP objects and
+// access BENCH_NBLAZYACCESS of them (5% of the data), with the usual 
+// loading and the lazy one
+void BenchLazy() {
+  // Create the file, each property is an object with an array of 
+  // structs similar to the ones of BenchCreateJSON
+  const char* path = "./benchJsonLazy.txt";
+  JSONNode* json = JSONCreate();
+  char key[100];
+  char val[100];
+  for (int iProp = 0; iProp < BENCH_NBLAZYPROP; ++iProp) {
+    JSONNode* obj = JSONCreate();
+    JSONArrayStruct setStruct = JSONArrayStructCreateStatic();
+    for (int i = 0; i < BENCH_NBSTRUCT / BENCH_NBLAZYPROP; ++i) {
+      JSONNode* elem = JSONCreate();
+      JSONAddProp(elem, "_intVal", (int64_t)i);
+      sprintf(val, "%f", (float)i * 0.5);
+      JSONAddProp(elem, "_floatVal", val);
+      JSONArrayStructAdd(&setStruct, elem);
+    }
+    JSONAddProp(obj, "_structArr", &setStruct);
+    JSONArrayStructFlush(&setStruct);
+    sprintf(key, "prop%d", iProp);
+    JSONAddProp(json, key, obj);
+  }
+  FILE* fd = fopen(path, "w");
+  if (!JSONSave(json, fd, true)) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONSave failed");
+    PBErrCatch(JSONErr);
+  }
+  fclose(fd);
+  JSONFree(&json);
+  printf("%s (%ld bytes)\n", path, BenchGetFileSize(path));
+  const char* names[3] = 
+    {"JSONLoad (arena)      ", "JSONLoad (lazy)       ", 
+    "JSONLoadMapped (lazy) "};
+  for (int iMode = 0; iMode < 3; ++iMode) {
+    JSONArena* arena = JSONArenaCreate();
+    JSONArenaSetLazy(arena, (iMode > 0));
+    double delay = 0.0;
+    for (int iRepeat = BENCH_NBREPEAT; iRepeat--;) {
+      fd = fopen(path, "r");
+      double start = BenchGetTime();
+      json = JSONCreateInArena(arena);
+      bool ret = (iMode < 2 ? JSONLoad(json, fd) : 
+        JSONLoadMapped(json, path));
+      // Access the last struct of every 20th property
+      int64_t sum = 0;
+      for (int iProp = 0; ret && iProp < BENCH_NBLAZYPROP; 
+        iProp += BENCH_NBLAZYPROP / BENCH_NBLAZYACCESS) {
+        sprintf(key, "prop%d", iProp);
+        JSONNode* arr = JSONProperty(JSONProperty(json, key), "_structArr");
+        JSONNode* elem = JSONValue(arr, JSONGetNbValue(arr) - 1);
+        sum += JSONIntVal(JSONProperty(elem, "_intVal"));
+      }
+      if (!ret || sum != (int64_t)BENCH_NBLAZYACCESS * 
+        (BENCH_NBSTRUCT / BENCH_NBLAZYPROP - 1)) {
+        JSONErr->_type = PBErrTypeUnitTestFailed;
+        sprintf(JSONErr->_msg, "JSONLoad failed");
+        PBErrCatch(JSONErr);
+      }
+      JSONArenaReset(arena);
+      delay += BenchGetTime() - start;
+      fclose(fd);
+    }
+    JSONArenaFree(&arena);
+    printf("  %s load + access 5%%: %8.2f ms\n", names[iMode], 
+      delay / BENCH_NBREPEAT * 1e3);
+  }
+  remove(path);
+  printf("BenchLazy OK\n");
+}
+
+// Number of times the queries of BenchPath on a loaded JSON are 
+// repeated
+#define BENCH_NBPATHQUERY 1000
+
+// Measure the time to select the _intVal of the structs 100 to 199 of 
+// the benchmark JSON with chained calls to JSONProperty and JSONValue,
+// with a compiled path on the loaded JSON, and with the same path 
+// applied while loading the file
+void BenchPath() {
+  const char* path = "./benchJsonPath.txt";
+  BenchCreateFile(path, true);
+  printf("%s (%ld bytes)\n", path, BenchGetFileSize(path));
+  JSONPath* query = JSONPathCompile("$._structArr[100:200]._intVal");
+  long sumRef = (100 + 199) * 100 / 2;
+  // Queries on the loaded JSON
+  FILE* fd = fopen(path, "r");
+  JSONNode* json = JSONCreate();
+  if (query == NULL || !JSONLoad(json, fd)) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONLoad failed");
+    PBErrCatch(JSONErr);
+  }
+  fclose(fd);
+  const char* names[2] = 
+    {"JSONProperty/JSONValue", "JSONPathEval          "};
+  for (int iMode = 0; iMode < 2; ++iMode) {
+    JSONArrayStruct matches = JSONArrayStructCreateStatic();
+    long sum = 0;
+    double start = BenchGetTime();
+    for (int iRepeat = BENCH_NBPATHQUERY; iRepeat--;) {
+      if (iMode == 0) {
+        JSONNode* arr = JSONProperty(json, "_structArr");
+        for (long i = 100; i < 200; ++i)
+          sum += atol(JSONLblVal(JSONProperty(JSONValue(arr, i), 
+            "_intVal")));
+      } else {
+        JSONPathEval(query, json, &matches);
+        while (GSetNbElem(&matches) > 0)
+          sum += atol(JSONLblVal(GSetPop(&matches)));
+      }
+    }
+    double delay = BenchGetTime() - start;
+    JSONArrayStructFlush(&matches);
+    if (sum != sumRef * BENCH_NBPATHQUERY) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONPathEval failed");
+      PBErrCatch(JSONErr);
+    }
+    printf("  %s: %8.2f us/query\n", names[iMode], 
+      delay / BENCH_NBPATHQUERY * 1e6);
+  }
+  JSONFree(&json);
+  // Loading of the whole file followed by the query, and loading of 
+  // the selected nodes only
+  const char* namesLoad[2] = 
+    {"JSONLoad + JSONPathEval", "JSONPathLoad           "};
+  for (int iMode = 0; iMode < 2; ++iMode) {
+    double delay = 0.0;
+    for (int iRepeat = BENCH_NBREPEAT; iRepeat--;) {
+      fd = fopen(path, "r");
+      double start = BenchGetTime();
+      JSONArrayStruct matches = JSONArrayStructCreateStatic();
+      json = JSONCreate();
+      bool ret = true;
+      if (iMode == 0)
+        ret = JSONLoad(json, fd) && 
+          JSONPathEval(query, json, &matches) == 100;
+      else
+        ret = JSONPathLoad(query, json, fd) && JSONGetNbValue(json) == 100;
+      JSONArrayStructFlush(&matches);
+      JSONFree(&json);
+      delay += BenchGetTime() - start;
+      fclose(fd);
+      if (!ret) {
+        JSONErr->_type = PBErrTypeUnitTestFailed;
+        sprintf(JSONErr->_msg, "JSONPathLoad failed");
+        PBErrCatch(JSONErr);
+      }
+    }
+    printf("  %s: %8.2f ms\n", namesLoad[iMode], 
+      delay / BENCH_NBREPEAT * 1e3);
+  }
+  JSONPathFree(&query);
+  remove(path);
+  printf("BenchPath OK\n");
+}
+
+// Measure the size of the benchmark JSON and the time to save and load
+// it in compact text form and in the binary encoding
+void BenchBinary() {
+  const char* paths[2] = {"./benchJsonText.txt", "./benchJsonBinary.bin"};
+  const char* names[2] = {"text (compact)", "binary        "};
+  JSONNode* json = BenchCreateJSON();
+  for (int iMode = 0; iMode < 2; ++iMode) {
+    double delaySave = 0.0;
+    double delayLoad = 0.0;
+    for (int iRepeat = BENCH_NBREPEAT; iRepeat--;) {
+      FILE* fd = fopen(paths[iMode], "w");
+      double start = BenchGetTime();
+      bool ret = (iMode == 0 ? JSONSave(json, fd, true) : 
+        JSONSaveBinary(json, fd));
+      delaySave += BenchGetTime() - start;
+      fclose(fd);
+      fd = fopen(paths[iMode], "r");
+      JSONArena* arena = JSONArenaCreate();
+      start = BenchGetTime();
+      JSONNode* jsonLoad = JSONCreateInArena(arena);
+      ret = ret && (iMode == 0 ? JSONLoad(jsonLoad, fd) : 
+        JSONLoadBinary(jsonLoad, fd));
+      delayLoad += BenchGetTime() - start;
+      fclose(fd);
+      if (!ret || JSONGetNbValue(JSONProperty(jsonLoad, "_structArr")) != 
+        BENCH_NBSTRUCT) {
+        JSONErr->_type = PBErrTypeUnitTestFailed;
+        sprintf(JSONErr->_msg, "JSONLoadBinary failed");
+        PBErrCatch(JSONErr);
+      }
+      JSONArenaFree(&arena);
+    }
+    printf("  %s: %9ld bytes, save %8.2f ms, load (arena) %8.2f ms\n", 
+      names[iMode], BenchGetFileSize(paths[iMode]), 
+      delaySave / BENCH_NBREPEAT * 1e3, delayLoad / BENCH_NBREPEAT * 1e3);
+    remove(paths[iMode]);
+  }
+  JSONFree(&json);
+  printf("BenchBinary OK\n");
+}
+
+// Struct of the elements of the array of BenchStructCodec
+struct BenchStruct {
+  int _intVal;
+  float _floatVal;
+  int _intArr[3];
+};
+
+// Struct saved and loaded by BenchStructCodec, similar to the 
+// benchmark JSON
+struct BenchStructArr {
+  struct BenchStruct _structArr[BENCH_NBSTRUCT];
+};
+
+static const JSONStructField BenchStructFields[] = {
+  JSONStructFieldDef(struct BenchStruct, _intVal, JSONFieldInt, 0, NULL),
+  JSONStructFieldDef(struct BenchStruct, _floatVal, JSONFieldFloat, 0, 
+    NULL),
+  JSONStructFieldDef(struct BenchStruct, _intArr, JSONFieldInt, 3, NULL)
+};
+static const JSONStructDesc BenchStructDesc = 
+  JSONStructDescDef(BenchStructFields);
+static const JSONStructField BenchStructArrFields[] = {
+  JSONStructFieldDef(struct BenchStructArr, _structArr, JSONFieldStruct, 
+    BENCH_NBSTRUCT, &BenchStructDesc)
+};
+static const JSONStructDesc BenchStructArrDesc = 
+  JSONStructDescDef(BenchStructArrFields);
+
+// Save the struct 'that' on the stream 'stream' by encoding it in a 
+// JSON tree, as in the README
+bool BenchStructTreeSave(const struct BenchStructArr* const that, 
+  FILE* const stream) {
+  JSONNode* json = JSONCreate();
+  JSONArrayStruct setStruct = JSONArrayStructCreateStatic();
+  char val[PBJSON_SCALARSIZE];
+  for (int i = 0; i < BENCH_NBSTRUCT; ++i) {
+    const struct BenchStruct* elem = that->_structArr + i;
+    JSONNode* node = JSONCreate();
+    JSONAddProp(node, "_intVal", elem->_intVal);
+    JSONAddProp(node, "_floatVal", elem->_floatVal);
+    JSONArrayVal setVal = JSONArrayValCreateStatic();
+    for (int j = 0; j < 3; ++j) {
+      (void)JSONFormatInt(elem->_intArr[j], val);
+      JSONArrayValAdd(&setVal, val);
+    }
+    JSONAddProp(node, "_intArr", &setVal);
+    JSONArrayValFlush(&setVal);
+    JSONArrayStructAdd(&setStruct, node);
+  }
+  JSONAddProp(json, "_structArr", &setStruct);
+  JSONArrayStructFlush(&setStruct);
+  bool ret = JSONSave(json, stream, true);
+  JSONFree(&json);
+  return ret;
+}
+
+// Load the struct 'that' from the stream 'stream' by decoding a JSON 
+// tree with JSONProperty, as in the README
+bool BenchStructTreeLoad(struct BenchStructArr* const that, 
+  FILE* const stream) {
+  JSONNode* json = JSONCreate();
+  if (!JSONLoad(json, stream)) {
+    JSONFree(&json);
+    return false;
+  }
+  JSONNode* arr = JSONProperty(json, "_structArr");
+  for (int i = 0; i < BENCH_NBSTRUCT; ++i) {
+    struct BenchStruct* elem = that->_structArr + i;
+    JSONNode* node = JSONValue(arr, i);
+    elem->_intVal = (int)JSONIntVal(JSONProperty(node, "_intVal"));
+    elem->_floatVal = (float)JSONRealVal(JSONProperty(node, "_floatVal"));
+    JSONNode* prop = JSONProperty(node, "_intArr");
+    for (int j = 0; j < 3; ++j)
+      elem->_intArr[j] = atoi(JSONLabel(JSONValue(prop, j)));
+  }
+  JSONFree(&json);
+  return true;
+}
+
+// Measure the time to save and load an array of BENCH_NBSTRUCT structs
+// through a JSON tree and with the struct codec
+void BenchStructCodec() {
+  const char* path = "./benchJsonStruct.txt";
+  struct BenchStructArr* data = PBErrMalloc(JSONErr, sizeof(*data));
+  struct BenchStructArr* dataLoad = PBErrMalloc(JSONErr, sizeof(*data));
+  for (int i = 0; i < BENCH_NBSTRUCT; ++i) {
+    data->_structArr[i]._intVal = i;
+    data->_structArr[i]._floatVal = (float)i * 0.5f;
+    for (int j = 0; j < 3; ++j)
+      data->_structArr[i]._intArr[j] = i + j;
+  }
+  const char* names[2] = {"JSON tree   ", "struct codec"};
+  for (int iMode = 0; iMode < 2; ++iMode) {
+    double delaySave = 0.0;
+    double delayLoad = 0.0;
+    for (int iRepeat = BENCH_NBREPEAT; iRepeat--;) {
+      FILE* fd = fopen(path, "w");
+      double start = BenchGetTime();
+      bool ret = (iMode == 0 ? BenchStructTreeSave(data, fd) : 
+        JSONStructSave(data, &BenchStructArrDesc, fd, true));
+      delaySave += BenchGetTime() - start;
+      fclose(fd);
+      memset(dataLoad, 0, sizeof(*dataLoad));
+      fd = fopen(path, "r");
+      start = BenchGetTime();
+      ret = ret && (iMode == 0 ? BenchStructTreeLoad(dataLoad, fd) : 
+        JSONStructLoad(dataLoad, &BenchStructArrDesc, fd));
+      delayLoad += BenchGetTime() - start;
+      fclose(fd);
+      if (!ret || memcmp(data, dataLoad, sizeof(*data)) != 0) {
+        JSONErr->_type = PBErrTypeUnitTestFailed;
+        sprintf(JSONErr->_msg, "JSONStructLoad failed");
+        PBErrCatch(JSONErr);
+      }
+    }
+    printf("  %s: %9ld bytes, save %8.2f ms, load %8.2f ms\n", 
+      names[iMode], BenchGetFileSize(path), 
+      delaySave / BENCH_NBREPEAT * 1e3, delayLoad / BENCH_NBREPEAT * 1e3);
+  }
+  remove(path);
+  free(data);
+  free(dataLoad);
+  printf("BenchStructCodec OK\n");
+}
+
+// Write the benchmark JSON of BenchCreateJSON with the streaming 
+// writer 'writer'
+// Return true if it could write, false else
+bool BenchWriterWrite(JSONWriter* const writer) {
+  char val[100];
+  bool ret = JSONWriterBeginObject(writer) && 
+    JSONWriterKey(writer, "_structArr") && JSONWriterBeginArray(writer);
+  for (int i = 0; ret && i < BENCH_NBSTRUCT; ++i) {
+    ret = JSONWriterBeginObject(writer);
+    sprintf(val, "%d", i);
+    ret = ret && JSONWriterKey(writer, "_intVal") && 
+      JSONWriterValue(writer, val);
+    sprintf(val, "%f", (float)i * 0.5);
+    ret = ret && JSONWriterKey(writer, "_floatVal") && 
+      JSONWriterValue(writer, val) && 
+      JSONWriterKey(writer, "_intArr") && JSONWriterBeginArray(writer);
+    for (int j = 0; ret && j < 3; ++j) {
+      sprintf(val, "%d", i + j);
+      ret = JSONWriterValue(writer, val);
+    }
+    ret = ret && JSONWriterEndArray(writer) && JSONWriterEndObject(writer);
+  }
+  return ret && JSONWriterEndArray(writer) && JSONWriterEndObject(writer);
+}
+
+// Measure the time to save the benchmark JSON in memory by building 
+// the JSON tree then saving it, and with the streaming writer
+void BenchWriter() {
+  for (int iMode = 0; iMode < 2; ++iMode) {
+    bool compact = (iMode == 0);
+    // Reference output from the JSON tree
+    JSONNode* json = BenchCreateJSON();
+    size_t lenRef = 0;
+    char* bufRef = JSONSaveToBuffer(json, NULL, &lenRef, compact);
+    JSONFree(&json);
+    char* buf = PBErrMalloc(JSONErr, lenRef + 1);
+    double delayTree = 0.0;
+    double delayWriter = 0.0;
+    for (int iRepeat = BENCH_NBREPEAT; iRepeat--;) {
+      double start = BenchGetTime();
+      json = BenchCreateJSON();
+      char* bufTree = JSONSaveToBuffer(json, NULL, NULL, compact);
+      JSONFree(&json);
+      delayTree += BenchGetTime() - start;
+      free(bufTree);
+      start = BenchGetTime();
+      JSONWriter writer = JSONWriterCreateStatic(NULL, buf, lenRef + 1, 
+        compact);
+      size_t len = 0;
+      bool ret = BenchWriterWrite(&writer) && JSONWriterEnd(&writer, &len);
+      delayWriter += BenchGetTime() - start;
+      if (!ret || len != lenRef || memcmp(buf, bufRef, len) != 0) {
+        JSONErr->_type = PBErrTypeUnitTestFailed;
+        sprintf(JSONErr->_msg, "JSONWriter failed");
+        PBErrCatch(JSONErr);
+      }
+    }
+    printf("  %s (%zu bytes): tree + JSONSaveToBuffer %8.2f ms, "
+      "JSONWriter %8.2f ms\n", (compact ? "compact " : "readable"), 
+      lenRef, delayTree / BENCH_NBREPEAT * 1e3, 
+      delayWriter / BENCH_NBREPEAT * 1e3);
+    free(buf);
+    free(bufRef);
+  }
+  printf("BenchWriter OK\n");
+}
+
+// Compare the building of arrays of values copied by JSONAddProp and 
+// arrays of labels moved by JSONAddPropArrMove, and count the 
+// allocations per value
+void BenchArrMove() {
+  int nbVal = 8;
+  char val[100];
+  for (int iMode = 0; iMode < 2; ++iMode) {
+    bool flagMove = (iMode == 1);
+    double delay = 0.0;
+    JSONStats stats = {0};
+    for (int iRepeat = BENCH_NBREPEAT; iRepeat--;) {
+      JSONStatsReset();
+      double start = BenchGetTime();
+      for (int i = 0; i < BENCH_NBSTRUCT; ++i) {
+        JSONNode* json = JSONCreate();
+        if (flagMove) {
+          JSONArrayLbl setLbl = JSONArrayLblCreateStatic();
+          for (int j = 0; j < nbVal; ++j) {
+            sprintf(val, "%d", i + j);
+            JSONArrayLblAdd(&setLbl, val);
+          }
+          JSONAddPropArrMove(json, "_intArr", &setLbl);
+        } else {
+          JSONArrayVal setVal = JSONArrayValCreateStatic();
+          for (int j = 0; j < nbVal; ++j) {
+            sprintf(val, "%d", i + j);
+            JSONArrayValAdd(&setVal, val);
+          }
+          JSONAddProp(json, "_intArr", &setVal);
+          JSONArrayValFlush(&setVal);
+        }
+        JSONFree(&json);
+      }
+      delay += BenchGetTime() - start;
+      stats = JSONStatsGet();
+    }
+    // The copies made by JSONArrayValAdd are plain strings, not counted
+    // as labels
+    long nbCopy = (flagMove ? 0 : BENCH_NBSTRUCT * nbVal);
+    printf("  %s: %8.2f ms, %.2f allocations per value\n", 
+      (flagMove ? "JSONAddPropArrMove" : "JSONAddProp       "), 
+      delay / BENCH_NBREPEAT * 1e3, 
+      (double)(stats._nbLbl + nbCopy - BENCH_NBSTRUCT) / 
+      (double)(BENCH_NBSTRUCT * nbVal));
+  }
+  printf("BenchArrMove OK\n");
+}
+
+// Measure the overhead of the timing of the phases on JSONLoad and 
+// print the statistics of the loadings
+void BenchStats() {
+  const char* path = "./benchJsonCompact.txt";
+  BenchCreateFile(path, true);
+  JSONStatsSetTiming(false);
+  double speedOff = BenchJSONLoad(path);
+  JSONStatsReset();
+  JSONStatsSetTiming(true);
+  double speedOn = BenchJSONLoad(path);
+  JSONStats stats = JSONStatsGet();
+  JSONStatsSetTiming(false);
+  printf("  JSONLoad without timing: %8.2f MB/s, "
+    "with timing: %8.2f MB/s\n", speedOff, speedOn);
+  printf("  per load: %ld bytes read, %ld nodes, %ld labels "
+    "(%ld bytes), depth %ld\n", stats._nbByteRead / stats._nbLoad, 
+    stats._nbNode / stats._nbLoad, stats._nbLbl / stats._nbLoad, 
+    stats._nbLblByte / stats._nbLoad, stats._depthMax);
+  printf("  per load: read %8.2f ms, scan and build %8.2f ms, "
+    "free %8.2f ms\n", stats._timeRead / stats._nbLoad * 1e3, 
+    (stats._timeLoad - stats._timeRead) / stats._nbLoad * 1e3, 
+    stats._timeFree / stats._nbFree * 1e3);
+  remove(path);
+  printf("BenchStats OK\n");
+}
+
+// Measure the throughput of the saving and loading of strings without
+// chars to escape, and of strings with some chars to escape
+void BenchEscape() {
+  int nb = 100000;
+  const char* vals[2] = {
+    "The quick brown fox jumps over the lazy dog, again and again....",
+    "The \"quick\" brown fox\njumps over the lazy dog\\again\tand again"};
+  for (int iVal = 0; iVal < 2; ++iVal) {
+    JSONArena* arena = JSONArenaCreate();
+    JSONNode* json = JSONCreateInArena(arena);
+    for (int i = 0; i < nb; ++i)
+      JSONAddProp(json, "v", (char*)(vals[iVal]));
+    double delaySave = 0.0;
+    double delayLoad = 0.0;
+    size_t len = 0;
+    for (int iRepeat = BENCH_NBREPEAT; iRepeat--;) {
+      double start = BenchGetTime();
+      char* buf = JSONSaveToBuffer(json, NULL, &len, true);
+      delaySave += BenchGetTime() - start;
+      JSONNode* jsonLoad = JSONCreateInArena(arena);
+      start = BenchGetTime();
+      if (buf == NULL || !JSONLoadFromBuffer(jsonLoad, buf, len) ||
+        JSONGetNbValue(jsonLoad) != nb) {
+        JSONErr->_type = PBErrTypeUnitTestFailed;
+        sprintf(JSONErr->_msg, "JSONLoadFromBuffer failed");
+        PBErrCatch(JSONErr);
+      }
+      delayLoad += BenchGetTime() - start;
+      JSONFree(&jsonLoad);
+      free(buf);
+    }
+    printf("  %s save %8.2f MB/s, load %8.2f MB/s\n", 
+      (iVal == 0 ? "clean:  " : "escaped:"), 
+      (double)len * BENCH_NBREPEAT / delaySave / 1e6,
+      (double)len * BENCH_NBREPEAT / delayLoad / 1e6);
+    JSONArenaFree(&arena);
+  }
+  printf("BenchEscape OK\n");
+}
+
+// Create a file 'path' of BENCH_NBSTRUCT records, one per line, 
+// similar to the structures of the benchmark JSON
+void BenchCreateRecords(const char* const path) {
+  FILE* fd = fopen(path, "w");
+  for (int i = 0; i < BENCH_NBSTRUCT; ++i)
+    fprintf(fd, 
+      "{\"_intVal\":\"%d\",\"_floatVal\":\"%f\",\"_intArr\":"
+      "[\"%d\",\"%d\",\"%d\"]}\n", 
+      i, (float)i * 0.5, i, i + 1, i + 2);
+  fclose(fd);
+}
+
+// Measure the speed of reading the records of the file 'path' with 
+// JSONRecords, and with JSONLoad and a new JSON per record
+void BenchRecords() {
+  const char* path = "./benchJsonRecords.txt";
+  BenchCreateRecords(path);
+  double delay = 0.0;
+  for (int i = BENCH_NBREPEAT; i--;) {
+    FILE* fd = fopen(path, "r");
+    double start = BenchGetTime();
+    JSONRecords* records = JSONRecordsCreate(fd);
+    while (JSONRecordsNext(records) != NULL);
+    delay += BenchGetTime() - start;
+    if (JSONRecordsGetNb(records) != BENCH_NBSTRUCT) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONRecordsNext failed");
+      PBErrCatch(JSONErr);
+    }
+    JSONRecordsFree(&records);
+    fclose(fd);
+  }
+  printf("  JSONRecordsNext:        %10.0f records/s\n", 
+    (double)BENCH_NBSTRUCT * BENCH_NBREPEAT / delay);
+  delay = 0.0;
+  for (int i = BENCH_NBREPEAT; i--;) {
+    FILE* fd = fopen(path, "r");
+    double start = BenchGetTime();
+    for (int iRecord = BENCH_NBSTRUCT; iRecord--;) {
+      JSONNode* json = JSONCreate();
+      if (!JSONLoad(json, fd)) {
+        JSONErr->_type = PBErrTypeUnitTestFailed;
+        sprintf(JSONErr->_msg, "JSONLoad failed");
+        PBErrCatch(JSONErr);
+      }
+      JSONFree(&json);
+    }
+    delay += BenchGetTime() - start;
+    fclose(fd);
+  }
+  printf("  JSONLoad and JSONFree:  %10.0f records/s\n", 
+    (double)BENCH_NBSTRUCT * BENCH_NBREPEAT / delay);
+  remove(path);
+  printf("BenchRecords OK\n");
+}
+
+// Callback of BenchRecordsParallel, counting the records per thread
+bool BenchCountRecord(JSONNode* const record, const int iThread, 
+  void* const data) {
+  (void)record;
+  ++(((long*)data)[iThread]);
+  return true;
+}
+
+// Measure the speed of reading records in memory with 
+// JSONRecordsParallel and an increasing number of threads
+void BenchRecordsParallel() {
+  int nbRecord = 8 * BENCH_NBSTRUCT;
+  char* buf = PBErrMalloc(JSONErr, sizeof(char) * 100 * nbRecord);
+  size_t len = 0;
+  for (int i = 0; i < nbRecord; ++i)
+    len += sprintf(buf + len, 
+      "{\"_intVal\":\"%d\",\"_floatVal\":\"%f\",\"_intArr\":"
+      "[\"%d\",\"%d\",\"%d\"]}\n", 
+      i, (float)i * 0.5, i, i + 1, i + 2);
+  for (int nbThread = 1; nbThread <= 32; nbThread *= 2) {
+    long counts[32] = {0};
+    double start = BenchGetTime();
+    if (!JSONRecordsParallel(buf, len, nbThread, BenchCountRecord, 
+      counts)) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONRecordsParallel failed");
+      PBErrCatch(JSONErr);
+    }
+    double delay = BenchGetTime() - start;
+    long nb = 0;
+    for (int iThread = 0; iThread < nbThread; ++iThread)
+      nb += counts[iThread];
+    if (nb != nbRecord) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONRecordsParallel failed");
+      PBErrCatch(JSONErr);
+    }
+    printf("  %2d threads: %10.0f records/s %8.2f MB/s\n", nbThread, 
+      (double)nbRecord / delay, (double)len / delay / 1e6);
+  }
+  free(buf);
+  printf("BenchRecordsParallel OK\n");
+}
+
+// Measure the speed of JSONProperty on objects of increasing size
+void BenchProperty() {
+  char key[20];
+  for (int nb = 10; nb <= 100000; nb *= 10) {
+    JSONNode* json = JSONCreate();
+    for (int i = 0; i < nb; ++i) {
+      sprintf(key, "key%d", i);
+      JSONAddProp(json, key, key);
+    }
+    // Lookup every property, several times for the small objects
+    int nbRepeat = 1000000 / nb;
+    double start = BenchGetTime();
+    for (int iRepeat = nbRepeat; iRepeat--;) {
+      for (int i = 0; i < nb; ++i) {
+        sprintf(key, "key%d", i);
+        if (JSONProperty(json, key) == NULL) {
+          JSONErr->_type = PBErrTypeUnitTestFailed;
+          sprintf(JSONErr->_msg, "JSONProperty failed");
+          PBErrCatch(JSONErr);
+        }
+      }
+    }
+    double delay = BenchGetTime() - start;
+    printf("  %6d properties: %8.1f ns/lookup\n", nb, 
+      delay / (double)nbRepeat / (double)nb * 1e9);
+    JSONFree(&json);
+  }
+  printf("BenchProperty OK\n");
+}
+
+// Measure the speed of a decode loop on JSONValue on arrays of 
+// increasing size
+void BenchValue() {
+  char val[20];
+  for (int nb = 10; nb <= 100000; nb *= 10) {
+    JSONNode* json = JSONCreate();
+    JSONArrayVal setVal = JSONArrayValCreateStatic();
+    for (int i = 0; i < nb; ++i) {
+      sprintf(val, "%d", i);
+      JSONArrayValAdd(&setVal, val);
+    }
+    JSONAddProp(json, "arr", &setVal);
+    JSONArrayValFlush(&setVal);
+    JSONNode* arr = JSONProperty(json, "arr");
+    // Decode every value, several times for the small arrays
+    int nbRepeat = 1000000 / nb;
+    long sum = 0;
+    double start = BenchGetTime();
+    for (int iRepeat = nbRepeat; iRepeat--;)
+      for (int i = 0; i < JSONGetNbValue(arr); ++i)
+        sum += atol(JSONLabel(JSONValue(arr, i)));
+    double delay = BenchGetTime() - start;
+    if (sum != (long)nbRepeat * (long)nb * (long)(nb - 1) / 2) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONValue failed");
+      PBErrCatch(JSONErr);
+    }
+    printf("  %6d values: %8.1f ns/value\n", nb, 
+      delay / (double)nbRepeat / (double)nb * 1e9);
+    JSONFree(&json);
+  }
+  printf("BenchValue OK\n");
+}
+
+// Measure the throughput of JSONSave of the benchmark JSON in compact 
+// and readable form
+void BenchSave() {
+  JSONNode* json = BenchCreateJSON();
+  const char* path = "./benchJsonSave.txt";
+  for (int compact = 0; compact < 2; ++compact) {
+    double delay = 0.0;
+    for (int i = BENCH_NBREPEAT; i--;) {
+      FILE* fd = fopen(path, "w");
+      double start = BenchGetTime();
+      if (!JSONSave(json, fd, compact)) {
+        JSONErr->_type = PBErrTypeUnitTestFailed;
+        sprintf(JSONErr->_msg, "JSONSave failed");
+        PBErrCatch(JSONErr);
+      }
+      fflush(fd);
+      delay += BenchGetTime() - start;
+      fclose(fd);
+    }
+    long size = BenchGetFileSize(path);
+    printf("  JSONSave %s (%ld bytes): %8.2f MB/s\n", 
+      (compact ? "compact " : "readable"), size, 
+      (double)size * BENCH_NBREPEAT / delay / 1e6);
+    remove(path);
+    // Save in memory, and only count the bytes
+    delay = 0.0;
+    double delaySize = 0.0;
+    for (int i = BENCH_NBREPEAT; i--;) {
+      size_t len = 0;
+      double start = BenchGetTime();
+      char* buf = JSONSaveToBuffer(json, NULL, &len, compact);
+      delay += BenchGetTime() - start;
+      start = BenchGetTime();
+      size_t lenSize = JSONGetSaveSize(json, compact);
+      delaySize += BenchGetTime() - start;
+      if (len != (size_t)size || lenSize != (size_t)size) {
+        JSONErr->_type = PBErrTypeUnitTestFailed;
+        sprintf(JSONErr->_msg, "JSONSaveToBuffer failed");
+        PBErrCatch(JSONErr);
+      }
+      free(buf);
+    }
+    printf("  JSONSaveToBuffer:           %8.2f MB/s\n", 
+      (double)size * BENCH_NBREPEAT / delay / 1e6);
+    printf("  JSONGetSaveSize:            %8.2f MB/s\n", 
+      (double)size * BENCH_NBREPEAT / delaySize / 1e6);
+  }
+  JSONFree(&json);
+  printf("BenchSave OK\n");
+}
+
+// Measure the speed of saving a response made of a small changing 
+// property and the unchanged benchmark JSON, with and without the cache
+// of its serialization
+void BenchCache() {
+  JSONNode* json = JSONCreate();
+  JSONNode* body = BenchCreateJSON();
+  JSONAddProp(json, "body", body);
+  char val[20];
+  for (int iCache = 0; iCache < 3; ++iCache) {
+    if (iCache == 1)
+      JSONCacheEnable(body, false);
+    else if (iCache == 2)
+      JSONCacheEnable(body, true);
+    // Fill the cache before measuring
+    free(JSONSaveToBuffer(json, NULL, NULL, true));
+    double delay = 0.0;
+    double delaySize = 0.0;
+    for (int i = 0; i < BENCH_NBREPEAT; ++i) {
+      sprintf(val, "%d", i);
+      JSONAddProp(json, "id", val);
+      double start = BenchGetTime();
+      size_t size = JSONGetSaveSize(json, true);
+      delaySize += BenchGetTime() - start;
+      start = BenchGetTime();
+      char* buf = JSONSaveToBuffer(json, NULL, NULL, true);
+      delay += BenchGetTime() - start;
+      if (strlen(buf) != size) {
+        JSONErr->_type = PBErrTypeUnitTestFailed;
+        sprintf(JSONErr->_msg, "JSONCache failed");
+        PBErrCatch(JSONErr);
+      }
+      free(buf);
+    }
+    printf("  %-14s JSONGetSaveSize %10.3f ms, JSONSaveToBuffer %8.3f ms\n",
+      (iCache == 0 ? "no cache:" : 
+        (iCache == 1 ? "cached length:" : "cached bytes:")),
+      delaySize / BENCH_NBREPEAT * 1e3, delay / BENCH_NBREPEAT * 1e3);
+  }
+  JSONFree(&json);
+  printf("BenchCache OK\n");
+}
+
+// Measure the speed of encoding and decoding integers as strings 
+// converted with sprintf and atoi, and as typed values
+void BenchTyped() {
+  int nb = 1000000;
+  char val[100];
+  for (int iTyped = 0; iTyped < 2; ++iTyped) {
+    JSONArena* arena = JSONArenaCreate();
+    JSONNode* json = JSONCreateInArena(arena);
+    double start = BenchGetTime();
+    for (int i = 0; i < nb; ++i) {
+      if (iTyped == 0) {
+        sprintf(val, "%d", i);
+        JSONAddProp(json, "v", val);
+      } else {
+        JSONAddProp(json, "v", i);
+      }
+    }
+    double delayEncode = BenchGetTime() - start;
+    long sum = 0;
+    start = BenchGetTime();
+    JSONNode* const* props = JSONGetValues(json);
+    for (int i = 0; i < nb; ++i) {
+      if (iTyped == 0)
+        sum += atoi(JSONLblVal(props[i]));
+      else
+        sum += JSONIntVal(props[i]);
+    }
+    double delayDecode = BenchGetTime() - start;
+    if (sum != (long)nb * (long)(nb - 1) / 2) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONGetInt failed");
+      PBErrCatch(JSONErr);
+    }
+    printf("  %s encode %6.1f ns/value, decode %6.1f ns/value\n", 
+      (iTyped == 0 ? "sprintf/atoi:" : "typed:       "),
+      delayEncode / nb * 1e9, delayDecode / nb * 1e9);
+    JSONArenaFree(&arena);
+  }
+  printf("BenchTyped OK\n");
+}
+
+void BenchNumber() {
+  int nb = 1000000;
+  // Values to convert, integers of various lengths and doubles with 
+  // short or long representations
+  int64_t* ints = PBErrMalloc(JSONErr, sizeof(int64_t) * nb);
+  double* reals = PBErrMalloc(JSONErr, sizeof(double) * nb);
+  char* strs = PBErrMalloc(JSONErr, PBJSON_SCALARSIZE * nb);
+  for (int i = 0; i < nb; ++i) {
+    ints[i] = (int64_t)i * i * (i % 2 == 0 ? 1 : -1);
+    reals[i] = (i % 2 == 0 ? (double)i / 8.0 : (double)i / 3.0);
+  }
+  int64_t sumInt = 0;
+  double sumReal = 0.0;
+  for (int iLibc = 0; iLibc < 2; ++iLibc) {
+    // Format the integers
+    double start = BenchGetTime();
+    for (int i = 0; i < nb; ++i) {
+      if (iLibc == 0)
+        (void)JSONFormatInt(ints[i], strs + i * PBJSON_SCALARSIZE);
+      else
+        sprintf(strs + i * PBJSON_SCALARSIZE, "%" PRId64, ints[i]);
+    }
+    double delayFormatInt = BenchGetTime() - start;
+    // Parse the integers
+    int64_t sum = 0;
+    start = BenchGetTime();
+    for (int i = 0; i < nb; ++i) {
+      char* str = strs + i * PBJSON_SCALARSIZE;
+      if (iLibc == 0) {
+        JSONType type = JSONTypeStr;
+        JSONPayload val = {._int = 0};
+        (void)JSONScanNumber(str, strlen(str), &type, &val);
+        sum += val._int;
+      } else {
+        sum += strtoll(str, NULL, 10);
+      }
+    }
+    double delayScanInt = BenchGetTime() - start;
+    // Format the doubles
+    start = BenchGetTime();
+    for (int i = 0; i < nb; ++i) {
+      if (iLibc == 0)
+        (void)JSONFormatReal(reals[i], strs + i * PBJSON_SCALARSIZE);
+      else
+        sprintf(strs + i * PBJSON_SCALARSIZE, "%.17g", reals[i]);
+    }
+    double delayFormatReal = BenchGetTime() - start;
+    // Parse the doubles
+    double sumR = 0.0;
+    start = BenchGetTime();
+    for (int i = 0; i < nb; ++i) {
+      char* str = strs + i * PBJSON_SCALARSIZE;
+      if (iLibc == 0) {
+        JSONType type = JSONTypeStr;
+        JSONPayload val = {._int = 0};
+        (void)JSONScanNumber(str, strlen(str), &type, &val);
+        sumR += val._real;
+      } else {
+        sumR += strtod(str, NULL);
+      }
+    }
+    double delayScanReal = BenchGetTime() - start;
+    // Both implementations must give the same values
+    if (iLibc == 0) {
+      sumInt = sum;
+      sumReal = sumR;
+    } else if (sum != sumInt || sumR != sumReal) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONScanNumber failed");
+      PBErrCatch(JSONErr);
+    }
+    printf("  %s int format %5.1f ns, parse %5.1f ns, "
+      "real format %5.1f ns, parse %5.1f ns\n", 
+      (iLibc == 0 ? "pbjson:" : "libc:  "), 
+      delayFormatInt / nb * 1e9, delayScanInt / nb * 1e9,
+      delayFormatReal / nb * 1e9, delayScanReal / nb * 1e9);
+  }
+  free(ints);
+  free(reals);
+  free(strs);
+  printf("BenchNumber OK\n");
+}
+
+void BenchAll() {
+  BenchLoad();
+  BenchScan();
+  BenchEscape();
+  BenchLazy();
+  BenchPath();
+  BenchBinary();
+  BenchStructCodec();
+  BenchWriter();
+  BenchArrMove();
+  BenchStats();
+  BenchSave();
+  BenchCache();
+  BenchRecords();
+  BenchRecordsParallel();
+  BenchProperty();
+  BenchValue();
+  BenchTyped();
+  BenchNumber();
+  printf("BenchAll OK\n");
+}
+
+int main() {
+  BenchAll();
+  // Return success code
+  return 0;
+}
+
@@ -5,6 +5,8 @@
 #include <time.h>
 #include <unistd.h>
 #include <sys/time.h>
+#include <locale.h>
+#include <limits.h>
 #include "pberr.h"
 #include "pbjson.h"
 
@@ -75,13 +77,14 @@ JSONNode* StructBEncodeAsJSON(struct structB* that) {
   // Create the JSON structure
   JSONNode* json = JSONCreate();
   // Declare a buffer to convert value into string
-  char val[100];
+  char val[PBJSON_SCALARSIZE];
   // Convert the value into string
-  sprintf(val, "%d", that->_intVal);
+  (void)JSONFormatInt(that->_intVal, val);
   // Add a key/value to the JSON
   JSONAddProp(json, "_intVal", val);
-  // Convert the value into string
-  sprintf(val, "%f", that->_floatVal);
+  // Convert the value into its shortest string giving back the same 
+  // value
+  (void)JSONFormatReal(that->_floatVal, val);
   // Add a key/value to the JSON
   JSONAddProp(json, "_floatVal", val);
   // Return the JSON
@@ -104,7 +107,7 @@ JSONNode* StructAEncodeAsJSON(struct structA* that) {
   JSONAddProp(json, "_intVal", val);
 
   // Add a property with a value containing a double quote to the JSON
-  sprintf(val, "\\\"double quoted\\\"");
+  sprintf(val, "\"double quoted\"");
   JSONAddProp(json, "_escapeVal", val);
 
   // Declare an array of values converted to string
@@ -176,8 +179,7 @@ bool StructBDecodeAsJSON(struct structB* that, JSONNode* json) {
     PBErrCatch(JSONErr);
   }
   // Set the value of _intVal
-  JSONNode* val = JSONValue(prop, 0);
-  that->_intVal = atoi(JSONLabel(val));
+  that->_intVal = (int)JSONIntVal(prop);
   // Get the property _floatVal from the JSON
   prop = JSONProperty(json, "_floatVal");
   if (prop == NULL) {
@@ -186,8 +188,7 @@ bool StructBDecodeAsJSON(struct structB* that, JSONNode* json) {
     PBErrCatch(JSONErr);
   }
   // Set the value of _floatVal
-  val = JSONValue(prop, 0);
-  that->_floatVal = atof(JSONLabel(val));
+  that->_floatVal = (float)JSONRealVal(prop);
   // Return the success code
   return true;
 }
@@ -363,10 +364,2301 @@ void UnitTestJSONLoadSave() {
   printf("UnitTestJSONLoadSave OK\n");
 }
 
+void UnitTestJSONLoadFromBuffer() {
+  // Buffer not null terminated, followed by bytes which must be ignored
+  char buf[14] = {'{','"','v','"',':','"','1','"','}','{','"','w','"'};
+  buf[13] = '}';
+  JSONNode* json = JSONCreate();
+  if (JSONLoadFromBuffer(json, buf, 9) == false) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONLoadFromBuffer failed");
+    PBErrCatch(JSONErr);
+  }
+  JSONNode* prop = JSONProperty(json, "v");
+  if (JSONGetNbValue(json) != 1 || prop == NULL || 
+    strcmp(JSONLblVal(prop), "1") != 0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONLoadFromBuffer failed");
+    PBErrCatch(JSONErr);
+  }
+  JSONFree(&json);
+  // Truncated buffer must fail
+  json = JSONCreate();
+  if (JSONLoadFromBuffer(json, buf, 7) == true) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONLoadFromBuffer failed");
+    PBErrCatch(JSONErr);
+  }
+  JSONFree(&json);
+  printf("UnitTestJSONLoadFromBuffer OK\n");
+}
+
+void UnitTestJSONArena() {
+  JSONArena* arena = JSONArenaCreate();
+  if (arena == NULL) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONArenaCreate failed");
+    PBErrCatch(JSONErr);
+  }
+  char* str = 
+    "{\"a\":\"1\",\"b\":[\"2\",\"3\"],\"c\":[{\"d\":\"4\"}]}\n";
+  for (int iRun = 0; iRun < 2; ++iRun) {
+    JSONNode* json = JSONCreateInArena(arena);
+    if (JSONLoadFromStr(json, str) == false) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONLoadFromStr failed");
+      PBErrCatch(JSONErr);
+    }
+    char strSave[100] = {0};
+    if (JSONSaveToStr(json, strSave, 100, true) == false ||
+      strcmp(str, strSave) != 0) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONArena failed");
+      PBErrCatch(JSONErr);
+    }
+    // Nodes created by JSONAddProp are in the arena, nodes created 
+    // by the user on the heap can be attached too
+    JSONAddProp(json, "f", "5");
+    JSONNode* prop = JSONCreate();
+    JSONAddProp(prop, "g", "6");
+    JSONAddProp(json, "h", prop);
+    if (JSONProperty(json, "f") == NULL || 
+      strcmp(JSONLblVal(JSONProperty(json, "f")), "5") != 0 ||
+      JSONProperty(json, "h") != prop) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONArena failed");
+      PBErrCatch(JSONErr);
+    }
+    // Release the tree either through JSONFree or the reset of the 
+    // arena
+    if (iRun == 0)
+      JSONFree(&json);
+    JSONArenaReset(arena);
+  }
+  // Freeing a property in an arena removes it from its parent
+  JSONNode* json = JSONCreateInArena(arena);
+  (void)JSONLoadFromStr(json, "{\"x\":\"1\",\"y\":\"2\"}");
+  JSONNode* propY = JSONProperty(json, "y");
+  JSONFree(&propY);
+  char* strFree = JSONSaveToBuffer(json, NULL, NULL, true);
+  if (JSONGetNbValue(json) != 1 || 
+    strcmp(strFree, "{\"x\":\"1\"}\n") != 0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONFree failed");
+    PBErrCatch(JSONErr);
+  }
+  free(strFree);
+  JSONArenaFree(&arena);
+  if (arena != NULL) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONArenaFree failed");
+    PBErrCatch(JSONErr);
+  }
+  printf("UnitTestJSONArena OK\n");
+}
+
+void UnitTestJSONLongLabel() {
+  // Create a key and a value longer than the blocks read by the loader
+  int len = 3 * PBJSON_BLOCKSIZE + 7;
+  char* key = PBErrMalloc(JSONErr, len + 1);
+  char* val = PBErrMalloc(JSONErr, len + 1);
+  for (int i = 0; i < len; ++i) {
+    key[i] = 'a' + i % 26;
+    val[i] = 'A' + i % 26;
+  }
+  key[len] = '\0';
+  val[len] = '\0';
+  JSONNode* json = JSONCreate();
+  JSONAddProp(json, key, val);
+  JSONArrayVal set = JSONArrayValCreateStatic();
+  JSONArrayValAdd(&set, val);
+  JSONArrayValAdd(&set, key);
+  JSONAddProp(json, "arr", &set);
+  JSONArrayValFlush(&set);
+  JSONArrayStruct setStruct = JSONArrayStructCreateStatic();
+  JSONNode* elem = JSONCreate();
+  JSONAddProp(elem, "v", val);
+  JSONArrayStructAdd(&setStruct, elem);
+  JSONAddProp(json, key, &setStruct);
+  JSONArrayStructFlush(&setStruct);
+  // Save and reload through a stream and through a string
+  FILE* fd = tmpfile();
+  if (!JSONSave(json, fd, false)) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONSave failed");
+    PBErrCatch(JSONErr);
+  }
+  long size = ftell(fd);
+  rewind(fd);
+  char* str = PBErrMalloc(JSONErr, size + 1);
+  if (fread(str, 1, size, fd) != (size_t)size) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "fread failed");
+    PBErrCatch(JSONErr);
+  }
+  str[size] = '\0';
+  for (int iLoad = 0; iLoad < 2; ++iLoad) {
+    JSONNode* jsonLoad = JSONCreate();
+    rewind(fd);
+    bool ret = (iLoad == 0 ? JSONLoad(jsonLoad, fd) : 
+      JSONLoadFromStr(jsonLoad, str));
+    if (!ret) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONLoad failed");
+      PBErrCatch(JSONErr);
+    }
+    JSONNode* prop = JSONProperty(jsonLoad, key);
+    JSONNode* arr = JSONProperty(jsonLoad, "arr");
+    if (prop == NULL || strcmp(JSONLblVal(prop), val) != 0 ||
+      arr == NULL || JSONGetNbValue(arr) != 2 ||
+      strcmp(JSONLabel(JSONValue(arr, 0)), val) != 0 ||
+      strcmp(JSONLabel(JSONValue(arr, 1)), key) != 0 ||
+      strcmp(JSONLabel(JSONValue(jsonLoad, 2)) + 2, key) != 0 ||
+      strcmp(JSONLblVal(JSONProperty(JSONValue(
+        JSONValue(jsonLoad, 2), 0), "v")), val) != 0) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONLoad failed");
+      PBErrCatch(JSONErr);
+    }
+    JSONFree(&jsonLoad);
+  }
+  fclose(fd);
+  free(str);
+  free(key);
+  free(val);
+  JSONFree(&json);
+  printf("UnitTestJSONLongLabel OK\n");
+}
+
+void UnitTestJSONPropertyIndex() {
+  JSONNode* json = JSONCreate();
+  char key[20];
+  char val[20];
+  int nb = 3 * PBJSON_INDEXMIN;
+  for (int i = 0; i < nb; ++i) {
+    sprintf(key, "key%d", i);
+    sprintf(val, "%d", i);
+    JSONAddProp(json, key, val);
+  }
+  // Add a duplicate key, JSONProperty must return the first one
+  JSONAddProp(json, "key0", "dup");
+  // Add an array of objects, whose label is prefixed with '[]'
+  JSONArrayStruct setStruct = JSONArrayStructCreateStatic();
+  JSONArrayStructAdd(&setStruct, JSONCreate());
+  JSONAddProp(json, "arrObj", &setStruct);
+  JSONArrayStructFlush(&setStruct);
+  for (int i = 0; i < nb; ++i) {
+    sprintf(key, "key%d", i);
+    sprintf(val, "%d", i);
+    JSONNode* prop = JSONProperty(json, key);
+    if (prop == NULL || strcmp(JSONLblVal(prop), val) != 0) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONProperty failed");
+      PBErrCatch(JSONErr);
+    }
+  }
+  if (JSONProperty(json, "arrObj") != JSONValue(json, nb + 1) ||
+    JSONProperty(json, "unknown") != NULL) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONProperty failed");
+    PBErrCatch(JSONErr);
+  }
+  // The index must follow the added and relabelled properties
+  JSONAddProp(json, "added", "1");
+  JSONSetLabel(JSONValue(json, 0), "renamed");
+  if (JSONProperty(json, "added") == NULL ||
+    JSONProperty(json, "renamed") != JSONValue(json, 0) ||
+    strcmp(JSONLblVal(JSONProperty(json, "key0")), "dup") != 0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONProperty failed");
+    PBErrCatch(JSONErr);
+  }
+  // Relabelling a value leaves the index of the object valid, only 
+  // relabelling a key invalidates it
+  JSONIndex* index = ((JSONLbl*)GenTreeData(json))->_index;
+  JSONSetLabel(JSONValue(JSONProperty(json, "key1"), 0), "one");
+  if (index->_flagStale || 
+    strcmp(JSONLblVal(JSONProperty(json, "key1")), "one") != 0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONProperty failed");
+    PBErrCatch(JSONErr);
+  }
+  JSONSetLabel(JSONProperty(json, "key2"), "two");
+  if (!(index->_flagStale) || JSONProperty(json, "key2") != NULL ||
+    strcmp(JSONLblVal(JSONProperty(json, "two")), "2") != 0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONProperty failed");
+    PBErrCatch(JSONErr);
+  }
+  // The index must follow a removed property replaced by an added one
+  JSONNode* prop = JSONProperty(json, "key3");
+  JSONFree(&prop);
+  JSONAddProp(json, "new", "x");
+  if (JSONProperty(json, "key3") != NULL ||
+    strcmp(JSONLblVal(JSONProperty(json, "new")), "x") != 0 ||
+    strcmp(JSONLblVal(JSONProperty(json, "key4")), "4") != 0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONProperty failed");
+    PBErrCatch(JSONErr);
+  }
+  JSONFree(&json);
+  printf("UnitTestJSONPropertyIndex OK\n");
+}
+
+void UnitTestJSONValueIndex() {
+  JSONNode* json = JSONCreate();
+  char val[20];
+  int nb = 100;
+  JSONArrayVal setVal = JSONArrayValCreateStatic();
+  for (int i = 0; i < nb; ++i) {
+    sprintf(val, "%d", i);
+    JSONArrayValAdd(&setVal, val);
+  }
+  JSONAddProp(json, "arr", &setVal);
+  JSONArrayValFlush(&setVal);
+  JSONNode* arr = JSONProperty(json, "arr");
+  // Access the values in reverse order to avoid any sequential access
+  for (int i = nb; i--;) {
+    sprintf(val, "%d", i);
+    if (strcmp(JSONLabel(JSONValue(arr, i)), val) != 0) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONValue failed");
+      PBErrCatch(JSONErr);
+    }
+  }
+  // The values must follow the appended values
+  for (int i = nb; i < 2 * nb; ++i) {
+    sprintf(val, "%d", i);
+    JSONNode* node = JSONCreate();
+    JSONSetLabel(node, val);
+    JSONAppendVal(arr, node);
+  }
+  JSONNode* const* vals = JSONGetValues(arr);
+  for (int i = 0; i < JSONGetNbValue(arr); ++i) {
+    sprintf(val, "%d", i);
+    if (strcmp(JSONLabel(vals[i]), val) != 0 || 
+      JSONValue(arr, i) != vals[i]) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONGetValues failed");
+      PBErrCatch(JSONErr);
+    }
+  }
+  // The values must follow a removed value replaced by an appended one
+  JSONNode* node = JSONValue(arr, 5);
+  JSONFree(&node);
+  node = JSONCreate();
+  JSONSetLabel(node, "last");
+  JSONAppendVal(arr, node);
+  vals = JSONGetValues(arr);
+  if (JSONGetNbValue(arr) != 2 * nb || 
+    strcmp(JSONLabel(JSONValue(arr, 5)), "6") != 0 ||
+    strcmp(JSONLabel(vals[5]), "6") != 0 ||
+    JSONValue(arr, 2 * nb - 1) != node || vals[2 * nb - 1] != node) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONValue failed");
+    PBErrCatch(JSONErr);
+  }
+  JSONFree(&json);
+  printf("UnitTestJSONValueIndex OK\n");
+}
+
+// Trace of the events received by the event handler of the unit test
+char UnitTestJSONParseTrace[200];
+
+bool UnitTestJSONParseObjStart(void* const data) {
+  (void)data;
+  strcat(UnitTestJSONParseTrace, "{");
+  return true;
+}
+
+bool UnitTestJSONParseObjEnd(void* const data) {
+  (void)data;
+  strcat(UnitTestJSONParseTrace, "}");
+  return true;
+}
+
+bool UnitTestJSONParseArrStart(void* const data) {
+  (void)data;
+  strcat(UnitTestJSONParseTrace, "[");
+  return true;
+}
+
+bool UnitTestJSONParseArrEnd(void* const data) {
+  (void)data;
+  strcat(UnitTestJSONParseTrace, "]");
+  return true;
+}
+
+bool UnitTestJSONParseKey(void* const data, const char* const str, 
+  const size_t len) {
+  strcat(UnitTestJSONParseTrace, "k");
+  strncat(UnitTestJSONParseTrace, str, len);
+  // Stop on the key given in the user data, if any
+  return (data == NULL || strncmp(str, (char*)data, len) != 0);
+}
+
+bool UnitTestJSONParseVal(void* const data, const char* const str, 
+  const size_t len) {
+  (void)data;
+  strcat(UnitTestJSONParseTrace, "v");
+  strncat(UnitTestJSONParseTrace, str, len);
+  return true;
+}
+
+bool UnitTestJSONParseScalar(void* const data, const JSONType type, 
+  const JSONPayload val) {
+  (void)data;
+  char str[50];
+  switch (type) {
+    case JSONTypeInt:
+      sprintf(str, "i%lld", (long long)(val._int));
+      break;
+    case JSONTypeReal:
+      sprintf(str, "r%g", val._real);
+      break;
+    case JSONTypeBool:
+      sprintf(str, "b%d", (val._bool ? 1 : 0));
+      break;
+    default:
+      sprintf(str, "n");
+      break;
+  }
+  strcat(UnitTestJSONParseTrace, str);
+  return true;
+}
+
+void UnitTestJSONParse() {
+  JSONEventHandler handler = {
+    ._objStart = UnitTestJSONParseObjStart,
+    ._objEnd = UnitTestJSONParseObjEnd,
+    ._arrStart = UnitTestJSONParseArrStart,
+    ._arrEnd = UnitTestJSONParseArrEnd,
+    ._key = UnitTestJSONParseKey,
+    ._val = UnitTestJSONParseVal,
+    ._data = NULL};
+  char* str = "{\"a\":\"1\",\"b\":[\"2\",\"3\"],\"c\":{\"d\":\"4\"},"
+    "\"e\":[{\"f\":\"5\"},{\"g\":\"6\"}],\"h\":[]}";
+  UnitTestJSONParseTrace[0] = '\0';
+  if (JSONParseFromStr(&handler, str) == false ||
+    strcmp(UnitTestJSONParseTrace, 
+      "{kav1kb[v2v3]kc{kdv4}ke[{kfv5}{kgv6}]kh[]}") != 0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONParseFromStr failed (%s)", 
+      UnitTestJSONParseTrace);
+    PBErrCatch(JSONErr);
+  }
+  // The handler can stop the parsing
+  handler._data = "c";
+  UnitTestJSONParseTrace[0] = '\0';
+  if (JSONParseFromStr(&handler, str) == true ||
+    strcmp(UnitTestJSONParseTrace, "{kav1kb[v2v3]kc") != 0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONParseFromStr failed (%s)", 
+      UnitTestJSONParseTrace);
+    PBErrCatch(JSONErr);
+  }
+  // NULL callbacks are ignored, and invalid JSON fails
+  JSONEventHandler handlerEmpty = {0};
+  if (JSONParseFromStr(&handlerEmpty, str) == false ||
+    JSONParseFromStr(&handlerEmpty, "{\"a\":\"1\",\"b\":[\"2\",{}]}") 
+      == true) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONParseFromStr failed");
+    PBErrCatch(JSONErr);
+  }
+  // Numbers, booleans and null are given with their type, or as their 
+  // chars in the JSON if there is no callback for typed values
+  str = "{\"a\":1,\"b\":[-2.5,\"3\",true,null],\"c\":false,"
+    "\"d\":[{\"e\":1e3}]}";
+  handler._data = NULL;
+  handler._scalar = UnitTestJSONParseScalar;
+  UnitTestJSONParseTrace[0] = '\0';
+  if (JSONParseFromStr(&handler, str) == false ||
+    strcmp(UnitTestJSONParseTrace, 
+      "{kai1kb[r-2.5v3b1n]kcb0kd[{ker1000}]}") != 0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONParseFromStr failed (%s)", 
+      UnitTestJSONParseTrace);
+    PBErrCatch(JSONErr);
+  }
+  handler._scalar = NULL;
+  UnitTestJSONParseTrace[0] = '\0';
+  if (JSONParseFromStr(&handler, str) == false ||
+    strcmp(UnitTestJSONParseTrace, 
+      "{kav1kb[v-2.5v3vtruevnull]kcvfalsekd[{kev1e3}]}") != 0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONParseFromStr failed (%s)", 
+      UnitTestJSONParseTrace);
+    PBErrCatch(JSONErr);
+  }
+  // Invalid values fail, even without callback
+  if (JSONParseFromStr(&handlerEmpty, "{\"a\":tru}") == true ||
+    JSONParseFromStr(&handlerEmpty, "{\"a\":[1,{}]}") == true ||
+    JSONParseFromStr(&handlerEmpty, "{\"a\":[{},1]}") == true) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONParseFromStr failed");
+    PBErrCatch(JSONErr);
+  }
+  printf("UnitTestJSONParse OK\n");
+}
+
+void UnitTestJSONFeed() {
+  // Read the content of the readable unit test file followed by the 
+  // beginning of another JSON
+  char buf[1000];
+  FILE* fd = fopen("./testJsonReadable.txt", "r");
+  size_t len = fread(buf, sizeof(char), 900, fd);
+  fclose(fd);
+  memcpy(buf + len, "{\"a\"", 4);
+  // Get the reference by loading the file in one call
+  JSONNode* jsonRef = JSONCreate();
+  if (JSONLoadFromBuffer(jsonRef, buf, len) == false) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONLoadFromBuffer failed");
+    PBErrCatch(JSONErr);
+  }
+  char strRef[1000];
+  char strFeed[1000];
+  (void)JSONSaveToStr(jsonRef, strRef, 1000, true);
+  JSONFree(&jsonRef);
+  // Feed the bytes by chunks of various sizes
+  size_t chunks[3] = {1, 7, len + 4};
+  for (int iChunk = 0; iChunk < 3; ++iChunk) {
+    JSONNode* json = JSONCreate();
+    JSONFeeder* feeder = JSONFeederCreate(json);
+    JSONFeedRet ret = JSONFeedNeedMore;
+    size_t pos = 0;
+    size_t nbUsed = 0;
+    while (ret == JSONFeedNeedMore && pos < len + 4) {
+      size_t lenChunk = chunks[iChunk];
+      if (pos + lenChunk > len + 4)
+        lenChunk = len + 4 - pos;
+      ret = JSONFeed(feeder, buf + pos, lenChunk, &nbUsed);
+      pos += nbUsed;
+    }
+    // The JSON must be complete and the next one not consumed
+    (void)JSONSaveToStr(json, strFeed, 1000, true);
+    if (ret != JSONFeedComplete || pos != len - 1 || 
+      strcmp(strRef, strFeed) != 0) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONFeed failed");
+      PBErrCatch(JSONErr);
+    }
+    JSONFree(&json);
+    // The next JSON needs more bytes
+    json = JSONCreate();
+    JSONFeederReset(feeder, json);
+    if (JSONFeed(feeder, buf + pos, len + 4 - pos, NULL) != 
+      JSONFeedNeedMore) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONFeed failed");
+      PBErrCatch(JSONErr);
+    }
+    JSONFree(&json);
+    JSONFeederFree(&feeder);
+  }
+  // Invalid bytes must fail
+  JSONNode* json = JSONCreate();
+  JSONFeeder* feeder = JSONFeederCreate(json);
+  if (JSONFeed(feeder, "{\"a\":\"1\"", 8, NULL) != JSONFeedNeedMore ||
+    JSONFeed(feeder, "]", 1, NULL) != JSONFeedError || 
+    JSONFeed(feeder, "}", 1, NULL) != JSONFeedError) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONFeed failed");
+    PBErrCatch(JSONErr);
+  }
+  JSONFeederFree(&feeder);
+  JSONFree(&json);
+  // Numbers, booleans and null are loaded with their type, even when 
+  // they are split between chunks
+  char* strTyped = "{\"a\":-12,\"b\":[2.5,\"x\",true,null],"
+    "\"c\":false,\"d\":[{\"e\":123456}]}";
+  size_t lenTyped = strlen(strTyped);
+  jsonRef = JSONCreate();
+  (void)JSONLoadFromStr(jsonRef, strTyped);
+  (void)JSONSaveToStr(jsonRef, strRef, 1000, true);
+  JSONFree(&jsonRef);
+  for (size_t lenChunk = 1; lenChunk <= lenTyped; ++lenChunk) {
+    json = JSONCreate();
+    feeder = JSONFeederCreate(json);
+    JSONFeedRet ret = JSONFeedNeedMore;
+    for (size_t pos = 0; ret == JSONFeedNeedMore && pos < lenTyped; 
+      pos += lenChunk) {
+      size_t lenFeed = 
+        (pos + lenChunk > lenTyped ? lenTyped - pos : lenChunk);
+      ret = JSONFeed(feeder, strTyped + pos, lenFeed, NULL);
+    }
+    (void)JSONSaveToStr(json, strFeed, 1000, true);
+    if (ret != JSONFeedComplete || strcmp(strRef, strFeed) != 0 ||
+      JSONGetType(JSONValue(JSONProperty(json, "a"), 0)) != 
+        JSONTypeInt ||
+      JSONIntVal(JSONProperty(json, "a")) != -12) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONFeed failed (%zu)", lenChunk);
+      PBErrCatch(JSONErr);
+    }
+    JSONFeederFree(&feeder);
+    JSONFree(&json);
+  }
+  // Invalid values fail
+  json = JSONCreate();
+  feeder = JSONFeederCreate(json);
+  if (JSONFeed(feeder, "{\"a\":tr", 7, NULL) != JSONFeedNeedMore ||
+    JSONFeed(feeder, "u}", 2, NULL) != JSONFeedError) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONFeed failed");
+    PBErrCatch(JSONErr);
+  }
+  JSONFeederFree(&feeder);
+  JSONFree(&json);
+  printf("UnitTestJSONFeed OK\n");
+}
+
+void UnitTestJSONRecords() {
+  // Records of various shapes, with empty lines
+  char* lines[7] = {
+    "{\"a\":\"1\",\"b\":[\"2\",\"3\"],\"c\":{\"d\":\"4\"}}",
+    "",
+    "{\"a\":\"10\",\"b\":[\"20\"],\"c\":{\"d\":\"40\",\"e\":\"5\"}}",
+    "{\"x\":[{\"y\":\"1\"},{\"y\":\"2\"}],\"a\":[]}",
+    "{\"x\":[{\"y\":\"a long value to overwrite the previous one\"}]}",
+    "{\"a\":\"1\",\"b\":[\"2\",\"3\"],\"c\":{\"d\":\"4\"}}",
+    "[{\"z\":\"1\"}]"};
+  char buf[500] = {'\0'};
+  for (int iLine = 0; iLine < 7; ++iLine) {
+    strcat(buf, lines[iLine]);
+    strcat(buf, "\n");
+  }
+  JSONRecords* records = JSONRecordsCreateFromBuffer(buf, strlen(buf));
+  char strRef[200];
+  char strRecord[200];
+  for (int iLine = 0; iLine < 7; ++iLine) {
+    if (lines[iLine][0] == '\0')
+      continue;
+    // Each record must be the same as if loaded in a new JSON
+    JSONNode* record = JSONRecordsNext(records);
+    JSONNode* json = JSONCreate();
+    (void)JSONLoadFromStr(json, lines[iLine]);
+    (void)JSONSaveToStr(json, strRef, 200, true);
+    JSONFree(&json);
+    if (record == NULL ||
+      JSONSaveToStr(record, strRecord, 200, true) == false ||
+      strcmp(strRef, strRecord) != 0) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONRecordsNext failed (%d)", iLine);
+      PBErrCatch(JSONErr);
+    }
+  }
+  if (JSONRecordsNext(records) != NULL || 
+    JSONRecordsIsError(records) == true ||
+    JSONRecordsGetNb(records) != 6) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONRecordsNext failed");
+    PBErrCatch(JSONErr);
+  }
+  JSONRecordsFree(&records);
+  // Empty labels replacing a typed value or an object reuse nodes 
+  // without storage for the label, they must not be written in place
+  char* bufEmpty[2] = {
+    "{\"a\":1,\"b\":\"x\"}\n{\"a\":\"\",\"b\":\"x\"}\n",
+    "{\"a\":[{\"x\":\"1\"}],\"b\":\"x\"}\n{\"a\":[\"\"],\"b\":\"x\"}\n"};
+  for (int iBuf = 0; iBuf < 2; ++iBuf) {
+    records = 
+      JSONRecordsCreateFromBuffer(bufEmpty[iBuf], strlen(bufEmpty[iBuf]));
+    JSONNode* record = NULL;
+    while ((record = JSONRecordsNext(records)) != NULL) {
+      JSONNode* propB = JSONProperty(record, "b");
+      if (propB == NULL || 
+        GenTreeParent(propB) != (GenTree*)record || 
+        GenTreeParent(JSONValue(propB, 0)) != (GenTree*)propB ||
+        strcmp(JSONLblVal(propB), "x") != 0) {
+        JSONErr->_type = PBErrTypeUnitTestFailed;
+        sprintf(JSONErr->_msg, "JSONRecordsNext failed");
+        PBErrCatch(JSONErr);
+      }
+    }
+    if (JSONRecordsIsError(records) || JSONRecordsGetNb(records) != 2) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONRecordsNext failed");
+      PBErrCatch(JSONErr);
+    }
+    JSONRecordsFree(&records);
+  }
+  // An invalid record stops the reading
+  char* bufInvalid = "{\"a\":\"1\"}\n{\"a\"}\n{\"a\":\"1\"}\n";
+  records = JSONRecordsCreateFromBuffer(bufInvalid, strlen(bufInvalid));
+  if (JSONRecordsNext(records) == NULL ||
+    JSONRecordsNext(records) != NULL ||
+    JSONRecordsIsError(records) == false ||
+    JSONRecordsNext(records) != NULL) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONRecordsNext failed");
+    PBErrCatch(JSONErr);
+  }
+  JSONRecordsFree(&records);
+  printf("UnitTestJSONRecords OK\n");
+}
+
+// Callback of UnitTestJSONParallel, summing the values of the records
+// per thread
+bool UnitTestJSONParallelSum(JSONNode* const record, const int iThread, 
+  void* const data) {
+  ((long*)data)[iThread] += atol(JSONLblVal(JSONProperty(record, "v")));
+  return true;
+}
+
+void UnitTestJSONParallel() {
+  // Load a batch of buffers, one of them is invalid
+  char bufs[10][20];
+  const char* ptrBufs[10];
+  size_t lens[10];
+  JSONNode* jsons[10];
+  PBErr errs[10];
+  for (int iBuf = 0; iBuf < 10; ++iBuf) {
+    sprintf(bufs[iBuf], "{\"v\":\"%d\"}", iBuf);
+    ptrBufs[iBuf] = bufs[iBuf];
+    lens[iBuf] = strlen(bufs[iBuf]);
+    jsons[iBuf] = JSONCreate();
+  }
+  if (JSONLoadBuffersParallel(jsons, ptrBufs, lens, 10, 4, errs) == false) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONLoadBuffersParallel failed");
+    PBErrCatch(JSONErr);
+  }
+  for (int iBuf = 0; iBuf < 10; ++iBuf) {
+    if (atoi(JSONLblVal(JSONProperty(jsons[iBuf], "v"))) != iBuf) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONLoadBuffersParallel failed");
+      PBErrCatch(JSONErr);
+    }
+    JSONFree(jsons + iBuf);
+    jsons[iBuf] = JSONCreate();
+  }
+  bufs[7][4] = ';';
+  if (JSONLoadBuffersParallel(jsons, ptrBufs, lens, 10, 4, errs) == true ||
+    errs[7]._type != PBErrTypeInvalidData || 
+    strcmp(errs[7]._msg, JSONErr->_msg) != 0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONLoadBuffersParallel failed");
+    PBErrCatch(JSONErr);
+  }
+  for (int iBuf = 0; iBuf < 10; ++iBuf)
+    JSONFree(jsons + iBuf);
+  // Read records in parallel
+  int nbRecord = 1000;
+  char* buf = PBErrMalloc(JSONErr, sizeof(char) * 20 * nbRecord);
+  size_t len = 0;
+  for (int iRecord = 0; iRecord < nbRecord; ++iRecord)
+    len += sprintf(buf + len, "{\"v\":\"%d\"}\n", iRecord);
+  long sums[4] = {0};
+  if (JSONRecordsParallel(buf, len, 4, UnitTestJSONParallelSum, sums) ==
+    false || 
+    sums[0] + sums[1] + sums[2] + sums[3] != nbRecord * (nbRecord - 1) / 2) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONRecordsParallel failed");
+    PBErrCatch(JSONErr);
+  }
+  // An invalid record fails the reading
+  char* invalid = strchr(buf + len / 2, '{');
+  *invalid = '#';
+  JSONErr->_type = PBErrTypeUnknown;
+  if (JSONRecordsParallel(buf, len, 4, UnitTestJSONParallelSum, sums) ==
+    true || JSONErr->_type != PBErrTypeInvalidData) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONRecordsParallel failed");
+    PBErrCatch(JSONErr);
+  }
+  free(buf);
+  printf("UnitTestJSONParallel OK\n");
+}
+
+void UnitTestJSONSaveWriter() {
+  // Create a JSON nested deeper than the precomputed indentation and 
+  // with a value larger than the block of the writer
+  int depth = 150;
+  int len = 2 * PBJSON_WRITEBLOCKSIZE + 3;
+  char* val = PBErrMalloc(JSONErr, len + 1);
+  for (int i = 0; i < len; ++i)
+    val[i] = 'a' + i % 26;
+  val[len] = '\0';
+  JSONNode* json = JSONCreate();
+  JSONNode* node = json;
+  for (int i = 0; i < depth; ++i) {
+    JSONNode* child = JSONCreate();
+    JSONAddProp(node, "a", child);
+    node = child;
+  }
+  JSONAddProp(node, "v", val);
+  // Save in readable form and reload
+  FILE* fd = tmpfile();
+  if (!JSONSave(json, fd, false)) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONSave failed");
+    PBErrCatch(JSONErr);
+  }
+  // Check the indentation of the deepest line
+  long size = ftell(fd);
+  rewind(fd);
+  char* str = PBErrMalloc(JSONErr, size + 1);
+  if (fread(str, 1, size, fd) != (size_t)size) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "fread failed");
+    PBErrCatch(JSONErr);
+  }
+  str[size] = '\0';
+  char* line = strstr(str, "\"v\":");
+  int lenIndent = (depth + 1) * (int)strlen(PBJSON_INDENT);
+  if (line == NULL || line - str < lenIndent || 
+    line[-lenIndent - 1] != '\n' || 
+    strspn(line - lenIndent, " ") != (size_t)lenIndent) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONSave failed");
+    PBErrCatch(JSONErr);
+  }
+  JSONNode* jsonLoad = JSONCreate();
+  if (!JSONLoadFromStr(jsonLoad, str)) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONLoad failed");
+    PBErrCatch(JSONErr);
+  }
+  node = jsonLoad;
+  for (int i = 0; i < depth && node != NULL; ++i)
+    node = JSONProperty(node, "a");
+  if (node == NULL || JSONProperty(node, "v") == NULL ||
+    strcmp(JSONLblVal(JSONProperty(node, "v")), val) != 0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONLoad failed");
+    PBErrCatch(JSONErr);
+  }
+  JSONFree(&jsonLoad);
+  fclose(fd);
+  free(str);
+  free(val);
+  JSONFree(&json);
+  printf("UnitTestJSONSaveWriter OK\n");
+}
+
+void UnitTestJSONSaveToBuffer() {
+  JSONNode* json = JSONCreate();
+  if (JSONLoadFromStr(json, 
+    "{\"a\":\"1\",\"b\":[\"2\",\"3\"],\"c\":[{\"d\":\"4\"}]}") == false) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONLoadFromStr failed");
+    PBErrCatch(JSONErr);
+  }
+  // Add a value larger than the initial size of the buffer
+  char val[3 * PBJSON_BLOCKSIZE];
+  memset(val, 'e', sizeof(val) - 1);
+  val[sizeof(val) - 1] = '\0';
+  JSONAddProp(json, "e", val);
+  JSONArena* arena = JSONArenaCreate();
+  char* strRef = PBErrMalloc(JSONErr, 2 * sizeof(val));
+  for (int compact = 0; compact < 2; ++compact) {
+    (void)JSONSaveToStr(json, strRef, 2 * sizeof(val), compact);
+    size_t size = JSONGetSaveSize(json, compact);
+    if (size != strlen(strRef)) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONGetSaveSize failed");
+      PBErrCatch(JSONErr);
+    }
+    // Save on the heap and in the arena
+    for (int iArena = 0; iArena < 2; ++iArena) {
+      size_t len = 0;
+      char* buf = JSONSaveToBuffer(json, (iArena == 1 ? arena : NULL),
+        &len, compact);
+      if (buf == NULL || len != size || strcmp(buf, strRef) != 0) {
+        JSONErr->_type = PBErrTypeUnitTestFailed;
+        sprintf(JSONErr->_msg, "JSONSaveToBuffer failed");
+        PBErrCatch(JSONErr);
+      }
+      if (iArena == 0)
+        free(buf);
+    }
+  }
+  free(strRef);
+  JSONArenaFree(&arena);
+  JSONFree(&json);
+  printf("UnitTestJSONSaveToBuffer OK\n");
+}
+
+// Return true if the cache of the node 'that' is valid
+bool UnitTestJSONCacheIsValid(const JSONNode* const that) {
+  JSONLbl* lbl = (JSONLbl*)GenTreeData(that);
+  return (lbl->_cache != NULL && lbl->_cache->_flagValid);
+}
+
+// Check the compact and readable serializations of 'json' against the 
+// ones of the same JSON without caches, 'strRef'
+void UnitTestJSONCacheCheck(const JSONNode* const json, 
+  const char* const strRef) {
+  size_t len = 0;
+  char* str = JSONSaveToBuffer(json, NULL, &len, true);
+  if (strcmp(str, strRef) != 0 || len != strlen(strRef) ||
+    JSONGetSaveSize(json, true) != len) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONCache failed");
+    PBErrCatch(JSONErr);
+  }
+  free(str);
+}
+
+void UnitTestJSONCache() {
+  JSONArena* arena = JSONArenaCreate();
+  for (int iArena = 0; iArena < 2; ++iArena) {
+    JSONNode* json = (iArena == 0 ? JSONCreate() : 
+      JSONCreateInArena(arena));
+    char* strRef = 
+      "{\"a\":\"1\",\"sub\":{\"b\":[\"2\",\"3\"],\"c\":[{\"d\":\"4\"}],"
+      "\"e\":{\"f\":\"5\"}}}\n";
+    if (JSONLoadFromStr(json, strRef) == false) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONLoadFromStr failed");
+      PBErrCatch(JSONErr);
+    }
+    // Cache the bytes of 'sub' and the length of 'e'
+    JSONNode* sub = JSONProperty(json, "sub");
+    JSONNode* e = JSONProperty(sub, "e");
+    JSONCacheEnable(sub, true);
+    JSONCacheEnable(e, false);
+    if (UnitTestJSONCacheIsValid(sub) || UnitTestJSONCacheIsValid(e)) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONCacheEnable failed");
+      PBErrCatch(JSONErr);
+    }
+    UnitTestJSONCacheCheck(json, strRef);
+    if (!UnitTestJSONCacheIsValid(sub) || !UnitTestJSONCacheIsValid(e)) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONCache failed");
+      PBErrCatch(JSONErr);
+    }
+    // Save again from the cache
+    UnitTestJSONCacheCheck(json, strRef);
+    // The modification of a descendant invalidates its parents
+    JSONSetLabel(JSONValue(JSONProperty(e, "f"), 0), "6");
+    if (UnitTestJSONCacheIsValid(sub) || UnitTestJSONCacheIsValid(e)) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONCacheInvalidate failed");
+      PBErrCatch(JSONErr);
+    }
+    UnitTestJSONCacheCheck(json, 
+      "{\"a\":\"1\",\"sub\":{\"b\":[\"2\",\"3\"],\"c\":[{\"d\":\"4\"}],"
+      "\"e\":{\"f\":\"6\"}}}\n");
+    // The modification of a sibling doesn't invalidate the node
+    JSONAddProp(sub, "g", "7");
+    if (UnitTestJSONCacheIsValid(sub) || !UnitTestJSONCacheIsValid(e)) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONCacheInvalidate failed");
+      PBErrCatch(JSONErr);
+    }
+    UnitTestJSONCacheCheck(json, 
+      "{\"a\":\"1\",\"sub\":{\"b\":[\"2\",\"3\"],\"c\":[{\"d\":\"4\"}],"
+      "\"e\":{\"f\":\"6\"},\"g\":\"7\"}}\n");
+    JSONAppendVal(JSONProperty(sub, "b"), 
+      JSONCreateChild(JSONProperty(sub, "b")));
+    JSONSetLabel(JSONValue(JSONProperty(sub, "b"), 2), "8");
+    UnitTestJSONCacheCheck(json, 
+      "{\"a\":\"1\",\"sub\":{\"b\":[\"2\",\"3\",\"8\"],"
+      "\"c\":[{\"d\":\"4\"}],\"e\":{\"f\":\"6\"},\"g\":\"7\"}}\n");
+    // The readable form doesn't use the cache
+    char strReadable[200] = {0};
+    char* buf = JSONSaveToBuffer(json, NULL, NULL, false);
+    JSONCacheDisable(sub);
+    JSONCacheDisable(e);
+    (void)JSONSaveToStr(json, strReadable, 200, false);
+    if (strcmp(buf, strReadable) != 0) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONCache failed");
+      PBErrCatch(JSONErr);
+    }
+    free(buf);
+    // Caches are freed with the nodes
+    JSONCacheEnable(sub, true);
+    UnitTestJSONCacheCheck(json, 
+      "{\"a\":\"1\",\"sub\":{\"b\":[\"2\",\"3\",\"8\"],"
+      "\"c\":[{\"d\":\"4\"}],\"e\":{\"f\":\"6\"},\"g\":\"7\"}}\n");
+    // The removal of a descendant invalidates its parents
+    JSONNode* g = JSONProperty(sub, "g");
+    JSONFree(&g);
+    if (UnitTestJSONCacheIsValid(sub)) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONCacheInvalidate failed");
+      PBErrCatch(JSONErr);
+    }
+    UnitTestJSONCacheCheck(json, 
+      "{\"a\":\"1\",\"sub\":{\"b\":[\"2\",\"3\",\"8\"],"
+      "\"c\":[{\"d\":\"4\"}],\"e\":{\"f\":\"6\"}}}\n");
+    JSONFree(&json);
+    JSONArenaReset(arena);
+    if (JSONNbCache != 0) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONCacheFree failed");
+      PBErrCatch(JSONErr);
+    }
+  }
+  JSONArenaFree(&arena);
+  printf("UnitTestJSONCache OK\n");
+}
+
+void UnitTestJSONTyped() {
+  // Add typed values
+  JSONNode* json = JSONCreate();
+  int valInt = -12;
+  long long valLong = 9007199254740993LL;
+  double valReal = 0.25;
+  float valFloat = -3.0;
+  bool valBool = true;
+  JSONAddProp(json, "i", valInt);
+  JSONAddProp(json, "l", valLong);
+  JSONAddProp(json, "r", valReal);
+  JSONAddProp(json, "f", valFloat);
+  JSONAddProp(json, "b", valBool);
+  JSONAddPropNull(json, "n");
+  JSONAddProp(json, "s", "42");
+  if (JSONGetType(JSONValue(JSONProperty(json, "i"), 0)) != JSONTypeInt ||
+    JSONIntVal(JSONProperty(json, "i")) != -12 ||
+    JSONIntVal(JSONProperty(json, "l")) != valLong ||
+    JSONGetType(JSONValue(JSONProperty(json, "f"), 0)) != JSONTypeReal ||
+    JSONRealVal(JSONProperty(json, "r")) != 0.25 ||
+    JSONBoolVal(JSONProperty(json, "b")) != true ||
+    JSONGetType(JSONValue(JSONProperty(json, "n"), 0)) != JSONTypeNull ||
+    JSONLblVal(JSONProperty(json, "i")) != NULL) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONAddProp failed");
+    PBErrCatch(JSONErr);
+  }
+  // Conversions between types
+  if (JSONIntVal(JSONProperty(json, "s")) != 42 ||
+    JSONRealVal(JSONProperty(json, "s")) != 42.0 ||
+    JSONRealVal(JSONProperty(json, "i")) != -12.0 ||
+    JSONIntVal(JSONProperty(json, "f")) != -3 ||
+    JSONIntVal(JSONProperty(json, "b")) != 1 ||
+    JSONBoolVal(JSONProperty(json, "n")) != false) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONGetInt failed");
+    PBErrCatch(JSONErr);
+  }
+  // Typed values are saved as native JSON values
+  char* strRef = "{\"i\":-12,\"l\":9007199254740993,\"r\":0.25,"
+    "\"f\":-3.0,\"b\":true,\"n\":null,\"s\":\"42\"}\n";
+  char str[200] = {0};
+  if (!JSONSaveToStr(json, str, 200, true) || strcmp(str, strRef) != 0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONSave failed");
+    PBErrCatch(JSONErr);
+  }
+  // and loaded back with their type
+  JSONNode* jsonLoad = JSONCreate();
+  if (!JSONLoadFromStr(jsonLoad, str) ||
+    JSONGetType(JSONValue(JSONProperty(jsonLoad, "l"), 0)) != 
+      JSONTypeInt ||
+    JSONIntVal(JSONProperty(jsonLoad, "l")) != valLong ||
+    JSONGetType(JSONValue(JSONProperty(jsonLoad, "f"), 0)) != 
+      JSONTypeReal ||
+    JSONRealVal(JSONProperty(jsonLoad, "f")) != -3.0 ||
+    JSONGetType(JSONValue(JSONProperty(jsonLoad, "b"), 0)) != 
+      JSONTypeBool ||
+    JSONGetType(JSONValue(JSONProperty(jsonLoad, "n"), 0)) != 
+      JSONTypeNull ||
+    strcmp(JSONLblVal(JSONProperty(jsonLoad, "s")), "42") != 0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONLoad failed");
+    PBErrCatch(JSONErr);
+  }
+  // Relabelling a typed value turns it back into a string
+  JSONSetLabel(JSONValue(JSONProperty(jsonLoad, "i"), 0), "a");
+  if (JSONGetType(JSONValue(JSONProperty(jsonLoad, "i"), 0)) != 
+    JSONTypeStr || strcmp(JSONLblVal(JSONProperty(jsonLoad, "i")), "a")) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONSetLabel failed");
+    PBErrCatch(JSONErr);
+  }
+  JSONFree(&jsonLoad);
+  JSONFree(&json);
+  // Arrays of mixed values, with and without index
+  strRef = "{\"a\":[1,\"b\",true,null,2.5,-7,\"c\",false,1e+20]}\n";
+  json = JSONCreate();
+  if (!JSONLoadFromStr(json, strRef) || 
+    !JSONSaveToStr(json, str, 200, true) || strcmp(str, strRef) != 0 ||
+    JSONGetNbValue(JSONProperty(json, "a")) != 9 ||
+    JSONGetReal(JSONValue(JSONProperty(json, "a"), 8)) != 1e20 ||
+    JSONProperty(JSONProperty(json, "a"), "c") != 
+      JSONValue(JSONProperty(json, "a"), 6)) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONLoad failed");
+    PBErrCatch(JSONErr);
+  }
+  JSONFree(&json);
+  // Invalid values
+  char* strInvalid[4] = 
+    {"{\"a\":tru}", "{\"a\":1x}", "{\"a\":[1,-]}", "{\"a\":0x10}"};
+  for (int i = 0; i < 4; ++i) {
+    json = JSONCreate();
+    if (JSONLoadFromStr(json, strInvalid[i])) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONLoad failed (%d)", i);
+      PBErrCatch(JSONErr);
+    }
+    JSONFree(&json);
+  }
+  // Unsigned values above INT64_MAX don't wrap to negative integers, 
+  // and reals out of the range of integers are clamped
+  json = JSONCreate();
+  unsigned long long valULong = ULLONG_MAX;
+  unsigned long valUSmall = 7UL;
+  JSONAddProp(json, "u", valULong);
+  JSONAddProp(json, "v", valUSmall);
+  JSONAddProp(json, "nan", (double)NAN);
+  JSONAddProp(json, "big", -1e30);
+  JSONSetLabel(JSONValue(JSONProperty(json, "v"), 0), "1e300");
+  if (JSONGetType(JSONValue(JSONProperty(json, "u"), 0)) != 
+      JSONTypeReal ||
+    JSONRealVal(JSONProperty(json, "u")) != (double)ULLONG_MAX ||
+    JSONIntVal(JSONProperty(json, "u")) != INT64_MAX ||
+    JSONIntVal(JSONProperty(json, "nan")) != 0 ||
+    JSONIntVal(JSONProperty(json, "big")) != INT64_MIN ||
+    JSONIntVal(JSONProperty(json, "v")) != INT64_MAX) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONGetInt failed");
+    PBErrCatch(JSONErr);
+  }
+  JSONFree(&json);
+  json = JSONCreate();
+  JSONAddProp(json, "v", valUSmall);
+  if (JSONGetType(JSONValue(JSONProperty(json, "v"), 0)) != 
+      JSONTypeInt || JSONIntVal(JSONProperty(json, "v")) != 7) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONAddProp failed");
+    PBErrCatch(JSONErr);
+  }
+  JSONFree(&json);
+  // Values changing type between records reusing the same nodes
+  char* buf = "{\"v\":1}\n{\"v\":\"1\"}\n{\"v\":true}\n{\"v\":[2,\"x\"]}\n"
+    "{\"v\":[\"y\",3.5]}\n";
+  JSONType types[5] = 
+    {JSONTypeInt, JSONTypeStr, JSONTypeBool, JSONTypeInt, JSONTypeStr};
+  JSONRecords* records = JSONRecordsCreateFromBuffer(buf, strlen(buf));
+  for (int iRecord = 0; iRecord < 5; ++iRecord) {
+    JSONNode* record = JSONRecordsNext(records);
+    if (record == NULL || JSONGetType(JSONValue(JSONProperty(record, 
+      "v"), 0)) != types[iRecord] || 
+      JSONIntVal(JSONProperty(record, "v")) != 
+        (iRecord == 4 ? 0 : iRecord < 3 ? 1 : 2)) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONRecordsNext failed (%d)", iRecord);
+      PBErrCatch(JSONErr);
+    }
+  }
+  JSONRecordsFree(&records);
+  printf("UnitTestJSONTyped OK\n");
+}
+
+void UnitTestJSONNumber() {
+  char str[PBJSON_SCALARSIZE];
+  // Integers
+  int64_t ints[5] = {0, -7, 1234567890, INT64_MAX, INT64_MIN};
+  char* strInts[5] = {"0", "-7", "1234567890", "9223372036854775807",
+    "-9223372036854775808"};
+  for (int i = 0; i < 5; ++i) {
+    JSONType type = JSONTypeStr;
+    JSONPayload val = {._int = 0};
+    size_t len = JSONFormatInt(ints[i], str);
+    if (len != strlen(strInts[i]) || strcmp(str, strInts[i]) != 0 ||
+      !JSONScanNumber(str, len, &type, &val) || type != JSONTypeInt ||
+      val._int != ints[i]) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONFormatInt failed (%d)", i);
+      PBErrCatch(JSONErr);
+    }
+  }
+  // Floating point numbers, in their shortest representation
+  double reals[12] = {0.1, 1.0 / 3.0, 6.0, -0.0, 1e-7, 5e-324, 
+    1.7976931348623157e308, 123.456, 1e15, 1e14, 0.001, NAN};
+  char* strReals[12] = {"0.1", "0.3333333333333333", "6.0", "-0.0", 
+    "1e-07", "5e-324", "1.7976931348623157e+308", "123.456", "1e+15", 
+    "100000000000000.0", "0.001", "null"};
+  for (int i = 0; i < 12; ++i) {
+    size_t len = JSONFormatReal(reals[i], str);
+    if (len != strlen(strReals[i]) || strcmp(str, strReals[i]) != 0) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONFormatReal failed (%d)", i);
+      PBErrCatch(JSONErr);
+    }
+  }
+  // Random doubles must convert back to the same bits, with 
+  // JSONScanNumber and with the C library
+  uint64_t seed = 88172645463325252ULL;
+  for (int i = 0; i < 100000; ++i) {
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    double real = 0.0;
+    memcpy(&real, &seed, sizeof(real));
+    if (!isfinite(real))
+      continue;
+    size_t len = JSONFormatReal(real, str);
+    JSONType type = JSONTypeStr;
+    JSONPayload val = {._int = 0};
+    double realLibc = strtod(str, NULL);
+    if (!JSONScanNumber(str, len, &type, &val) || 
+      type != JSONTypeReal || memcmp(&real, &(val._real), 
+      sizeof(real)) != 0 || memcmp(&real, &realLibc, 
+      sizeof(real)) != 0) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONFormatReal failed (%s)", str);
+      PBErrCatch(JSONErr);
+    }
+  }
+  // Parsing, including the numbers not converted by the fast path and
+  // the integers too large for 64 bits
+  char* strScan[6] = {"1E2", "-2.5e-3", "0.30000000000000004", 
+    "9223372036854775808", "123456789012345678901234567890", 
+    "4.9e-324"};
+  for (int i = 0; i < 6; ++i) {
+    JSONType type = JSONTypeStr;
+    JSONPayload val = {._int = 0};
+    if (!JSONScanNumber(strScan[i], strlen(strScan[i]), &type, &val) ||
+      type != JSONTypeReal || val._real != strtod(strScan[i], NULL)) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONScanNumber failed (%d)", i);
+      PBErrCatch(JSONErr);
+    }
+  }
+  char* strInvalid[7] = {"", "-", "1.", ".5", "1e", "1e+", "1.5.3"};
+  for (int i = 0; i < 7; ++i) {
+    JSONType type = JSONTypeStr;
+    JSONPayload val = {._int = 0};
+    if (JSONScanNumber(strInvalid[i], strlen(strInvalid[i]), &type, 
+      &val)) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONScanNumber failed (%d)", i);
+      PBErrCatch(JSONErr);
+    }
+  }
+  // The conversions don't depend on the locale, if one with a decimal
+  // comma is available
+  if (setlocale(LC_NUMERIC, "fr_FR.UTF-8") != NULL) {
+    JSONType type = JSONTypeStr;
+    JSONPayload val = {._int = 0};
+    char* strLong = "0.1000000000000000000000000000001";
+    (void)JSONFormatReal(2.5, str);
+    if (strcmp(str, "2.5") != 0 || 
+      !JSONScanNumber(strLong, strlen(strLong), &type, &val) || 
+      val._real != 0.1) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONFormatReal failed (locale)");
+      PBErrCatch(JSONErr);
+    }
+    (void)setlocale(LC_NUMERIC, "C");
+  }
+  // Typed values are saved in their shortest form
+  JSONNode* json = JSONCreate();
+  JSONAddProp(json, "r", 0.1);
+  JSONAddProp(json, "f", 0.1f);
+  (void)JSONSaveToStr(json, str, PBJSON_SCALARSIZE, true);
+  if (strcmp(str, "{\"r\":0.1,\"f\":0.10000000149011612}\n") != 0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONSave failed");
+    PBErrCatch(JSONErr);
+  }
+  JSONFree(&json);
+  printf("UnitTestJSONNumber OK\n");
+}
+
+void UnitTestJSONSimd() {
+  // Create a string value longer than the blocks read from streams, with
+  // escaped chars at the boundaries of the vectors, and one escape char
+  // at the end of the first block read from the stream
+  size_t lenVal = PBJSON_BLOCKSIZE + 200;
+  char* val = PBErrMalloc(JSONErr, lenVal + 1);
+  for (size_t i = 0; i < lenVal; ++i)
+    val[i] = (char)('a' + i % 26);
+  size_t posEsc[8] = {0, 15, 30, 32, 63, 100, 
+    PBJSON_BLOCKSIZE - 7, lenVal - 2};
+  for (int i = 0; i < 8; ++i) {
+    val[posEsc[i]] = '\\';
+    val[posEsc[i] + 1] = (i % 2 == 0 ? '"' : '\\');
+  }
+  val[lenVal] = '\0';
+  // Get the value once its escape sequences are decoded
+  char* valDecoded = PBErrMalloc(JSONErr, lenVal + 1);
+  size_t lenDecoded = 0;
+  for (size_t i = 0; i < lenVal; ++i) {
+    if (val[i] == '\\')
+      ++i;
+    valDecoded[lenDecoded++] = val[i];
+  }
+  valDecoded[lenDecoded] = '\0';
+  // Create the JSON with this value and long runs of spaces
+  char spaces[101];
+  for (int i = 0; i < 100; ++i)
+    spaces[i] = (i % 10 == 0 ? '\n' : (i % 7 == 0 ? '\t' : ' '));
+  spaces[100] = '\0';
+  size_t lenBuf = lenVal + 600;
+  char* buf = PBErrMalloc(JSONErr, lenBuf);
+  snprintf(buf, lenBuf, "{\"k\":\"%s\",%s\"l\":[%s\"x\",%s\"y\"%s]%s}", val, 
+    spaces, spaces, spaces, spaces, spaces);
+  lenBuf = strlen(buf);
+  // Load the JSON with each instruction set, from the buffer and from a
+  // stream
+  for (int iSimd = JSONSimdScalar; iSimd <= JSONSimdAVX2; ++iSimd) {
+    JSONSimd simd = JSONSetSimd((JSONSimd)iSimd);
+    if ((int)simd > iSimd || JSONGetSimd() != simd) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONSetSimd failed (%d)", iSimd);
+      PBErrCatch(JSONErr);
+    }
+    for (int iStream = 0; iStream < 2; ++iStream) {
+      JSONNode* json = JSONCreate();
+      bool ret = false;
+      if (iStream == 0) {
+        ret = JSONLoadFromBuffer(json, buf, lenBuf);
+      } else {
+        FILE* fd = tmpfile();
+        fwrite(buf, sizeof(char), lenBuf, fd);
+        rewind(fd);
+        ret = JSONLoad(json, fd);
+        fclose(fd);
+      }
+      JSONNode* prop = JSONProperty(json, "l");
+      if (!ret || 
+        strcmp(JSONLblVal(JSONProperty(json, "k")), valDecoded) != 0 ||
+        prop == NULL || JSONGetNbValue(prop) != 2 ||
+        strcmp(JSONLabel(JSONValue(prop, 1)), "y") != 0) {
+        JSONErr->_type = PBErrTypeUnitTestFailed;
+        sprintf(JSONErr->_msg, "JSONLoad failed (%d, %d)", iSimd, 
+          iStream);
+        PBErrCatch(JSONErr);
+      }
+      JSONFree(&json);
+    }
+  }
+  // Go back to the best instruction set
+  (void)JSONSetSimd(JSONSimdAVX2);
+  free(val);
+  free(valDecoded);
+  free(buf);
+  printf("UnitTestJSONSimd OK\n");
+}
+
+void UnitTestJSONEscape() {
+  // Labels with chars to escape are escaped when saved, and decoded 
+  // back when loaded
+  JSONNode* json = JSONCreate();
+  char* key = "k\"e\\y";
+  char* val = "a\"b\\c/d\ne\tf\x01g\xc3\xa9";
+  JSONAddProp(json, key, val);
+  char str[100];
+  char* strRef = "{\"k\\\"e\\\\y\":\"a\\\"b\\\\c/d\\ne\\tf\\u0001g\xc3\xa9\"}\n";
+  if (!JSONSaveToStr(json, str, 100, true) || strcmp(str, strRef) != 0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONSave failed");
+    PBErrCatch(JSONErr);
+  }
+  JSONFree(&json);
+  json = JSONCreate();
+  if (!JSONLoadFromStr(json, str) || JSONProperty(json, key) == NULL ||
+    strcmp(JSONLblVal(JSONProperty(json, key)), val) != 0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONLoad failed");
+    PBErrCatch(JSONErr);
+  }
+  JSONFree(&json);
+  // Escape sequences of code points, surrogate pairs, lone surrogates 
+  // and short escapes, decoded by the loader and the incremental parser
+  char* strCode = "{\"a\":\"\\u00e9\\u20AC\\ud83d\\ude00\\ud800x\\/"
+    "\\b\\f\\r\"}";
+  char* valCode = "\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80\xef\xbf\xbdx/"
+    "\b\f\r";
+  for (int iFeed = 0; iFeed < 2; ++iFeed) {
+    json = JSONCreate();
+    bool ret = false;
+    if (iFeed == 0) {
+      ret = JSONLoadFromStr(json, strCode);
+    } else {
+      // Feed the JSON one byte at a time to split the escape sequences
+      JSONFeeder* feeder = JSONFeederCreate(json);
+      JSONFeedRet retFeed = JSONFeedNeedMore;
+      for (size_t i = 0; i < strlen(strCode) && 
+        retFeed == JSONFeedNeedMore; ++i)
+        retFeed = JSONFeed(feeder, strCode + i, 1, NULL);
+      JSONFeederFree(&feeder);
+      ret = (retFeed == JSONFeedComplete);
+    }
+    if (!ret || strcmp(JSONLblVal(JSONProperty(json, "a")), valCode) != 0) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONLoad failed (%d)", iFeed);
+      PBErrCatch(JSONErr);
+    }
+    JSONFree(&json);
+  }
+  // Invalid escape sequences, and '\u0000' which would truncate the 
+  // label, fail with the loader and the incremental parser
+  char* strInvalid[5] = 
+    {"{\"a\":\"\\x\"}", "{\"a\":\"\\u12G4\"}", "{\"a\":\"\\u12\"}",
+    "{\"a\":\"b\\u0000c\"}", "{\"b\\u0000c\":\"a\"}"};
+  for (int i = 0; i < 5; ++i) {
+    json = JSONCreate();
+    if (JSONLoadFromStr(json, strInvalid[i]) ||
+      JSONErr->_type != PBErrTypeInvalidData) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONLoad failed (%d)", i);
+      PBErrCatch(JSONErr);
+    }
+    JSONFree(&json);
+    json = JSONCreate();
+    JSONFeeder* feeder = JSONFeederCreate(json);
+    if (JSONFeed(feeder, strInvalid[i], strlen(strInvalid[i]), NULL) != 
+      JSONFeedError) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONFeed failed (%d)", i);
+      PBErrCatch(JSONErr);
+    }
+    JSONFeederFree(&feeder);
+    JSONFree(&json);
+  }
+  printf("UnitTestJSONEscape OK\n");
+}
+
+void UnitTestJSONLoadMapped() {
+  // Load the same file with JSONLoad and JSONLoadMapped
+  JSONNode* jsonRef = JSONCreate();
+  FILE* fd = fopen("./testJsonReadable.txt", "r");
+  if (!JSONLoad(jsonRef, fd)) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONLoad failed");
+    PBErrCatch(JSONErr);
+  }
+  fclose(fd);
+  char strRef[500];
+  JSONSaveToStr(jsonRef, strRef, 500, true);
+  JSONArena* arena = JSONArenaCreate();
+  for (int iRun = 0; iRun < 2; ++iRun) {
+    JSONNode* json = JSONCreateInArena(arena);
+    if (!JSONLoadMapped(json, "./testJsonReadable.txt")) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONLoadMapped failed");
+      PBErrCatch(JSONErr);
+    }
+    char str[500];
+    if (!JSONSaveToStr(json, str, 500, true) || strcmp(str, strRef) != 0) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONLoadMapped failed");
+      PBErrCatch(JSONErr);
+    }
+    // Labels without escape sequence are borrowed from the mapping, 
+    // the others are copied
+    JSONNode* prop = JSONProperty(json, "_intVal");
+    JSONNode* propEsc = JSONProperty(json, "_escapeVal");
+    if (prop == NULL || propEsc == NULL ||
+      !((JSONLbl*)GenTreeData(prop))->_flagBorrowed ||
+      !((JSONLbl*)GenTreeData(JSONValue(prop, 0)))->_flagBorrowed ||
+      ((JSONLbl*)GenTreeData(JSONValue(propEsc, 0)))->_flagBorrowed ||
+      strcmp(JSONLblVal(propEsc), "\"double quoted\"") != 0) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONLoadMapped failed");
+      PBErrCatch(JSONErr);
+    }
+    // A borrowed label can be replaced like any other
+    JSONSetLabel(JSONValue(prop, 0), "11");
+    if (strcmp(JSONLblVal(prop), "11") != 0 ||
+      ((JSONLbl*)GenTreeData(JSONValue(prop, 0)))->_flagBorrowed) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONLoadMapped failed");
+      PBErrCatch(JSONErr);
+    }
+    // The mapping is released with the trees of the arena
+    JSONArenaReset(arena);
+  }
+  // The file is left unchanged by the loading
+  JSONNode* json = JSONCreate();
+  fd = fopen("./testJsonReadable.txt", "r");
+  char str[500];
+  if (!JSONLoad(json, fd) || !JSONSaveToStr(json, str, 500, true) ||
+    strcmp(str, strRef) != 0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONLoadMapped failed");
+    PBErrCatch(JSONErr);
+  }
+  fclose(fd);
+  JSONFree(&json);
+  // The loading fails on a missing file and on a node not in an arena
+  json = JSONCreateInArena(arena);
+  if (JSONLoadMapped(json, "./missing.txt") || 
+    JSONLoadMapped(jsonRef, "./testJsonReadable.txt")) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONLoadMapped failed");
+    PBErrCatch(JSONErr);
+  }
+  JSONArenaFree(&arena);
+  JSONFree(&jsonRef);
+  printf("UnitTestJSONLoadMapped OK\n");
+}
+
+void UnitTestJSONLazy() {
+  // Nested objects, arrays of values, arrays of structs, an empty one 
+  // and strings with brackets and escaped double quotes
+  char* str = "{\"a\":\"1\",\"b\":{\"c\":\"}]\\\"\",\"d\":{\"e\":"
+    "[\"[\",2]}},\"f\":[{\"g\":\"3\"},{\"h\":{\"i\":true}}],\"j\":[]}";
+  // The lazy loading must give the same JSON as the usual one
+  JSONNode* jsonRef = JSONCreate();
+  char strRef[200];
+  if (!JSONLoadFromStr(jsonRef, str) || 
+    !JSONSaveToStr(jsonRef, strRef, 200, true)) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONLoadFromStr failed");
+    PBErrCatch(JSONErr);
+  }
+  JSONFree(&jsonRef);
+  JSONArena* arena = JSONArenaCreate();
+  JSONArenaSetLazy(arena, true);
+  JSONNode* json = JSONCreateInArena(arena);
+  if (!JSONLoadFromStr(json, str) || JSONGetNbValue(json) != 4) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONLoadFromStr failed");
+    PBErrCatch(JSONErr);
+  }
+  // The nested objects and arrays are not loaded, except the empty ones
+  JSONNode* b = JSONProperty(json, "b");
+  JSONNode* f = JSONProperty(json, "f");
+  if (b == NULL || f == NULL ||
+    ((JSONLbl*)GenTreeData(b))->_lazy == NULL ||
+    ((JSONLbl*)GenTreeData(f))->_lazy == NULL ||
+    ((JSONLbl*)GenTreeData(JSONProperty(json, "j")))->_lazy != NULL) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONLoad lazy failed");
+    PBErrCatch(JSONErr);
+  }
+  // Accessing a property loads one level
+  JSONNode* d = JSONProperty(b, "d");
+  if (((JSONLbl*)GenTreeData(b))->_lazy != NULL || d == NULL ||
+    ((JSONLbl*)GenTreeData(d))->_lazy == NULL ||
+    strcmp(JSONLblVal(JSONProperty(b, "c")), "}]\"") != 0 ||
+    ((JSONLbl*)GenTreeData(f))->_lazy == NULL) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONLoad lazy failed");
+    PBErrCatch(JSONErr);
+  }
+  // Saving loads the remaining values
+  char strSave[200];
+  if (!JSONSaveToStr(json, strSave, 200, true) || 
+    strcmp(strSave, strRef) != 0 ||
+    JSONGetInt(JSONValue(JSONProperty(d, "e"), 1)) != 2) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONSave lazy failed");
+    PBErrCatch(JSONErr);
+  }
+  JSONArenaReset(arena);
+  // Objects and arrays spanning several blocks of a stream are loaded 
+  // lazily too, as well as the ones of a mapped file
+  size_t lenVal = PBJSON_BLOCKSIZE * 3;
+  char strLong[PBJSON_BLOCKSIZE * 3 + 100];
+  char strSaveLong[PBJSON_BLOCKSIZE * 3 + 100];
+  sprintf(strLong, "{\"a\":{\"b\":[\"");
+  size_t len = strlen(strLong);
+  for (size_t i = 0; i < lenVal; ++i)
+    strLong[len + i] = (i % 3 == 0 ? '}' : 'x');
+  sprintf(strLong + len + lenVal, "\",\"y\"]}}\n");
+  FILE* fd = tmpfile();
+  fputs(strLong, fd);
+  fputs(str, fd);
+  rewind(fd);
+  for (int iJson = 0; iJson < 2; ++iJson) {
+    json = JSONCreateInArena(arena);
+    JSONNode* prop = NULL;
+    if (!JSONLoad(json, fd) || 
+      (prop = JSONProperty(json, (iJson == 0 ? "a" : "b"))) == NULL ||
+      ((JSONLbl*)GenTreeData(prop))->_lazy == NULL ||
+      !JSONSaveToStr(json, strSaveLong, lenVal + 100, true) ||
+      strcmp(strSaveLong, (iJson == 0 ? strLong : strRef)) != 0) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONLoad lazy failed (%d)", iJson);
+      PBErrCatch(JSONErr);
+    }
+  }
+  fclose(fd);
+  json = JSONCreateInArena(arena);
+  jsonRef = JSONCreate();
+  fd = fopen("./testJsonReadable.txt", "r");
+  if (!JSONLoadMapped(json, "./testJsonReadable.txt") ||
+    ((JSONLbl*)GenTreeData(JSONProperty(json, "_structVal")))->_lazy 
+      == NULL || !JSONLoad(jsonRef, fd) || 
+    !JSONSaveToStr(json, strSave, 200, true) ||
+    !JSONSaveToStr(jsonRef, strRef, 200, true) ||
+    strcmp(strSave, strRef) != 0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONLoadMapped lazy failed");
+    PBErrCatch(JSONErr);
+  }
+  fclose(fd);
+  JSONFree(&jsonRef);
+  // An array mixing values and structs is invalid, but it's not checked
+  // until it's loaded
+  json = JSONCreateInArena(arena);
+  if (!JSONLoadFromStr(json, "{\"l\":[\"4\",{\"m\":5}]}") ||
+    JSONLoadLazy(JSONProperty(json, "l"))) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONLoadLazy failed");
+    PBErrCatch(JSONErr);
+  }
+  // Unbalanced brackets fail when loading
+  json = JSONCreateInArena(arena);
+  if (JSONLoadFromStr(json, "{\"a\":{\"b\":\"1\"}")) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONLoad lazy failed");
+    PBErrCatch(JSONErr);
+  }
+  JSONArenaFree(&arena);
+  printf("UnitTestJSONLazy OK\n");
+}
+
+// Return true if the JSON nodes 'a' and 'b' have the same labels and 
+// the same subtrees
+bool UnitTestJSONPathIsSame(const JSONNode* const a, 
+  const JSONNode* const b) {
+  const char* lblA = JSONLabel(a);
+  const char* lblB = JSONLabel(b);
+  if ((lblA == NULL) != (lblB == NULL) || 
+    (lblA != NULL && strcmp(lblA, lblB) != 0) ||
+    JSONGetNbValue(a) != JSONGetNbValue(b))
+    return false;
+  for (long iVal = JSONGetNbValue(a); iVal--;)
+    if (!UnitTestJSONPathIsSame(JSONValue(a, iVal), JSONValue(b, iVal)))
+      return false;
+  return true;
+}
+
+void UnitTestJSONPath() {
+  // Invalid expressions are rejected
+  const char* exprInvalid[8] = {"a.b", "$.", "$[", "$[1", "$['k]", 
+    "$[1:2:0]", "$x", "$[a]"};
+  for (int iExpr = 0; iExpr < 8; ++iExpr) {
+    JSONPath* path = JSONPathCompile(exprInvalid[iExpr]);
+    if (path != NULL || JSONErr->_type != PBErrTypeInvalidArg) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONPathCompile failed (%s)", 
+        exprInvalid[iExpr]);
+      PBErrCatch(JSONErr);
+    }
+  }
+  char* str = "{\"a\":{\"b\":[{\"c\":\"0\"},{\"c\":\"1\"},{\"c\":\"2\"},"
+    "{\"c\":\"3\",\"d\":[1,2,3,4,5]}]},\"e\":\"x\","
+    "\"arr\":[10,11,12,13,14,15],\"k.y\":\"z\"}";
+  JSONNode* json = JSONCreate();
+  if (!JSONLoadFromStr(json, str)) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONLoadFromStr failed");
+    PBErrCatch(JSONErr);
+  }
+  // The root is selected by the empty path
+  JSONPath* path = JSONPathCompile("$");
+  if (path == NULL || JSONPathGet(path, json) != json) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONPathGet failed");
+    PBErrCatch(JSONErr);
+  }
+  JSONPathFree(&path);
+  // Evaluate the paths on the loaded JSON and on the string, both must
+  // select the same nodes
+  const char* expr[10] = {"$.a.b[3].c", "$.a.b[*].c", "$.arr[1:5:2]", 
+    "$.*", "$['k.y']", "$.a.b[3].d[::2]", "$.e[0]", "$.arr.x", 
+    "$[\"a\"].b[2:]", "$.a.b[:2]"};
+  long nbMatch[10] = {1, 4, 2, 4, 1, 3, 1, 0, 2, 2};
+  for (int iExpr = 0; iExpr < 10; ++iExpr) {
+    path = JSONPathCompile(expr[iExpr]);
+    JSONArrayStruct matches = JSONArrayStructCreateStatic();
+    JSONNode* matchesLoad = JSONCreate();
+    if (path == NULL || 
+      JSONPathEval(path, json, &matches) != nbMatch[iExpr] ||
+      !JSONPathLoadFromBuffer(path, matchesLoad, str, strlen(str)) ||
+      JSONGetNbValue(matchesLoad) != nbMatch[iExpr]) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONPathEval failed (%s)", expr[iExpr]);
+      PBErrCatch(JSONErr);
+    }
+    for (long iMatch = 0; iMatch < nbMatch[iExpr]; ++iMatch) {
+      if (!UnitTestJSONPathIsSame(GSetGet(&matches, iMatch), 
+        JSONValue(matchesLoad, iMatch))) {
+        JSONErr->_type = PBErrTypeUnitTestFailed;
+        sprintf(JSONErr->_msg, "JSONPathLoad failed (%s)", expr[iExpr]);
+        PBErrCatch(JSONErr);
+      }
+    }
+    JSONArrayStructFlush(&matches);
+    JSONFree(&matchesLoad);
+    JSONPathFree(&path);
+  }
+  // Check the values of some of the selected nodes
+  path = JSONPathCompile("$.a.b[3].c");
+  JSONNode* node = JSONPathGet(path, json);
+  if (node == NULL || strcmp(JSONLblVal(node), "3") != 0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONPathGet failed");
+    PBErrCatch(JSONErr);
+  }
+  JSONPathFree(&path);
+  path = JSONPathCompile("$.arr[1:5:2]");
+  JSONArrayStruct matches = JSONArrayStructCreateStatic();
+  if (JSONPathEval(path, json, &matches) != 2 ||
+    JSONGetInt(GSetGet(&matches, 0)) != 11 ||
+    JSONGetInt(GSetGet(&matches, 1)) != 13) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONPathEval failed");
+    PBErrCatch(JSONErr);
+  }
+  JSONArrayStructFlush(&matches);
+  JSONPathFree(&path);
+  // Positions relative to the end are evaluated on the loaded JSON but
+  // not in streaming
+  path = JSONPathCompile("$.arr[-2]");
+  node = JSONPathGet(path, json);
+  JSONNode* matchesLoad = JSONCreate();
+  if (node == NULL || JSONGetInt(node) != 14 ||
+    JSONPathLoadFromBuffer(path, matchesLoad, str, strlen(str))) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONPathGet failed");
+    PBErrCatch(JSONErr);
+  }
+  JSONFree(&matchesLoad);
+  JSONPathFree(&path);
+  // A path can be loaded from a stream and from a top level array, and
+  // the indexed lookup is used on long arrays
+  FILE* fd = tmpfile();
+  fputs("[", fd);
+  for (int i = 0; i < 2 * PBJSON_INDEXMIN; ++i)
+    fprintf(fd, "%s{\"v\":%d}", (i == 0 ? "" : ","), i);
+  fputs("]", fd);
+  rewind(fd);
+  JSONFree(&json);
+  json = JSONCreate();
+  matchesLoad = JSONCreate();
+  path = JSONPathCompile("$[''][3::5].v");
+  if (!JSONLoad(json, fd) || fseek(fd, 0, SEEK_SET) != 0 ||
+    !JSONPathLoad(path, matchesLoad, fd) ||
+    JSONPathEval(path, json, &matches) != (2 * PBJSON_INDEXMIN + 1) / 5 ||
+    JSONGetNbValue(matchesLoad) != (2 * PBJSON_INDEXMIN + 1) / 5 ||
+    JSONGetInt(JSONValue(GSetGet(&matches, 1), 0)) != 8 ||
+    !UnitTestJSONPathIsSame(GSetGet(&matches, 1), 
+      JSONValue(matchesLoad, 1))) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONPathLoad failed");
+    PBErrCatch(JSONErr);
+  }
+  fclose(fd);
+  JSONArrayStructFlush(&matches);
+  JSONFree(&matchesLoad);
+  JSONPathFree(&path);
+  JSONFree(&json);
+  printf("UnitTestJSONPath OK\n");
+}
+
+void UnitTestJSONBinary() {
+  // Typed values, nested objects, arrays of values and of structs, an 
+  // empty array and a string with escaped chars
+  char* str = "{\"a\":\"x\\\"y\",\"i\":-300,\"l\":9007199254740993,"
+    "\"r\":0.1,\"b\":[true,false],\"n\":null,\"o\":{\"p\":{\"q\":\"1\"}},"
+    "\"s\":[{\"t\":1},{\"u\":[2,3]}],\"e\":[]}";
+  JSONNode* json = JSONCreate();
+  char strRef[300];
+  if (!JSONLoadFromStr(json, str) || 
+    !JSONSaveToStr(json, strRef, 300, true)) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONLoadFromStr failed");
+    PBErrCatch(JSONErr);
+  }
+  // Save and load through a stream, the tree and the values must be 
+  // the same
+  FILE* fd = tmpfile();
+  JSONNode* jsonBin = JSONCreate();
+  char strSave[300];
+  if (!JSONSaveBinary(json, fd) || fseek(fd, 0, SEEK_SET) != 0 ||
+    !JSONLoadBinary(jsonBin, fd) || 
+    !UnitTestJSONPathIsSame(json, jsonBin) ||
+    !JSONSaveToStr(jsonBin, strSave, 300, true) ||
+    strcmp(strSave, strRef) != 0 ||
+    JSONIntVal(JSONProperty(jsonBin, "i")) != -300 ||
+    JSONIntVal(JSONProperty(jsonBin, "l")) != 9007199254740993LL ||
+    JSONRealVal(JSONProperty(jsonBin, "r")) != 0.1 ||
+    JSONGetType(JSONValue(JSONProperty(jsonBin, "n"), 0)) != 
+      JSONTypeNull) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONLoadBinary failed");
+    PBErrCatch(JSONErr);
+  }
+  fclose(fd);
+  JSONFree(&jsonBin);
+  // Save and load through buffers, in an arena too, the binary output 
+  // is smaller than the text one
+  size_t len = 0;
+  char* buf = JSONSaveBinaryToBuffer(json, NULL, &len);
+  JSONArena* arena = JSONArenaCreate();
+  size_t lenArena = 0;
+  char* bufArena = JSONSaveBinaryToBuffer(json, arena, &lenArena);
+  jsonBin = JSONCreateInArena(arena);
+  if (len >= strlen(strRef) || lenArena != len || 
+    memcmp(buf, bufArena, len) != 0 || 
+    !JSONLoadBinaryFromBuffer(jsonBin, bufArena, lenArena) ||
+    !JSONSaveToStr(jsonBin, strSave, 300, true) ||
+    strcmp(strSave, strRef) != 0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONLoadBinaryFromBuffer failed");
+    PBErrCatch(JSONErr);
+  }
+  // Truncated data, an invalid header and an invalid tag are rejected
+  for (size_t lenTrunc = 0; lenTrunc < len; ++lenTrunc) {
+    jsonBin = JSONCreateInArena(arena);
+    if (JSONLoadBinaryFromBuffer(jsonBin, buf, lenTrunc) || 
+      JSONErr->_type != PBErrTypeInvalidData) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONLoadBinaryFromBuffer failed (%zu)", 
+        lenTrunc);
+      PBErrCatch(JSONErr);
+    }
+  }
+  buf[PBJSON_BINHEADERSIZE - 1] = PBJSON_BINVERSION + 1;
+  jsonBin = JSONCreateInArena(arena);
+  char bufTag[PBJSON_BINHEADERSIZE + 2];
+  memcpy(bufTag, PBJSON_BINMAGIC, PBJSON_BINHEADERSIZE - 1);
+  bufTag[PBJSON_BINHEADERSIZE - 1] = PBJSON_BINVERSION;
+  bufTag[PBJSON_BINHEADERSIZE] = 1;
+  bufTag[PBJSON_BINHEADERSIZE + 1] = 7;
+  if (JSONLoadBinaryFromBuffer(jsonBin, buf, len) ||
+    JSONLoadBinaryFromBuffer(jsonBin, bufTag, PBJSON_BINHEADERSIZE + 2)) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONLoadBinaryFromBuffer failed");
+    PBErrCatch(JSONErr);
+  }
+  free(buf);
+  JSONArenaFree(&arena);
+  // Strings spanning several blocks of a stream
+  JSONFree(&json);
+  json = JSONCreate();
+  char strLong[PBJSON_BLOCKSIZE * 3];
+  memset(strLong, 'x', PBJSON_BLOCKSIZE * 3 - 1);
+  strLong[PBJSON_BLOCKSIZE * 3 - 1] = '\0';
+  JSONAddProp(json, "a", strLong);
+  JSONAddProp(json, "b", strLong + PBJSON_BLOCKSIZE);
+  fd = tmpfile();
+  jsonBin = JSONCreate();
+  if (!JSONSaveBinary(json, fd) || fseek(fd, 0, SEEK_SET) != 0 ||
+    !JSONLoadBinary(jsonBin, fd) || 
+    !UnitTestJSONPathIsSame(json, jsonBin)) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONLoadBinary failed");
+    PBErrCatch(JSONErr);
+  }
+  fclose(fd);
+  JSONFree(&jsonBin);
+  JSONFree(&json);
+  printf("UnitTestJSONBinary OK\n");
+}
+
+// Descriptions of structB and structA for the struct codec
+static const JSONStructField StructBFields[] = {
+  JSONStructFieldDef(struct structB, _intVal, JSONFieldInt, 0, NULL),
+  JSONStructFieldDef(struct structB, _floatVal, JSONFieldFloat, 0, NULL)
+};
+static const JSONStructDesc StructBDesc = 
+  JSONStructDescDef(StructBFields);
+static const JSONStructField StructAFields[] = {
+  JSONStructFieldDef(struct structA, _intVal, JSONFieldInt, 0, NULL),
+  JSONStructFieldDef(struct structA, _intArr, JSONFieldInt, 3, NULL),
+  JSONStructFieldDef(struct structA, _structVal, JSONFieldStruct, 0, 
+    &StructBDesc),
+  JSONStructFieldDef(struct structA, _structArr, JSONFieldStruct, 2, 
+    &StructBDesc)
+};
+static const JSONStructDesc StructADesc = 
+  JSONStructDescDef(StructAFields);
+
+struct structC {
+  char _name[8];
+  int64_t _longVal;
+  double _realArr[2];
+  bool _flag;
+  struct structA _structA;
+};
+
+static const JSONStructField StructCFields[] = {
+  JSONStructFieldDef(struct structC, _name, JSONFieldStr, 0, NULL),
+  JSONStructFieldDef(struct structC, _longVal, JSONFieldInt64, 0, NULL),
+  JSONStructFieldDef(struct structC, _realArr, JSONFieldDouble, 2, NULL),
+  JSONStructFieldDef(struct structC, _flag, JSONFieldBool, 0, NULL),
+  JSONStructFieldDef(struct structC, _structA, JSONFieldStruct, 0, 
+    &StructADesc)
+};
+static const JSONStructDesc StructCDesc = 
+  JSONStructDescDef(StructCFields);
+
+void UnitTestJSONStructCodec() {
+  struct structC myStruct;
+  memset(&myStruct, 0, sizeof(myStruct));
+  strcpy(myStruct._name, "a\"b\\c");
+  myStruct._longVal = -9007199254740993LL;
+  myStruct._realArr[0] = 0.1;
+  myStruct._realArr[1] = -2.5e-300;
+  myStruct._flag = true;
+  myStruct._structA._intVal = 1;
+  for (int i = 0; i < 3; ++i)
+    myStruct._structA._intArr[i] = -2 - i;
+  myStruct._structA._structVal._intVal = 5;
+  myStruct._structA._structVal._floatVal = 0.1f;
+  for (int i = 0; i < 2; ++i) {
+    myStruct._structA._structArr[i]._intVal = 7 + i;
+    myStruct._structA._structArr[i]._floatVal = 8.5f + i;
+  }
+  // The output is the same as JSONSave of the same JSON loaded as a 
+  // tree, and loading it gives back the struct
+  for (int iMode = 0; iMode < 2; ++iMode) {
+    bool compact = (iMode == 0);
+    size_t len = 0;
+    char* buf = JSONStructSaveToBuffer(&myStruct, &StructCDesc, &len, 
+      compact);
+    JSONNode* json = JSONCreate();
+    char* bufTree = NULL;
+    struct structC myStructLoad;
+    memset(&myStructLoad, 0, sizeof(myStructLoad));
+    if (len != strlen(buf) || !JSONLoadFromBuffer(json, buf, len) ||
+      (bufTree = JSONSaveToBuffer(json, NULL, NULL, compact)) == NULL ||
+      strcmp(buf, bufTree) != 0 ||
+      !JSONStructLoadFromBuffer(&myStructLoad, &StructCDesc, buf, len) ||
+      memcmp(&myStructLoad, &myStruct, sizeof(myStruct)) != 0) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONStructSaveToBuffer failed (%d)", iMode);
+      PBErrCatch(JSONErr);
+    }
+    free(bufTree);
+    free(buf);
+    JSONFree(&json);
+  }
+  // Save and load through a stream
+  FILE* fd = tmpfile();
+  struct structC myStructLoad;
+  memset(&myStructLoad, 0, sizeof(myStructLoad));
+  if (!JSONStructSave(&myStruct, &StructCDesc, fd, false) || 
+    fseek(fd, 0, SEEK_SET) != 0 ||
+    !JSONStructLoad(&myStructLoad, &StructCDesc, fd) ||
+    memcmp(&myStructLoad, &myStruct, sizeof(myStruct)) != 0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONStructLoad failed");
+    PBErrCatch(JSONErr);
+  }
+  fclose(fd);
+  // The file saved with the JSON tree by StructASave, with quoted 
+  // numbers and properties not in structA, gives the same struct
+  struct structA myStructA;
+  memset(&myStructA, 0, sizeof(myStructA));
+  fd = fopen("./testJsonReadable.txt", "r");
+  if (!JSONStructLoad(&myStructA, &StructADesc, fd) || 
+    myStructA._intVal != 1 || myStructA._intArr[2] != 4 ||
+    myStructA._structVal._floatVal != 6.0 ||
+    myStructA._structArr[1]._intVal != 9) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONStructLoad failed");
+    PBErrCatch(JSONErr);
+  }
+  fclose(fd);
+  // Keys out of order, unknown keys and null values
+  char* str = "{\"_flag\":false,\"x\":{\"y\":[1,{\"z\":\"}\"}]},"
+    "\"_name\":\"ab\",\"_longVal\":null,\"_realArr\":[3]}";
+  if (!JSONStructLoadFromBuffer(&myStructLoad, &StructCDesc, str, 
+    strlen(str)) || myStructLoad._flag || 
+    strcmp(myStructLoad._name, "ab") != 0 ||
+    myStructLoad._longVal != myStruct._longVal ||
+    myStructLoad._realArr[0] != 3.0 || myStructLoad._realArr[1] != 
+    myStruct._realArr[1]) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONStructLoadFromBuffer failed");
+    PBErrCatch(JSONErr);
+  }
+  // Invalid values: string too long, too many values, wrong type, 
+  // overflow, and not an object
+  const char* strInvalid[5] = {"{\"_name\":\"abcdefgh\"}", 
+    "{\"_realArr\":[1,2,3]}", "{\"_flag\":1}", 
+    "{\"_structA\":{\"_intVal\":3000000000}}", "[1]"};
+  for (int iStr = 0; iStr < 5; ++iStr) {
+    if (JSONStructLoadFromBuffer(&myStructLoad, &StructCDesc, 
+      strInvalid[iStr], strlen(strInvalid[iStr])) || 
+      JSONErr->_type != PBErrTypeInvalidData) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONStructLoadFromBuffer failed (%d)", 
+        iStr);
+      PBErrCatch(JSONErr);
+    }
+  }
+  printf("UnitTestJSONStructCodec OK\n");
+}
+
+// Write with the streaming writer 'writer' a JSON with all the kinds 
+// of values, nested objects, arrays of values and of objects
+// Return true if it could write, false else
+bool UnitTestJSONWriterWrite(JSONWriter* const writer) {
+  bool valBool = true;
+  bool ret = JSONWriterBeginObject(writer) &&
+    JSONWriterKey(writer, "a") && JSONWriterValue(writer, "x\"y") &&
+    JSONWriterKey(writer, "i") && JSONWriterValue(writer, -3) &&
+    JSONWriterKey(writer, "r") && JSONWriterValue(writer, 0.5) &&
+    JSONWriterKey(writer, "b") && JSONWriterValue(writer, valBool) &&
+    JSONWriterKey(writer, "n") && JSONWriterValueNull(writer) &&
+    JSONWriterKey(writer, "arr") && JSONWriterBeginArray(writer);
+  for (int i = 1; ret && i <= 3; ++i)
+    ret = JSONWriterValue(writer, i);
+  return ret && JSONWriterEndArray(writer) &&
+    JSONWriterKey(writer, "o") && JSONWriterBeginObject(writer) &&
+    JSONWriterKey(writer, "p") && JSONWriterBeginObject(writer) &&
+    JSONWriterKey(writer, "q") && JSONWriterValue(writer, "1") &&
+    JSONWriterEndObject(writer) && 
+    JSONWriterKey(writer, "s") && JSONWriterValue(writer, "t") &&
+    JSONWriterEndObject(writer) &&
+    JSONWriterKey(writer, "objs") && JSONWriterBeginArray(writer) &&
+    JSONWriterBeginObject(writer) && 
+    JSONWriterKey(writer, "u") && JSONWriterValue(writer, 1) &&
+    JSONWriterKey(writer, "v") && JSONWriterBeginArray(writer) &&
+    JSONWriterValue(writer, 4) && JSONWriterValue(writer, 5) &&
+    JSONWriterEndArray(writer) && JSONWriterEndObject(writer) &&
+    JSONWriterBeginObject(writer) && 
+    JSONWriterKey(writer, "w") && JSONWriterValue(writer, "z") &&
+    JSONWriterEndObject(writer) && JSONWriterEndArray(writer) &&
+    JSONWriterEndObject(writer);
+}
+
+void UnitTestJSONWriter() {
+  // The output in a buffer is the same as JSONSave of the same JSON, 
+  // and the same as the output on a stream by small blocks
+  char buf[500];
+  char bufTree[500];
+  char bufStream[500];
+  char block[16];
+  for (int iMode = 0; iMode < 2; ++iMode) {
+    bool compact = (iMode == 0);
+    JSONWriter writer = JSONWriterCreateStatic(NULL, buf, 500, compact);
+    size_t len = 0;
+    JSONNode* json = JSONCreate();
+    if (!UnitTestJSONWriterWrite(&writer) || 
+      !JSONWriterEnd(&writer, &len) || len != strlen(buf) ||
+      strstr(buf, "\"b\":true") == NULL ||
+      !JSONLoadFromStr(json, buf) || 
+      !JSONSaveToStr(json, bufTree, 500, compact) ||
+      strcmp(buf, bufTree) != 0) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONWriter failed (%d)", iMode);
+      PBErrCatch(JSONErr);
+    }
+    JSONFree(&json);
+    FILE* fd = tmpfile();
+    writer = JSONWriterCreateStatic(fd, block, 16, compact);
+    size_t lenStream = 0;
+    if (!UnitTestJSONWriterWrite(&writer) || 
+      !JSONWriterEnd(&writer, &lenStream) || lenStream != len || 
+      fseek(fd, 0, SEEK_SET) != 0 ||
+      fread(bufStream, 1, len, fd) != len || 
+      memcmp(bufStream, buf, len) != 0) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONWriter failed (%d)", iMode);
+      PBErrCatch(JSONErr);
+    }
+    fclose(fd);
+    // Same for an array at the root
+    writer = JSONWriterCreateStatic(NULL, buf, 500, compact);
+    json = JSONCreate();
+    if (!JSONWriterBeginArray(&writer) || 
+      !JSONWriterValue(&writer, 1) || !JSONWriterValue(&writer, "2") ||
+      !JSONWriterValue(&writer, 3.5) || !JSONWriterEndArray(&writer) ||
+      !JSONWriterEnd(&writer, NULL) || !JSONLoadFromStr(json, buf) || 
+      !JSONSaveToStr(json, bufTree, 500, compact) ||
+      strcmp(buf, bufTree) != 0) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONWriter failed (%d)", iMode);
+      PBErrCatch(JSONErr);
+    }
+    JSONFree(&json);
+  }
+  // Calls in the wrong state are rejected
+  JSONWriter writer = JSONWriterCreateStatic(NULL, buf, 500, true);
+  if (JSONWriterValue(&writer, 1) || JSONWriterKey(&writer, "a") ||
+    JSONWriterEndObject(&writer) || JSONWriterEnd(&writer, NULL) ||
+    !JSONWriterBeginObject(&writer) || JSONWriterValue(&writer, 1) ||
+    JSONWriterEndArray(&writer) || !JSONWriterKey(&writer, "a") ||
+    JSONWriterKey(&writer, "b") || JSONWriterEndObject(&writer) ||
+    !JSONWriterBeginArray(&writer) || JSONWriterKey(&writer, "c") ||
+    JSONWriterEnd(&writer, NULL) || !JSONWriterEndArray(&writer) ||
+    !JSONWriterEndObject(&writer) || JSONWriterBeginObject(&writer) ||
+    JSONErr->_type != PBErrTypeInvalidArg ||
+    !JSONWriterEnd(&writer, NULL) || strcmp(buf, "{\"a\":[]}\n") != 0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONWriter failed");
+    PBErrCatch(JSONErr);
+  }
+  // Unsigned values are written exactly, even above INT64_MAX
+  writer = JSONWriterCreateStatic(NULL, buf, 500, true);
+  unsigned long long valULong = ULLONG_MAX;
+  unsigned long valUSmall = 7UL;
+  if (!JSONWriterBeginArray(&writer) || 
+    !JSONWriterValue(&writer, valULong) || 
+    !JSONWriterValue(&writer, valUSmall) || 
+    !JSONWriterEndArray(&writer) || !JSONWriterEnd(&writer, NULL) ||
+    strcmp(buf, "[18446744073709551615,7]\n") != 0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONWriterValue failed");
+    PBErrCatch(JSONErr);
+  }
+  // The nesting is limited
+  writer = JSONWriterCreateStatic(NULL, buf, 500, true);
+  for (int i = 0; i < PBJSON_WRITERDEPTHMAX; ++i) {
+    if (!JSONWriterBeginArray(&writer)) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONWriterBeginArray failed");
+      PBErrCatch(JSONErr);
+    }
+  }
+  if (JSONWriterBeginArray(&writer)) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONWriterBeginArray failed");
+    PBErrCatch(JSONErr);
+  }
+  // A buffer too small fails
+  writer = JSONWriterCreateStatic(NULL, buf, 20, false);
+  if (UnitTestJSONWriterWrite(&writer) || 
+    JSONErr->_type != PBErrTypeIOError) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONWriter failed");
+    PBErrCatch(JSONErr);
+  }
+  printf("UnitTestJSONWriter OK\n");
+}
+
+void UnitTestJSONAllocCount() {
+  // Loading allocates exactly one label per string scanned, attached 
+  // directly to its node
+  for (int iMode = 0; iMode < 2; ++iMode) {
+    JSONArena* arena = (iMode == 0 ? NULL : JSONArenaCreate());
+    JSONNode* json = 
+      (arena == NULL ? JSONCreate() : JSONCreateInArena(arena));
+    JSONStatsReset();
+    if (!JSONLoadFromStr(json, 
+      "{\"a\":[\"x\",\"y\",\"z\"],\"b\":\"w\"}")) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONLoadFromStr failed");
+      PBErrCatch(JSONErr);
+    }
+    JSONStats stats = JSONStatsGet();
+    if (stats._nbNode != 6 || stats._nbLbl != 6 || 
+      stats._nbLblByte < 6 * (long)sizeof(JSONLbl)) {
+      JSONErr->_type = PBErrTypeUnitTestFailed;
+      sprintf(JSONErr->_msg, "JSONStats failed (%ld %ld)", 
+        stats._nbNode, stats._nbLbl);
+      PBErrCatch(JSONErr);
+    }
+    if (arena == NULL)
+      JSONFree(&json);
+    else
+      JSONArenaFree(&arena);
+  }
+  // The values of an array of labels are copied once by 
+  // JSONArrayLblAdd then moved by JSONAddPropArrMove, where JSONAddProp 
+  // copies the values of an array of values again
+  char* vals[3] = {"x", "y", "z"};
+  JSONNode* jsonCopy = JSONCreate();
+  JSONNode* jsonMove = JSONCreate();
+  JSONArrayVal setVal = JSONArrayValCreateStatic();
+  JSONArrayLbl set = JSONArrayLblCreateStatic();
+  for (int i = 0; i < 3; ++i) {
+    JSONArrayValAdd(&setVal, vals[i]);
+    JSONArrayLblAdd(&set, vals[i]);
+  }
+  JSONStatsReset();
+  JSONAddProp(jsonCopy, "a", &setVal);
+  JSONStats statsCopy = JSONStatsGet();
+  JSONStatsReset();
+  JSONAddPropArrMove(jsonMove, "a", &set);
+  JSONStats statsMove = JSONStatsGet();
+  // The array of values still accepts strings allocated by the user
+  GSetAppend(&setVal, strdup("w"));
+  JSONArrayValFlush(&setVal);
+  if (statsCopy._nbNode != 4 || statsCopy._nbLbl != 4 || 
+    statsMove._nbNode != 4 || statsMove._nbLbl != 1 || 
+    GSetNbElem(&(set._set)) != 0 || GSetNbElem(&setVal) != 0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONAddPropArrMove failed");
+    PBErrCatch(JSONErr);
+  }
+  char* bufCopy = JSONSaveToBuffer(jsonCopy, NULL, NULL, true);
+  char* bufMove = JSONSaveToBuffer(jsonMove, NULL, NULL, true);
+  if (strcmp(bufCopy, "{\"a\":[\"x\",\"y\",\"z\"]}\n") != 0 || 
+    strcmp(bufCopy, bufMove) != 0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONAddPropArrMove failed");
+    PBErrCatch(JSONErr);
+  }
+  free(bufCopy);
+  free(bufMove);
+  // An empty array is moved as JSONAddProp adds it, and the values are 
+  // copied into a JSON in an arena
+  JSONAddPropArrMove(jsonMove, "b", &set);
+  JSONArena* arena = JSONArenaCreate();
+  JSONNode* jsonArena = JSONCreateInArena(arena);
+  JSONArrayLblAdd(&set, vals[0]);
+  JSONArrayLblAdd(&set, vals[1]);
+  JSONAddPropArrMove(jsonArena, "c", &set);
+  bufMove = JSONSaveToBuffer(jsonMove, NULL, NULL, true);
+  char* bufArena = JSONSaveToBuffer(jsonArena, NULL, NULL, true);
+  if (strcmp(bufMove, "{\"a\":[\"x\",\"y\",\"z\"],\"b\":\"\"}\n") != 0 || 
+    strcmp(bufArena, "{\"c\":[\"x\",\"y\"]}\n") != 0 || 
+    GSetNbElem(&(set._set)) != 0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONAddPropArrMove failed");
+    PBErrCatch(JSONErr);
+  }
+  // An array of labels not moved is freed by JSONArrayLblFlush
+  JSONArrayLblAdd(&set, vals[2]);
+  JSONArrayLblFlush(&set);
+  free(bufMove);
+  free(bufArena);
+  JSONArenaFree(&arena);
+  JSONFree(&jsonCopy);
+  JSONFree(&jsonMove);
+  printf("UnitTestJSONAllocCount OK\n");
+}
+
+void UnitTestJSONStats() {
+  // Load, save and free a JSON with the timing enabled
+  const char* str = "{\"a\":{\"b\":[1,2]},\"c\":\"x\"}";
+  JSONStatsReset();
+  JSONStatsSetTiming(true);
+  JSONNode* json = JSONCreate();
+  bool ret = JSONLoadFromStr(json, str);
+  size_t len = 0;
+  char* buf = JSONSaveToBuffer(json, NULL, &len, true);
+  JSONFree(&json);
+  JSONStats stats = JSONStatsGet();
+  if (!ret || !JSONStatsGetTiming() || stats._nbLoad != 1 || 
+    stats._nbSave != 1 || stats._nbFree != 1 || 
+    stats._nbByteRead != (long)strlen(str) || 
+    stats._nbByteWritten != (long)len || stats._depthMax != 3 || 
+    stats._nbNode != 6 || stats._timeLoad <= 0.0 || 
+    stats._timeSave <= 0.0 || stats._timeFree <= 0.0 || 
+    stats._timeRead != 0.0 || stats._timeWrite != 0.0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONStats failed");
+    PBErrCatch(JSONErr);
+  }
+  free(buf);
+  // The statistics cumulate over the calls, the streams are timed 
+  // separately. The new line ending the saved JSON isn't consumed
+  FILE* fd = tmpfile();
+  json = JSONCreate();
+  ret = JSONLoadFromStr(json, str) && JSONSave(json, fd, true);
+  JSONFree(&json);
+  rewind(fd);
+  json = JSONCreate();
+  ret = ret && JSONLoad(json, fd);
+  JSONFree(&json);
+  fclose(fd);
+  JSONStats statsCumul = JSONStatsGet();
+  if (!ret || statsCumul._nbLoad != 3 || statsCumul._nbSave != 2 || 
+    statsCumul._nbFree != 3 || 
+    statsCumul._nbByteRead != 3 * stats._nbByteRead || 
+    statsCumul._nbByteWritten != 2 * (long)len || 
+    statsCumul._timeRead <= 0.0 || statsCumul._timeWrite <= 0.0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONStats failed");
+    PBErrCatch(JSONErr);
+  }
+  // Without timing the counters are still updated
+  JSONStatsSetTiming(false);
+  JSONStatsReset();
+  json = JSONCreate();
+  ret = JSONLoadFromStr(json, str);
+  JSONFree(&json);
+  stats = JSONStatsGet();
+  if (!ret || JSONStatsGetTiming() || stats._nbLoad != 1 || 
+    stats._depthMax != 3 || stats._timeLoad != 0.0 || 
+    stats._timeFree != 0.0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONStats failed");
+    PBErrCatch(JSONErr);
+  }
+  // The statistics can be exported as a JSON
+  fd = tmpfile();
+  ret = JSONStatsSave(&statsCumul, fd, false);
+  rewind(fd);
+  json = JSONCreate();
+  ret = ret && JSONLoad(json, fd);
+  fclose(fd);
+  if (!ret || JSONIntVal(JSONProperty(json, "nbLoad")) != 3 || 
+    JSONIntVal(JSONProperty(json, "nbByteWritten")) != 2 * (long)len || 
+    JSONRealVal(JSONProperty(json, "timeLoad")) <= 0.0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONStatsSave failed");
+    PBErrCatch(JSONErr);
+  }
+  JSONFree(&json);
+  // The statistics of the threads of the parallel loadings are added to
+  // the ones of the calling thread, with its timing flag
+  JSONNode* jsons[4];
+  const char* bufs[4];
+  size_t lens[4];
+  for (int i = 0; i < 4; ++i) {
+    jsons[i] = JSONCreate();
+    bufs[i] = str;
+    lens[i] = strlen(str);
+  }
+  JSONStatsSetTiming(true);
+  JSONStatsReset();
+  ret = JSONLoadBuffersParallel(jsons, bufs, lens, 4, 2, NULL);
+  stats = JSONStatsGet();
+  for (int i = 0; i < 4; ++i)
+    JSONFree(jsons + i);
+  if (!ret || stats._nbLoad != 4 || stats._nbNode != 4 * 6 || 
+    stats._nbByteRead != 4 * (long)strlen(str) || 
+    stats._depthMax != 3 || stats._timeLoad <= 0.0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONLoadBuffersParallel failed");
+    PBErrCatch(JSONErr);
+  }
+  const char* bufRecords = "{\"v\":\"1\"}\n{\"v\":\"2\"}\n{\"v\":\"3\"}\n";
+  long sums[4] = {0};
+  JSONStatsReset();
+  ret = JSONRecordsParallel(bufRecords, strlen(bufRecords), 4, 
+    UnitTestJSONParallelSum, sums);
+  stats = JSONStatsGet();
+  JSONStatsSetTiming(false);
+  if (!ret || stats._nbByteRead != (long)strlen(bufRecords) || 
+    stats._depthMax != 1 || stats._nbNode == 0) {
+    JSONErr->_type = PBErrTypeUnitTestFailed;
+    sprintf(JSONErr->_msg, "JSONRecordsParallel failed");
+    PBErrCatch(JSONErr);
+  }
+  printf("UnitTestJSONStats OK\n");
+}
+
 void UnitTestJSON() {
   UnitTestJSONCreateFree();
   UnitTestJSONSetGet();
   UnitTestJSONLoadSave();
+  UnitTestJSONLoadFromBuffer();
+  UnitTestJSONArena();
+  UnitTestJSONLongLabel();
+  UnitTestJSONPropertyIndex();
+  UnitTestJSONValueIndex();
+  UnitTestJSONParse();
+  UnitTestJSONFeed();
+  UnitTestJSONRecords();
+  UnitTestJSONParallel();
+  UnitTestJSONSaveWriter();
+  UnitTestJSONSaveToBuffer();
+  UnitTestJSONCache();
+  UnitTestJSONTyped();
+  UnitTestJSONNumber();
+  UnitTestJSONSimd();
+  UnitTestJSONEscape();
+  UnitTestJSONLoadMapped();
+  UnitTestJSONLazy();
+  UnitTestJSONPath();
+  UnitTestJSONBinary();
+  UnitTestJSONStructCodec();
+  UnitTestJSONWriter();
+  UnitTestJSONAllocCount();
+  UnitTestJSONStats();
   printf("UnitTestJSON OK\n");
 }
 
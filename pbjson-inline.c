@@ -2,6 +2,149 @@
 
 // ================ Functions implementation ====================
 
+// These functions are compiled in the user's code if BUILDMODE != 0, 
+// where the redefinition of JSONErr in pbjson.c doesn't apply, so they 
+// get the error of the calling thread with JSONGetThreadErr
+
+// Create a JSONLbl with room for a label of 'len' chars, in the arena
+// 'arena' if not NULL, else on the heap
+// The label is not initialised except for its null character
+static inline JSONLbl* JSONLblCreateIn(JSONArena* const arena, 
+  const size_t len) {
+  // Allocate memory for the JSONLbl and its label, stored right after
+  // the JSONLbl. The size is rounded to the alignment of the arena, the
+  // extra chars are kept to overwrite the label in place later
+  size_t size = sizeof(JSONLbl) + sizeof(char) * (1 + len);
+  size = (size + PBJSON_ARENAALIGN - 1) & ~((size_t)PBJSON_ARENAALIGN - 1);
+  JSONLbl* lbl = NULL;
+  if (arena != NULL)
+    lbl = JSONArenaAlloc(arena, size);
+  else
+    lbl = PBErrMalloc(JSONGetThreadErr(), size);
+  ++(JSONStatsCur._nbLbl);
+  JSONStatsCur._nbLblByte += size;
+  lbl->_arena = arena;
+  lbl->_index = NULL;
+  lbl->_cache = NULL;
+  lbl->_type = JSONTypeStr;
+  lbl->_flagBorrowed = false;
+  lbl->_lazy = NULL;
+  lbl->_lazyLen = 0;
+  lbl->_str = (char*)(lbl + 1);
+  lbl->_str[len] = '\0';
+  lbl->_size = size - sizeof(JSONLbl) - 1;
+  // Return the new JSONLbl
+  return lbl;
+}
+
+// Create a JSONLbl for the node 'that' with room for a label of 'len' 
+// chars, in the arena of 'that' if any
+// The label is not initialised except for its null character
+static inline JSONLbl* JSONLblCreate(const JSONNode* const that, 
+  const size_t len) {
+  // Get the arena of the node
+  JSONLbl* curLbl = (JSONLbl*)GenTreeData(that);
+  JSONArena* arena = (curLbl != NULL ? curLbl->_arena : NULL);
+  return JSONLblCreateIn(arena, len);
+}
+
+// Replace the JSONLbl of the node 'that' with 'lbl', keeping its index
+// and its cache
+static inline void JSONLblReplace(JSONNode* const that, 
+  JSONLbl* const lbl) {
+  JSONLbl* curLbl = (JSONLbl*)GenTreeData(that);
+  if (curLbl != NULL) {
+    // Keep the index on the subtrees, the cache and the subtrees not 
+    // loaded yet
+    lbl->_index = curLbl->_index;
+    lbl->_cache = curLbl->_cache;
+    lbl->_lazy = curLbl->_lazy;
+    lbl->_lazyLen = curLbl->_lazyLen;
+    // If the node already as a label on the heap
+    if (curLbl->_arena == NULL)
+      // Free the label
+      free(curLbl);
+  }
+  GenTreeSetData(that, (void*)lbl);
+  // The serialization of the node has changed
+  JSONCacheInvalidate(that);
+}
+
+// Invalidate the cache of the serialization of the node 'that' and of 
+// its parents
+// To be used after modifying the JSON 'that' without the functions of 
+// PBJSON
+#if BUILDMODE != 0
+static inline
+#endif
+void JSONCacheInvalidate(JSONNode* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'that' is null");
+    PBErrCatch(JSONGetThreadErr());
+  }
+#endif
+  // If no node has a cache there is nothing to do
+  if (JSONNbCache == 0)
+    return;
+  // Invalidate the caches from the node up to the root, the caches of 
+  // all the parents include the serialization of the node
+  for (JSONNode* node = that; node != NULL; node = GenTreeParent(node)) {
+    JSONLbl* lbl = (JSONLbl*)GenTreeData(node);
+    if (lbl != NULL && lbl->_cache != NULL)
+      lbl->_cache->_flagValid = false;
+  }
+}
+
+// Append the node 'val' to the subtrees of the node 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+void JSONAppendVal(JSONNode* const that, JSONNode* const val) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'that' is null");
+    PBErrCatch(JSONGetThreadErr());
+  }
+  if (val == NULL) {
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'val' is null");
+    PBErrCatch(JSONGetThreadErr());
+  }
+#endif
+  // Load the subtrees not loaded yet to append 'val' after them
+  (void)JSONGetLoaded(that);
+  GenTreeAppendSubtree(that, val);
+  // The serialization of the node has changed
+  JSONCacheInvalidate(that);
+}
+
+// Mark the hash table of the index of the parent of the node 'that', 
+// if any, as stale because the label of 'that' changes. Only this 
+// index looks up 'that' by its label
+static inline void JSONLblInvalidateParent(const JSONNode* const that) {
+  GenTree* parent = GenTreeParent(that);
+  if (parent != NULL) {
+    JSONLbl* lbl = (JSONLbl*)GenTreeData(parent);
+    if (lbl != NULL && lbl->_index != NULL)
+      lbl->_index->_flagStale = true;
+  }
+}
+
+// Replace the JSONLbl of the node 'that' with 'lbl'
+static inline void JSONLblAttach(JSONNode* const that, 
+  JSONLbl* const lbl) {
+  // If the node was already labelled, the index of its parent is not 
+  // valid anymore
+  JSONLbl* curLbl = (JSONLbl*)GenTreeData(that);
+  if (curLbl != NULL && 
+    (curLbl->_str != NULL || curLbl->_type != JSONTypeStr))
+    JSONLblInvalidateParent(that);
+  JSONLblReplace(that, lbl);
+}
+
 // Set the label of the JSON node 'that' to a copy of 'lbl'
 #if BUILDMODE != 0
 static inline
@@ -9,25 +152,306 @@ static inline
 void JSONSetLabel(JSONNode* const that, const char* const lbl) {
 #if BUILDMODE == 0
   if (that == NULL) {
-    JSONErr->_type = PBErrTypeNullPointer;
-    sprintf(JSONErr->_msg, "'that' is null");
-    PBErrCatch(JSONErr);
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'that' is null");
+    PBErrCatch(JSONGetThreadErr());
   }
   if (lbl == NULL) {
-    JSONErr->_type = PBErrTypeNullPointer;
-    sprintf(JSONErr->_msg, "'lbl' is null");
-    PBErrCatch(JSONErr);
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'lbl' is null");
+    PBErrCatch(JSONGetThreadErr());
   }
 #endif
-  // If the node already as a label
-  if (JSONLabel(that) != NULL)
-    // Free the label
-    free(JSONLabel(that));
-  // Allocate memory for the new label
-  char* str = PBErrMalloc(JSONErr, sizeof(char) * (1 + strlen(lbl)));
+  JSONSetLabelLen(that, lbl, strlen(lbl));
+}
+
+// Set the label of the JSON node 'that' to a copy of the 'len' first 
+// chars of 'lbl', which doesn't need to be null terminated
+#if BUILDMODE != 0
+static inline
+#endif
+void JSONSetLabelLen(JSONNode* const that, const char* const lbl, 
+  const size_t len) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'that' is null");
+    PBErrCatch(JSONGetThreadErr());
+  }
+  if (lbl == NULL) {
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'lbl' is null");
+    PBErrCatch(JSONGetThreadErr());
+  }
+#endif
+  // Create the new label
+  JSONLbl* newLbl = JSONLblCreate(that, len);
   // Set the label copy
-  strcpy(str, lbl);
-  GenTreeSetData(that, str);
+  memcpy(newLbl->_str, lbl, sizeof(char) * len);
+  // Replace the current label
+  JSONLblAttach(that, newLbl);
+}
+
+// Return the node 'that' after loading its subtrees if they have not 
+// been loaded yet by a lazy loading
+#if BUILDMODE != 0
+static inline
+#endif
+JSONNode* JSONGetLoaded(const JSONNode* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'that' is null");
+    PBErrCatch(JSONGetThreadErr());
+  }
+#endif
+  // Loading the subtrees doesn't change the JSON seen by the user, 
+  // hence the constness of 'that'
+  JSONLbl* lbl = (JSONLbl*)GenTreeData(that);
+  if (lbl != NULL && lbl->_lazy != NULL)
+    (void)JSONLoadLazy((JSONNode*)that);
+  return (JSONNode*)that;
+}
+
+// Return the label of the JSON node 'that', NULL if it has no label
+#if BUILDMODE != 0
+static inline
+#endif
+char* JSONGetLabel(const JSONNode* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'that' is null");
+    PBErrCatch(JSONGetThreadErr());
+  }
+#endif
+  JSONLbl* lbl = (JSONLbl*)GenTreeData(that);
+  return (lbl != NULL ? lbl->_str : NULL);
+}
+
+// Set the value of the JSON node 'that' to the value of type 'type' 
+// and payload 'val'. The node loses its label
+static inline void JSONLblSetTyped(JSONNode* const that, 
+  const JSONType type, const JSONPayload val) {
+  JSONLbl* lbl = (JSONLbl*)GenTreeData(that);
+  // If the node has no JSONLbl yet, create one, its storage is kept to
+  // overwrite a label in place later
+  if (lbl == NULL) {
+    lbl = JSONLblCreate(that, 0);
+    GenTreeSetData(that, (void*)lbl);
+  // Else, if the node was labelled, the index of its parent is not 
+  // valid anymore
+  } else if (lbl->_str != NULL) {
+    JSONLblInvalidateParent(that);
+  }
+  lbl->_str = NULL;
+  lbl->_flagBorrowed = false;
+  lbl->_type = type;
+  lbl->_val = val;
+  // The serialization of the node has changed
+  JSONCacheInvalidate(that);
+}
+
+// Return the type of the value of the JSON node 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+JSONType JSONGetType(const JSONNode* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'that' is null");
+    PBErrCatch(JSONGetThreadErr());
+  }
+#endif
+  JSONLbl* lbl = (JSONLbl*)GenTreeData(that);
+  return (lbl != NULL ? lbl->_type : JSONTypeStr);
+}
+
+// Set the value of the JSON node 'that' to the integer 'val'
+// The node loses its label
+#if BUILDMODE != 0
+static inline
+#endif
+void JSONSetInt(JSONNode* const that, const int64_t val) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'that' is null");
+    PBErrCatch(JSONGetThreadErr());
+  }
+#endif
+  JSONLblSetTyped(that, JSONTypeInt, (JSONPayload){._int = val});
+}
+
+// Set the value of the JSON node 'that' to the floating point number 
+// 'val'. The node loses its label
+#if BUILDMODE != 0
+static inline
+#endif
+void JSONSetReal(JSONNode* const that, const double val) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'that' is null");
+    PBErrCatch(JSONGetThreadErr());
+  }
+#endif
+  JSONLblSetTyped(that, JSONTypeReal, (JSONPayload){._real = val});
+}
+
+// Set the value of the JSON node 'that' to the boolean 'val'
+// The node loses its label
+#if BUILDMODE != 0
+static inline
+#endif
+void JSONSetBool(JSONNode* const that, const bool val) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'that' is null");
+    PBErrCatch(JSONGetThreadErr());
+  }
+#endif
+  JSONLblSetTyped(that, JSONTypeBool, (JSONPayload){._bool = val});
+}
+
+// Set the value of the JSON node 'that' to null
+// The node loses its label
+#if BUILDMODE != 0
+static inline
+#endif
+void JSONSetNull(JSONNode* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'that' is null");
+    PBErrCatch(JSONGetThreadErr());
+  }
+#endif
+  JSONLblSetTyped(that, JSONTypeNull, (JSONPayload){._int = 0});
+}
+
+// Convert the floating point number 'val' to an integer
+// The cast is undefined for NaN and out of range values, so NaN is 0 
+// and out of range values are clamped to INT64_MIN and INT64_MAX
+static inline int64_t JSONRealToInt(const double val) {
+  if (isnan(val))
+    return 0;
+  // 2^63 is exactly representable as a double, INT64_MAX is not
+  if (val >= 9223372036854775808.0)
+    return INT64_MAX;
+  if (val < -9223372036854775808.0)
+    return INT64_MIN;
+  return (int64_t)val;
+}
+
+// Return the value of the JSON node 'that' as an integer
+// Floating point values are truncated, NaN is 0, out of range values 
+// are clamped to INT64_MIN and INT64_MAX, booleans are 0 or 1, null is 0,
+// strings are converted from their label if it's a number
+#if BUILDMODE != 0
+static inline
+#endif
+int64_t JSONGetInt(const JSONNode* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'that' is null");
+    PBErrCatch(JSONGetThreadErr());
+  }
+#endif
+  JSONLbl* lbl = (JSONLbl*)GenTreeData(that);
+  if (lbl == NULL)
+    return 0;
+  switch (lbl->_type) {
+    case JSONTypeInt:
+      return lbl->_val._int;
+    case JSONTypeReal:
+      return JSONRealToInt(lbl->_val._real);
+    case JSONTypeBool:
+      return (lbl->_val._bool ? 1 : 0);
+    case JSONTypeNull:
+      return 0;
+    default:
+      // Labels which are not a number are 0
+      if (lbl->_str != NULL) {
+        JSONType type = JSONTypeStr;
+        JSONPayload val = {._int = 0};
+        if (JSONScanNumber(lbl->_str, strlen(lbl->_str), &type, &val))
+          return (type == JSONTypeInt ? val._int : JSONRealToInt(val._real));
+      }
+      return 0;
+  }
+}
+
+// Return the value of the JSON node 'that' as a floating point number
+// Booleans are 0.0 or 1.0, null is 0.0, strings are converted from 
+// their label if it's a number
+#if BUILDMODE != 0
+static inline
+#endif
+double JSONGetReal(const JSONNode* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'that' is null");
+    PBErrCatch(JSONGetThreadErr());
+  }
+#endif
+  JSONLbl* lbl = (JSONLbl*)GenTreeData(that);
+  if (lbl == NULL)
+    return 0.0;
+  switch (lbl->_type) {
+    case JSONTypeInt:
+      return (double)(lbl->_val._int);
+    case JSONTypeReal:
+      return lbl->_val._real;
+    case JSONTypeBool:
+      return (lbl->_val._bool ? 1.0 : 0.0);
+    case JSONTypeNull:
+      return 0.0;
+    default:
+      // Labels which are not a number are 0.0
+      if (lbl->_str != NULL) {
+        JSONType type = JSONTypeStr;
+        JSONPayload val = {._int = 0};
+        if (JSONScanNumber(lbl->_str, strlen(lbl->_str), &type, &val))
+          return (type == JSONTypeInt ? (double)(val._int) : val._real);
+      }
+      return 0.0;
+  }
+}
+
+// Return the value of the JSON node 'that' as a boolean
+// Numbers are true if not null, null is false, strings are true if 
+// their label is "true"
+#if BUILDMODE != 0
+static inline
+#endif
+bool JSONGetBool(const JSONNode* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'that' is null");
+    PBErrCatch(JSONGetThreadErr());
+  }
+#endif
+  JSONLbl* lbl = (JSONLbl*)GenTreeData(that);
+  if (lbl == NULL)
+    return false;
+  switch (lbl->_type) {
+    case JSONTypeInt:
+      return (lbl->_val._int != 0);
+    case JSONTypeReal:
+      return (lbl->_val._real != 0.0);
+    case JSONTypeBool:
+      return lbl->_val._bool;
+    case JSONTypeNull:
+      return false;
+    default:
+      return (lbl->_str != NULL && strcmp(lbl->_str, "true") == 0);
+  }
 }
 
 // Add a property to the node 'that'. The property's key is a copy of a 
@@ -39,25 +463,25 @@ void _JSONAddPropStr(JSONNode* const that, const char* const key,
   char* const val) {
 #if BUILDMODE == 0
   if (that == NULL) {
-    JSONErr->_type = PBErrTypeNullPointer;
-    sprintf(JSONErr->_msg, "'that' is null");
-    PBErrCatch(JSONErr);
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'that' is null");
+    PBErrCatch(JSONGetThreadErr());
   }
   if (key == NULL) {
-    JSONErr->_type = PBErrTypeNullPointer;
-    sprintf(JSONErr->_msg, "'key' is null");
-    PBErrCatch(JSONErr);
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'key' is null");
+    PBErrCatch(JSONGetThreadErr());
   }
   if (val == NULL) {
-    JSONErr->_type = PBErrTypeNullPointer;
-    sprintf(JSONErr->_msg, "'val' is null");
-    PBErrCatch(JSONErr);
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'val' is null");
+    PBErrCatch(JSONGetThreadErr());
   }
 #endif
   // Create a new node for the key
-  JSONNode* nodeKey = JSONCreate();
+  JSONNode* nodeKey = JSONCreateChild(that);
   // Create a new node for the val
-  JSONNode* nodeVal = JSONCreate();
+  JSONNode* nodeVal = JSONCreateChild(that);
   // Set the key and val label
   JSONSetLabel(nodeKey, key);
   JSONSetLabel(nodeVal, val);
@@ -67,6 +491,161 @@ void _JSONAddPropStr(JSONNode* const that, const char* const key,
   JSONAppendVal(that, nodeKey);
 }
 
+// Add a property to the node 'that'. The property's key is a copy of a 
+// 'key' and its value is the integer 'val'
+#if BUILDMODE != 0
+static inline
+#endif
+void _JSONAddPropInt(JSONNode* const that, const char* const key, 
+  const int64_t val) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'that' is null");
+    PBErrCatch(JSONGetThreadErr());
+  }
+  if (key == NULL) {
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'key' is null");
+    PBErrCatch(JSONGetThreadErr());
+  }
+#endif
+  // Create a new node for the key
+  JSONNode* nodeKey = JSONCreateChild(that);
+  // Create a new node for the val
+  JSONNode* nodeVal = JSONCreateChild(that);
+  // Set the key label and the val
+  JSONSetLabel(nodeKey, key);
+  JSONSetInt(nodeVal, val);
+  // Attach the val to the key
+  JSONAppendVal(nodeKey, nodeVal);
+  // Attach the new property to the node 'that'
+  JSONAppendVal(that, nodeKey);
+}
+
+// Add a property to the node 'that'. The property's key is a copy of a 
+// 'key' and its value is the unsigned integer 'val'
+// Values above INT64_MAX don't fit in an integer node and are stored as 
+// a floating point number, which may round them
+#if BUILDMODE != 0
+static inline
+#endif
+void _JSONAddPropUInt(JSONNode* const that, const char* const key, 
+  const uint64_t val) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'that' is null");
+    PBErrCatch(JSONGetThreadErr());
+  }
+  if (key == NULL) {
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'key' is null");
+    PBErrCatch(JSONGetThreadErr());
+  }
+#endif
+  // Converting to int64_t would wrap the value to a negative one
+  if (val > (uint64_t)INT64_MAX)
+    _JSONAddPropReal(that, key, (double)val);
+  else
+    _JSONAddPropInt(that, key, (int64_t)val);
+}
+
+// Add a property to the node 'that'. The property's key is a copy of a 
+// 'key' and its value is the floating point number 'val'
+#if BUILDMODE != 0
+static inline
+#endif
+void _JSONAddPropReal(JSONNode* const that, const char* const key, 
+  const double val) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'that' is null");
+    PBErrCatch(JSONGetThreadErr());
+  }
+  if (key == NULL) {
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'key' is null");
+    PBErrCatch(JSONGetThreadErr());
+  }
+#endif
+  // Create a new node for the key
+  JSONNode* nodeKey = JSONCreateChild(that);
+  // Create a new node for the val
+  JSONNode* nodeVal = JSONCreateChild(that);
+  // Set the key label and the val
+  JSONSetLabel(nodeKey, key);
+  JSONSetReal(nodeVal, val);
+  // Attach the val to the key
+  JSONAppendVal(nodeKey, nodeVal);
+  // Attach the new property to the node 'that'
+  JSONAppendVal(that, nodeKey);
+}
+
+// Add a property to the node 'that'. The property's key is a copy of a 
+// 'key' and its value is the boolean 'val'
+#if BUILDMODE != 0
+static inline
+#endif
+void _JSONAddPropBool(JSONNode* const that, const char* const key, 
+  const bool val) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'that' is null");
+    PBErrCatch(JSONGetThreadErr());
+  }
+  if (key == NULL) {
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'key' is null");
+    PBErrCatch(JSONGetThreadErr());
+  }
+#endif
+  // Create a new node for the key
+  JSONNode* nodeKey = JSONCreateChild(that);
+  // Create a new node for the val
+  JSONNode* nodeVal = JSONCreateChild(that);
+  // Set the key label and the val
+  JSONSetLabel(nodeKey, key);
+  JSONSetBool(nodeVal, val);
+  // Attach the val to the key
+  JSONAppendVal(nodeKey, nodeVal);
+  // Attach the new property to the node 'that'
+  JSONAppendVal(that, nodeKey);
+}
+
+// Add a property to the node 'that'. The property's key is a copy of a 
+// 'key' and its value is null
+#if BUILDMODE != 0
+static inline
+#endif
+void JSONAddPropNull(JSONNode* const that, const char* const key) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'that' is null");
+    PBErrCatch(JSONGetThreadErr());
+  }
+  if (key == NULL) {
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'key' is null");
+    PBErrCatch(JSONGetThreadErr());
+  }
+#endif
+  // Create a new node for the key
+  JSONNode* nodeKey = JSONCreateChild(that);
+  // Create a new node for the val
+  JSONNode* nodeVal = JSONCreateChild(that);
+  // Set the key label and the val
+  JSONSetLabel(nodeKey, key);
+  JSONSetNull(nodeVal);
+  // Attach the val to the key
+  JSONAppendVal(nodeKey, nodeVal);
+  // Attach the new property to the node 'that'
+  JSONAppendVal(that, nodeKey);
+}
+
 // Add a property to the node 'that'. The property's key is a copy of a 
 // 'key' and its value is the JSON node 'val'
 #if BUILDMODE != 0
@@ -76,19 +655,19 @@ void _JSONAddPropObj(JSONNode* const that, const char* const key,
   JSONNode* const val) {
 #if BUILDMODE == 0
   if (that == NULL) {
-    JSONErr->_type = PBErrTypeNullPointer;
-    sprintf(JSONErr->_msg, "'that' is null");
-    PBErrCatch(JSONErr);
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'that' is null");
+    PBErrCatch(JSONGetThreadErr());
   }
   if (key == NULL) {
-    JSONErr->_type = PBErrTypeNullPointer;
-    sprintf(JSONErr->_msg, "'key' is null");
-    PBErrCatch(JSONErr);
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'key' is null");
+    PBErrCatch(JSONGetThreadErr());
   }
   if (val == NULL) {
-    JSONErr->_type = PBErrTypeNullPointer;
-    sprintf(JSONErr->_msg, "'val' is null");
-    PBErrCatch(JSONErr);
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'val' is null");
+    PBErrCatch(JSONGetThreadErr());
   }
 #endif
   // Set the key label for the node value
@@ -104,18 +683,19 @@ static inline
 void JSONArrayValAdd(JSONArrayVal* const that, const char* const val) {
 #if BUILDMODE == 0
   if (that == NULL) {
-    JSONErr->_type = PBErrTypeNullPointer;
-    sprintf(JSONErr->_msg, "'that' is null");
-    PBErrCatch(JSONErr);
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'that' is null");
+    PBErrCatch(JSONGetThreadErr());
   }
   if (val == NULL) {
-    JSONErr->_type = PBErrTypeNullPointer;
-    sprintf(JSONErr->_msg, "'val' is null");
-    PBErrCatch(JSONErr);
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'val' is null");
+    PBErrCatch(JSONGetThreadErr());
   }
 #endif
   // Create a copy of the value
-  char* lbl = PBErrMalloc(JSONErr, sizeof(char) * (1 + strlen(val)));
+  char* lbl = 
+    PBErrMalloc(JSONGetThreadErr(), sizeof(char) * (1 + strlen(val)));
   strcpy(lbl, val);
   // Add the copy to the set
   GSetAppend(that, lbl);
@@ -128,9 +708,9 @@ static inline
 void JSONArrayValFlush(JSONArrayVal* const that) {
 #if BUILDMODE == 0
   if (that == NULL) {
-    JSONErr->_type = PBErrTypeNullPointer;
-    sprintf(JSONErr->_msg, "'that' is null");
-    PBErrCatch(JSONErr);
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'that' is null");
+    PBErrCatch(JSONGetThreadErr());
   }
 #endif
   // Free the memory used by the values
@@ -139,3 +719,81 @@ void JSONArrayValFlush(JSONArrayVal* const that) {
     free(val);
   }
 }
+
+// Add a copy of the value 'val' to the array of labels 'that'
+// The copy is stored as a label ready to be moved into a node by 
+// JSONAddPropArrMove
+#if BUILDMODE != 0
+static inline
+#endif
+void JSONArrayLblAdd(JSONArrayLbl* const that, const char* const val) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'that' is null");
+    PBErrCatch(JSONGetThreadErr());
+  }
+  if (val == NULL) {
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'val' is null");
+    PBErrCatch(JSONGetThreadErr());
+  }
+#endif
+  // Create a copy of the value in a JSONLbl on the heap, so that it 
+  // can be moved as is into a node
+  size_t len = strlen(val);
+  JSONLbl* lbl = JSONLblCreateIn(NULL, len);
+  memcpy(lbl->_str, val, sizeof(char) * len);
+  // Add the copy to the set
+  GSetAppend(&(that->_set), lbl);
+}
+
+// Free memory used by the static array of labels 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+void JSONArrayLblFlush(JSONArrayLbl* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'that' is null");
+    PBErrCatch(JSONGetThreadErr());
+  }
+#endif
+  // Free the memory used by the values
+  while (GSetNbElem(&(that->_set)) > 0) {
+    JSONLbl* lbl = GSetPop(&(that->_set));
+    free(lbl);
+  }
+}
+
+// Return the number of records read by the reader 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+long JSONRecordsGetNb(const JSONRecords* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'that' is null");
+    PBErrCatch(JSONGetThreadErr());
+  }
+#endif
+  return that->_nbRecord;
+}
+
+// Return true if the reader of records 'that' has met an invalid 
+// record, false else
+#if BUILDMODE != 0
+static inline
+#endif
+bool JSONRecordsIsError(const JSONRecords* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONGetThreadErr()->_type = PBErrTypeNullPointer;
+    sprintf(JSONGetThreadErr()->_msg, "'that' is null");
+    PBErrCatch(JSONGetThreadErr());
+  }
+#endif
+  return that->_flagError;
+}
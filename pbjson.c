@@ -2,75 +2,978 @@
 
 // ================= Include =================
 
+#include <pthread.h>
+#include <locale.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PBJSON_X86
+#include <immintrin.h>
+#endif
 #include "pbjson.h"
 #if BUILDMODE == 0
 #include "pbjson-inline.c"
 #endif
 
+// ================ Global variables ====================
+
+// Number of nodes whose serialization is cached
+_Atomic long JSONNbCache = 0;
+
+// Statistics of the current thread
+_Thread_local JSONStats JSONStatsCur = {0};
+
+// Flag to memorize if the timing of the phases is enabled in the 
+// current thread
+static _Thread_local bool JSONStatsFlagTiming = false;
+
+// Error used by the JSON functions of the current thread instead of the
+// global JSONErr, if not NULL
+static _Thread_local PBErr* JSONThreadErr = NULL;
+
+// All the functions below report their errors in the error of the 
+// current thread
+#define JSONErr (JSONThreadErr != NULL ? JSONThreadErr : JSONErr)
+
 // ================ Functions implementation ====================
 
-// Save recursively the JSON tree 'that' into the stream 'stream'
+// Save recursively the JSON tree 'that' into the writer 'writer'
 // Return true if it could save, false else
-bool JSONSaveRec(const JSONNode* const that, FILE* const stream, 
+bool JSONSaveRec(const JSONNode* const that, JSONWriter* const writer, 
   const bool compact, int depth);
 
+// Save recursively the JSON tree 'that' into the writer 'writer', 
+// without using the cache of 'that'
+// Return true if it could save, false else
+static bool JSONSaveRecNode(const JSONNode* const that, 
+  JSONWriter* const writer, const bool compact, int depth);
+
+// Initialise the writer 'that' on the stream 'stream' with the block
+// 'buf' of 'size' bytes
+// If 'stream' is null and 'flagGrow' is true the output is kept in 
+// 'buf' which grows as needed, if 'stream' is null and 'flagGrow' is 
+// false the output is only counted
+static inline void JSONWriterInit(JSONWriter* const that, 
+  FILE* const stream, char* const buf, const size_t size, 
+  const bool flagGrow);
+
+// Flush the block of the writer 'that' to make room for 'len' more 
+// bytes: write it on the stream, or grow it, or discard it if the 
+// output is only counted
+// Return false if there has been an I/O error or the buffer of fixed 
+// size is full
+static bool JSONWriterFlush(JSONWriter* const that, const size_t len);
+
+// Return the number of bytes written by the writer 'that'
+static inline size_t JSONWriterGetNb(const JSONWriter* const that);
+
+// Return true if the writer 'that' only counts the bytes
+static inline bool JSONWriterIsCounting(const JSONWriter* const that);
+
+// Give back the unused bytes of the buffer of the writer 'that' growing
+// in memory
+static inline void JSONWriterShrink(JSONWriter* const that);
+
+// Append the 'len' chars of 'str' to the writer 'that'
+// Return false if there has been an I/O error
+static inline bool JSONWriterAppend(JSONWriter* const that, 
+  const char* const str, const size_t len);
+
+// Append the char 'c' to the writer 'that'
+// Return false if there has been an I/O error
+static inline bool JSONWriterAppendChar(JSONWriter* const that, 
+  const char c);
+
+// Return the product of 'x' by 'y', rounded to 64 bits of mantissa
+static inline JSONDiyFp JSONDiyFpMul(const JSONDiyFp x, 
+  const JSONDiyFp y);
+
+// Return 'x' shifted until the highest bit of its mantissa is set
+static inline JSONDiyFp JSONDiyFpNormalize(JSONDiyFp x);
+
+// Write in 'digits' the shortest sequence of digits 'digits'*10^'*exp' 
+// which converts back to the strictly positive double 'val', and set 
+// '*nbDigit' to the number of digits (Grisu2 algorithm)
+static void JSONGrisu2(const double val, char* const digits, 
+  int* const nbDigit, int* const exp);
+
+// Generate the digits of the number 'high' shifted by 'exp', within 
+// 'delta' of it and closest to 'high' minus 'dist' 
+static void JSONGrisu2Digits(const JSONDiyFp high, const uint64_t dist, 
+  uint64_t delta, char* const digits, int* const nbDigit, 
+  int* const exp);
+
+// Format the 'nbDigit' chars of 'digits' which represent the number 
+// 'digits'*10^'exp' in decimal or exponential notation, in place
+// 'digits' must have room for PBJSON_SCALARSIZE chars
+// Return the number of chars of the result
+static size_t JSONFormatDigits(char* const digits, const int nbDigit, 
+  const int exp);
+
+// Convert the null terminated string 'str' to a double with the C 
+// locale, whatever the locale of the application
+static double JSONStrToRealC(const char* const str);
+
+// Append the value of the node 'node' to the writer 'that', as a 
+// double quoted string or as a native JSON number, boolean or null
+// Return false if there has been an I/O error
+static bool JSONWriterAppendVal(JSONWriter* const that, 
+  const JSONNode* const node);
+
 // Return true if the JSON node 'that' is a value (ie its subtree is 
 // empty)
 static inline bool JSONIsValue(JSONNode* const that);
 
-// Scan the 'stream' char by char until the next significant char
-// ie anything else than a space or a new line or a tab and store the 
-// result in 'c'
+// Release the subtrees of the node 'that' allocated in an arena
+// Subtrees allocated on the heap are freed
+static void JSONFreeArenaRec(JSONNode* const that);
+
+// Free the memory used by the JSONLbl 'that', its index and its cache
+static inline void JSONLblFree(JSONLbl* const that);
+
+// Free the memory used by the index 'that'
+static void JSONIndexFree(JSONIndex** that);
+
+// Free the memory used by the cache 'that'
+static void JSONCacheFree(JSONCache** that);
+
+// Return the JSONLbl of the node 'that', creating one without label if
+// the node has none yet
+static JSONLbl* JSONGetLbl(JSONNode* const that);
+
+// Return the index on the subtrees of the node 'that', creating it or 
+// updating its array of subtrees if necessary
+static JSONIndex* JSONGetIndex(JSONNode* const that);
+
+// Update the hash table of the index 'that'
+static void JSONIndexHashNodes(JSONIndex* const that);
+
+// Empty the hash table of the index of the node 'that', if any
+// If 'flagNodes' is true, empty its array of subtrees too
+static void JSONIndexInvalidate(JSONNode* const that, 
+  const bool flagNodes);
+
+// Return the hash of the label 'lbl', skipping the eventual '[]'
+static inline size_t JSONIndexHash(const char* lbl);
+
+// Create a new JSON node in the arena 'that', without label
+static JSONNode* JSONArenaCreateNode(JSONArena* const that);
+
+// Initialise the reader 'that' on the stream 'stream'
+static void JSONReaderInitStream(JSONReader* const that, 
+  FILE* const stream);
+
+// Initialise the reader 'that' on the 'len' bytes of the buffer 'buf'
+static void JSONReaderInitBuffer(JSONReader* const that, 
+  const char* const buf, const size_t len);
+
+// Read the next block of bytes from the stream of the reader 'that'
+// Return false if there is no more byte available
+static bool JSONReaderFill(JSONReader* const that);
+
+// Give back to the stream of the reader 'that' the bytes which have 
+// been read in advance but not consumed
+static void JSONReaderRelease(JSONReader* const that);
+
+// Return true if the char 'c' is insignificant between the tokens of a
+// JSON (space, new line, tab or comma)
+static inline bool JSONIsSpace(const char c);
+
+// Return the position of the first significant char of the 'len' bytes
+// of 'buf' from the position 'pos', 'len' if there is none
+static size_t JSONScanSpaceScalar(const char* const buf, size_t pos, 
+  const size_t len);
+
+// Return the position of the first double quote or backslash of the 
+// 'len' bytes of 'buf' from the position 'pos', 'len' if there is none
+static size_t JSONScanQuoteScalar(const char* const buf, size_t pos, 
+  const size_t len);
+
+// Return the position of the first char of the 'len' bytes of 'buf' 
+// from the position 'pos' which must be escaped in a JSON string 
+// (double quote, backslash or control char), 'len' if there is none
+static size_t JSONScanEscapeScalar(const char* const buf, size_t pos, 
+  const size_t len);
+
+#ifdef PBJSON_X86
+// Vectorized versions of JSONScanSpaceScalar, JSONScanQuoteScalar and 
+// JSONScanEscapeScalar, 16 bytes at a time with SSE2 and 32 bytes at a 
+// time with AVX2
+__attribute__((target("sse2")))
+static size_t JSONScanSpaceSSE2(const char* const buf, size_t pos, 
+  const size_t len);
+__attribute__((target("sse2")))
+static size_t JSONScanQuoteSSE2(const char* const buf, size_t pos, 
+  const size_t len);
+__attribute__((target("sse2")))
+static size_t JSONScanEscapeSSE2(const char* const buf, size_t pos, 
+  const size_t len);
+__attribute__((target("avx2")))
+static size_t JSONScanEscapeAVX2(const char* const buf, size_t pos, 
+  const size_t len);
+__attribute__((target("avx2")))
+static size_t JSONScanSpaceAVX2(const char* const buf, size_t pos, 
+  const size_t len);
+__attribute__((target("avx2")))
+static size_t JSONScanQuoteAVX2(const char* const buf, size_t pos, 
+  const size_t len);
+#endif
+
+// Reserve room in the growable string 'that' for 'len' more chars
+static void JSONStrBufReserve(JSONStrBuf* const that, const size_t len);
+
+// Decode the escape sequences of the 'len' chars of 'src', the content 
+// of a JSON string, into 'dst' and set '*lenDst' to the number of 
+// decoded chars. The runs of chars without escape sequence are copied 
+// at once. '\uXXXX' sequences are converted to UTF-8, lone surrogates 
+// to U+FFFD. '\u0000' is rejected, it would truncate the null 
+// terminated label. The decoded string is never longer than 'src', and 
+// 'dst' can be equal to 'src'
+// Return false and set JSONErr if there is an invalid escape sequence
+static bool JSONUnescape(char* const dst, const char* const src, 
+  const size_t len, size_t* const lenDst);
+
+// Read the 4 hexadecimal digits at the beginning of the 'len' chars of 
+// 'str' into '*code'
+// Return false if they are not 4 hexadecimal digits
+static bool JSONReadHex4(const char* const str, const size_t len, 
+  uint32_t* const code);
+
+// Set the error for an invalid escape sequence
+// Return false
+static bool JSONUnescapeInvalid(void);
+
+// Append the 'len' chars of 'str' to the writer 'that', escaping the 
+// double quotes, backslashes and control chars. The runs of chars 
+// which don't need to be escaped are appended at once
+// Return false if there has been an I/O error
+static bool JSONWriterAppendEscaped(JSONWriter* const that, 
+  const char* const str, const size_t len);
+
+// Return the best instruction set supported by the processor to scan 
+// the JSONs
+static JSONSimd JSONSimdGetBest(void);
+
+// Select the scan kernels for the instruction set 'simd'
+static void JSONSimdUse(const JSONSimd simd);
+
+// Select the scan kernels for the best instruction set supported by the
+// processor
+static void JSONSimdInit(void);
+
+// Get the next char from the reader 'reader' and store it in 'c'
+// Return false if there is no more char available
+static inline bool JSONReaderGetChar(JSONReader* const reader, 
+  char* const c);
+
+// Scan the 'reader' until the next significant char ie anything else 
+// than a space or a new line or a tab or a comma, skipping runs of 
+// insignificant chars with JSONScanSpace, and store the result in 'c'
 // Return false if there has been an I/O error
-static inline bool JSONGetNextChar(FILE* stream, char* c);
+static inline bool JSONGetNextChar(JSONReader* const reader, 
+  char* const c);
+
+// Load the JSON 'that' from the reader 'reader'
+// Return true if it could load, false else
+bool JSONLoadFromReader(JSONNode* const that, JSONReader* const reader);
+
+// Load a struct in the JSON 'that' from the reader 'reader'
+// Return true if it could load, false else
+bool JSONLoadStruct(JSONNode* const that, JSONReader* const reader);
+
+// Load an array with key 'key' as the next child of the cursor 
+// 'cursor' from the reader 'reader'
+// Return true if it could load, false else
+bool JSONLoadArr(JSONLoadCursor* const cursor, JSONReader* const reader, 
+  const char* const key, const size_t lenKey);
+
+// Load a string from the 'reader', up to its closing double quote, and 
+// decode its escape sequences
+// On success '*str' points to the '*len' chars of the string, which 
+// are not null terminated and stay valid until the next read on the 
+// reader
+// Return false if there has been an I/O error or an invalid escape 
+// sequence
+bool JSONLoadStr(JSONReader* const reader, const char** const str, 
+  size_t* const len);
+
+// Load a number, a boolean or null from the 'reader', 'first' being 
+// its first char already consumed. On success '*type' and '*val' are 
+// set to its type and native value
+// Return false if it's not a valid value
+static bool JSONLoadScalar(JSONReader* const reader, const char first,
+  JSONType* const type, JSONPayload* const val);
 
-// Load a struct in the JSON 'that' from the stream 'stream'
+// Read the chars of a number, a boolean or null from the 'reader', 
+// 'first' being its first char already consumed, into the 'tok' null 
+// terminated string of PBJSON_SCALARSIZE chars, and set '*len' to its 
+// length
+// Return false if the value is too long
+static bool JSONReadScalar(JSONReader* const reader, const char first,
+  char* const tok, size_t* const len);
+
+// Convert the 'len' chars of the null terminated string 'tok' to a 
+// number, a boolean or null. On success '*type' and '*val' are set to 
+// its type and native value
+// Return false if it's not a valid value
+static bool JSONScanScalar(const char* const tok, const size_t len,
+  JSONType* const type, JSONPayload* const val);
+
+// Return true if the char 'c' can start a number, a boolean or null
+static inline bool JSONIsScalarStart(const char c);
+
+// Return true if the char 'c' can be part of a number, a boolean or 
+// null
+static inline bool JSONIsScalarChar(const char c);
+
+// Load the array of values of property 'prop' as the next child of the
+// cursor 'cursor', 'c' being the first char of the first value already
+// consumed
+// Return true if it could load, false else
+bool JSONAddArr(JSONLoadCursor* const cursor, const char* const prop, 
+  const size_t lenProp, JSONReader* const reader, char c);
+
+// Load the array of structs of property 'prop' as the next child of 
+// the cursor 'cursor'
+// Return true if it could load, false else
+bool JSONAddArrStruct(JSONLoadCursor* const cursor, 
+  const char* const prop, const size_t lenProp, 
+  JSONReader* const reader);
+
+// Load the values of an array as the children of the node 'that', 'c' 
+// being the first char of the first value already consumed
 // Return true if it could load, false else
-bool JSONLoadStruct(JSONNode* const that, FILE* stream);
+static bool JSONLoadArrVal(JSONNode* const that, 
+  JSONReader* const reader, char c);
 
-// Load an array in the JSON 'that' from the stream 'stream'
+// Return the 'len' chars of 'str', read from the 'reader', in a form 
+// which stays valid while reading further: 'str' itself if the reader 
+// is on a buffer and 'str' lies in it, as the buffer is never 
+// overwritten, else a copy in 'buf'
+static const char* JSONLoadKeepStr(const JSONReader* const reader, 
+  JSONStrBuf* const buf, const char* const str, const size_t len);
+
+// Load the value of the property of key 'keyProp' as the next child of
+// the cursor 'cursor' from the reader 'reader', the key being already
+// consumed
+// Return true if it could load, false else
+static bool JSONLoadPropVal(JSONLoadCursor* const cursor, 
+  JSONReader* const reader, const char* const keyProp, 
+  const size_t lenKey);
+
+// Load the structs of an array as the children of the node 'that', 
+// the opening '{' of the first struct being already consumed
 // Return true if it could load, false else
-bool JSONLoadArr(JSONNode* const that, FILE* stream, char* key);
+static bool JSONLoadArrStruct(JSONNode* const that, 
+  JSONReader* const reader);
 
-// Load the string 'str' from the 'stream'
+// Append the LEB128 varint encoding of 'val' to the writer 'that'
 // Return false if there has been an I/O error
-bool JSONLoadStr(FILE* stream, char* str);
+static inline bool JSONWriterAppendVarint(JSONWriter* const that, 
+  uint64_t val);
+
+// Save recursively the node 'that' in the binary encoding into the 
+// writer 'writer'
+// Return true if it could save, false else
+static bool JSONSaveBinaryRec(const JSONNode* const that, 
+  JSONWriter* const writer);
+
+// Save the JSON 'that' in the binary encoding into the writer 'writer'
+// Return true if it could save, false else
+static bool JSONSaveBinaryToWriter(const JSONNode* const that, 
+  JSONWriter* const writer);
+
+// Get the 'len' next bytes from the reader 'reader', '*bytes' points 
+// to them on success and stays valid until the next read on the reader
+// Return false if there are not enough bytes available
+static bool JSONReaderGetBytes(JSONReader* const reader, 
+  const size_t len, const char** const bytes);
+
+// Get the LEB128 varint from the reader 'reader' into '*val'
+// Return false if there is no valid varint
+static bool JSONReaderGetVarint(JSONReader* const reader, 
+  uint64_t* const val);
+
+// Load 'nb' nodes in the binary encoding from the reader 'reader' as 
+// the next children of the cursor 'cursor', with their subtrees
+// Return true if it could load, false else
+static bool JSONLoadBinaryRec(JSONLoadCursor* const cursor, 
+  JSONReader* const reader, const uint64_t nb);
+
+// Load the JSON 'that' from the binary encoding in the reader 'reader'
+// Return true if it could load, false else
+static bool JSONLoadBinaryFromReader(JSONNode* const that, 
+  JSONReader* const reader);
+
+// Return the size in bytes of one element of the field 'field'
+static inline size_t JSONStructFieldElemSize(
+  const JSONStructField* const field);
+
+// Save the element at 'ptr' of the field 'field' into the writer 
+// 'writer', the field being at depth 'depth'
+// Return true if it could save, false else
+static bool JSONStructSaveElem(const char* const ptr, 
+  const JSONStructField* const field, JSONWriter* const writer, 
+  const bool compact, const int depth);
+
+// Save the struct 'data' described by 'desc' into the writer 'writer',
+// as an object at depth 'depth'
+// Return true if it could save, false else
+static bool JSONStructSaveRec(const char* const data, 
+  const JSONStructDesc* const desc, JSONWriter* const writer, 
+  const bool compact, const int depth);
+
+// Set the error for the invalid value of the field 'field' read from 
+// the reader 'reader'
+static void JSONStructSetErrVal(const JSONReader* const reader, 
+  const JSONStructField* const field);
+
+// Load the element at 'ptr' of the field 'field' from the value 
+// starting with the char 'c', already consumed, from the reader 
+// 'reader'. If 'flagEmpty' is true an empty string is accepted and 
+// leaves the element unchanged
+// Return true if it could load, false else
+static bool JSONStructLoadElem(char* const ptr, 
+  const JSONStructField* const field, JSONReader* const reader, 
+  const char c, const bool flagEmpty);
+
+// Load the field 'field' of the struct 'data' from the value starting 
+// with the char 'c', already consumed, from the reader 'reader'
+// Return true if it could load, false else
+static bool JSONStructLoadField(char* const data, 
+  const JSONStructField* const field, JSONReader* const reader, char c);
+
+// Load the struct 'data' described by 'desc' from the object whose 
+// opening char has been consumed from the reader 'reader'
+// Return true if it could load, false else
+static bool JSONStructLoadRec(char* const data, 
+  const JSONStructDesc* const desc, JSONReader* const reader);
 
-// Load the array of values of property 'prop' in the JSON 'that' 
+// Load the C struct 'data' described by 'desc' from the reader 'reader'
 // Return true if it could load, false else
-bool JSONAddArr(JSONNode* const that, char* prop, FILE* stream);
+static bool JSONStructLoadFromReader(void* const data, 
+  const JSONStructDesc* const desc, JSONReader* const reader);
+
+// Set the error for the call of the streaming writer function 'fun' 
+// while the writer is in a state where it's not allowed
+static void JSONWriterSetErrState(const char* const fun);
+
+// Write the separator before the next value of the writer 'that', 
+// 'flagNested' is true if it's an object or an array. 'fun' is the 
+// name of the calling function for the error message
+// Return false if a value can't be written there or there has been an
+// error
+static bool JSONWriterBeginVal(JSONWriter* const that, 
+  const bool flagNested, const char* const fun);
+
+// Open an object or an array, according to 'open', with the writer 
+// 'that'. 'fun' is the name of the calling function for the error 
+// message
+// Return true if it could write, false else
+static bool JSONWriterBegin(JSONWriter* const that, const char open, 
+  const char* const fun);
+
+// Close the current object or array, according to 'open', of the 
+// writer 'that'. 'fun' is the name of the calling function for the 
+// error message
+// Return true if it could write, false else
+static bool JSONWriterClose(JSONWriter* const that, const char open, 
+  const char* const fun);
+
+// Return the current time in seconds if the timing of the phases is 
+// enabled in the calling thread, 0.0 else
+static inline double JSONStatsClock(void);
+
+// Add to '*time' the time elapsed since 'start', got from 
+// JSONStatsClock, if the timing was enabled at 'start'
+static inline void JSONStatsAddTime(double* const time, 
+  const double start);
+
+// Update the statistics at the end of a call to a saving function 
+// started at 'start' and which has written 'nb' bytes
+static inline void JSONStatsEndSave(const size_t nb, 
+  const double start);
 
-// Load the array of structs of property 'prop' in the JSON 'that' 
+// Add the statistics 'stats' of a worker thread to the statistics of 
+// the calling thread
+static void JSONStatsMerge(const JSONStats* const stats);
+
+// Return true if the char 'c' ends a key of a step '.key' of a path
+static inline bool JSONPathIsKeyEnd(const char c);
+
+// Parse the optional integer at the position '*pos' of the path 
+// expression 'expr' into '*val', and move '*pos' after it
+// Return true if there was an integer, false else
+static bool JSONPathParseLong(const char* const expr, size_t* const pos,
+  long* const val);
+
+// Get in '*start' and '*end' the first position and the position after
+// the last one of the values selected by the slice 'step' among 'nb' 
+// values, in [0, nb]
+static void JSONPathGetRange(const JSONPathStep* const step, 
+  const long nb, long* const start, long* const end);
+
+// Append to 'matches' the nodes selected by the steps from the 
+// 'iStep'-th one of the path 'that' among the subtrees of the node 
+// 'node', up to 'max' nodes in total if it's positive. '*nb' is the 
+// number of nodes appended so far
+static void JSONPathEvalRec(const JSONPath* const that, const long iStep, 
+  const JSONNode* const node, JSONArrayStruct* const matches, 
+  long* const nb, const long max);
+
+// Return true if the 'iVal'-th subtree of a node, with key 'key' of 
+// length 'lenKey' if it's a property (NULL else), is selected by the 
+// step 'step' of a path whose positions are not relative to the end
+static bool JSONPathSelect(const JSONPathStep* const step, 
+  const long iVal, const char* const key, const size_t lenKey);
+
+// Skip the value starting with the char 'c', already consumed, from the
+// reader 'reader'
+// Return true if it could skip, false else
+static bool JSONPathSkipVal(JSONReader* const reader, const char c);
+
+// Load the string, number, boolean or null starting with the char 'c',
+// already consumed, from the reader 'reader', as the next child of the
+// cursor 'cursor' if 'flagMatch' is true, else only consume it
 // Return true if it could load, false else
-bool JSONAddArrStruct(JSONNode* const that, char* prop, FILE* stream);
+static bool JSONPathLoadLeaf(JSONLoadCursor* const cursor, 
+  JSONReader* const reader, const char c, const bool flagMatch);
+
+// Apply the steps from the 'iStep'-th one of the path 'that' to the 
+// subtrees of the node whose value starts with the char 'c', already 
+// consumed, from the reader 'reader', and load the selected nodes as 
+// the next children of the cursor 'cursor'
+// Return true if it could parse, false else
+static bool JSONPathWalk(const JSONPath* const that, const long iStep, 
+  JSONLoadCursor* const cursor, JSONReader* const reader, char c);
+
+// Parse the JSON from the reader 'reader' and append to the node 
+// 'matches' a copy of each node selected by the compiled path 'that'
+// Return true if it could parse, false else
+static bool JSONPathLoadFromReader(const JSONPath* const that, 
+  JSONNode* const matches, JSONReader* const reader);
+
+// Skip the object or array whose opening char has just been consumed 
+// from the 'reader', up to its matching closing char, without loading
+// nor checking its content
+// On success '*first' is set to the first significant char after the 
+// opening one, and '*span' and '*len' to the bytes of the object or 
+// array. They are borrowed from the file mapped by the reader if they 
+// lie in it, else they are copied in the arena 'arena'. If 'arena' is 
+// NULL the bytes are only skipped and 'span' and 'len' are not used
+// Return false if the bytes end before the closing char
+static bool JSONLoadSkip(JSONReader* const reader, 
+  JSONArena* const arena, char** const span, size_t* const len, 
+  char* const first);
+
+// Initialise the cursor 'that' on the children of the node 'node' 
+// loaded from the reader 'reader'
+static inline void JSONLoadCursorInit(JSONLoadCursor* const that, 
+  JSONNode* const node, const JSONReader* const reader);
+
+// Return the next child of the cursor 'that'
+// If the existing children are reused, return the next existing child, 
+// else create a new child and append it to the node of the cursor
+static inline JSONNode* JSONLoadCursorNext(JSONLoadCursor* const that);
+
+// End the loading of the children of the cursor 'that'
+// If the existing children are reused, the ones which have not been 
+// reused are released
+static inline void JSONLoadCursorEnd(JSONLoadCursor* const that);
+
+// Release the children of the node 'that' after the 'nb' first ones
+static void JSONLoadTrim(JSONNode* const that, const long nb);
+
+// Set the label of the node 'that', child of the cursor 'cursor', to 
+// the 'lenPrefix' chars of 'prefix' followed by the 'len' chars of 
+// 'str'. If 'str' is NULL the node has no label.
+// If the nodes are reused the label is left unchanged if it's the 
+// same, or overwritten if its storage is large enough
+// If the cursor is on a mapped file and 'str' lies in the mapping, the
+// new label borrows its chars instead of copying them
+static void JSONLoadSetLabel(const JSONLoadCursor* const cursor, 
+  JSONNode* const that, const char* const prefix, 
+  const size_t lenPrefix, const char* const str, const size_t len);
+
+// Set the value of the node 'that', child of the cursor 'cursor', to 
+// the value of type 'type' and payload 'val'
+// If the nodes are reused the value is left unchanged if it's the same
+static void JSONLoadSetTyped(const JSONLoadCursor* const cursor, 
+  JSONNode* const that, const JSONType type, const JSONPayload val);
+
+// Initialise the growable string 'that' to the empty string
+static inline void JSONStrBufInit(JSONStrBuf* const that);
+
+// Free the memory used by the growable string 'that'
+static inline void JSONStrBufFree(JSONStrBuf* const that);
+
+// Append the 'len' chars of 'str' to the growable string 'that'
+static void JSONStrBufAppend(JSONStrBuf* const that, 
+  const char* const str, const size_t len);
+
+// Get the characters around the current position in the 'reader'
+void JSONGetContext(const JSONReader* const reader, char* buffer);
+
+// Set the error for a parsing stopped by a callback of the event 
+// handler
+// Return false
+static bool JSONParseStopped(void);
+
+// Parse a number, a boolean or null from the reader 'reader', 'first' 
+// being its first char already consumed
+// Return true if it could parse, false else
+static bool JSONParseScalar(const JSONEventHandler* const handler, 
+  JSONReader* const reader, const char first);
+
+// Parse a struct from the reader 'reader', the opening '{' has already 
+// been consumed
+// Return true if it could parse, false else
+static bool JSONParseStruct(const JSONEventHandler* const handler, 
+  JSONReader* const reader);
+
+// Parse a key/value from the reader 'reader', the opening '"' of the 
+// key has already been consumed
+// Return true if it could parse, false else
+static bool JSONParseProp(const JSONEventHandler* const handler, 
+  JSONReader* const reader);
 
-// Get the characters around the current position in the 'stream'
-void JSONGetContextStream(FILE* stream, char* buffer);
+// Parse an array from the reader 'reader', the opening '[' has already 
+// been consumed
+// Return true if it could parse, false else
+static bool JSONParseArr(const JSONEventHandler* const handler, 
+  JSONReader* const reader);
+
+// Parse the JSON from the reader 'reader'
+// Return true if it could parse, false else
+static bool JSONParseFromReader(const JSONEventHandler* const handler, 
+  JSONReader* const reader);
+
+// Thread loading the JSONs of JSONLoadBuffersParallel
+static void* JSONLoadBuffersThread(void* const arg);
+
+// Thread reading the records of JSONRecordsParallel
+static void* JSONRecordsThread(void* const arg);
+
+// Run 'nbThread' threads executing 'fun' with the arguments 'args' of 
+// 'size' bytes each, and wait for their end
+// Return false if the threads couldn't be created
+static bool JSONRunThreads(void* (*fun)(void*), void* const args, 
+  const size_t size, const int nbThread);
+
+// Push the node 'node' of type 'type' on the stack of the incremental 
+// parser 'that'
+static void JSONFeederPush(JSONFeeder* const that, JSONNode* const node, 
+  const char type);
+
+// Update the state of the incremental parser 'that' after the end of a 
+// value
+static void JSONFeederValueDone(JSONFeeder* const that);
+
+// Scan the bytes of 'buf' from '*pos' up to 'len' for the end of the 
+// string being loaded by the incremental parser 'that', and append 
+// them to its string, decoded once the string is complete
+// Return true if the closing double quote has been found, false if not 
+// or if the string has an invalid escape sequence
+static bool JSONFeederLoadStr(JSONFeeder* const that, 
+  const char* const buf, const size_t len, size_t* const pos);
+
+// Scan the bytes of 'buf' from '*pos' up to 'len' for the end of the 
+// number, boolean or null being loaded by the incremental parser 
+// 'that', and append them to its string. Once the value is complete, 
+// '*type' and '*val' are set to its type and native value
+// Return true if the value is complete, false if not or if it's not a 
+// valid value
+static bool JSONFeederLoadScalar(JSONFeeder* const that, 
+  const char* const buf, const size_t len, size_t* const pos, 
+  JSONType* const type, JSONPayload* const val);
+
+// Set the error of the incremental parser 'that' for the unexpected 
+// char at position 'pos' in the 'len' bytes of 'buf'
+// Return JSONFeedError
+static JSONFeedRet JSONFeederInvalid(JSONFeeder* const that, 
+  const char* const expected, const char* const buf, const size_t len, 
+  const size_t pos);
+
+// Instruction set of the kernels scanning the JSONs being loaded or
+// saved, the kernels, and the control of their initialisation to the
+// best instruction set supported by the processor
+static JSONSimd JSONSimdCur = JSONSimdScalar;
+static size_t (*JSONScanSpace)(const char* const, size_t, const size_t) =
+  JSONScanSpaceScalar;
+static size_t (*JSONScanQuote)(const char* const, size_t, const size_t) =
+  JSONScanQuoteScalar;
+static size_t (*JSONScanEscape)(const char* const, size_t, const size_t) =
+  JSONScanEscapeScalar;
+static pthread_once_t JSONSimdOnce = PTHREAD_ONCE_INIT;
 
 // ================ Functions implementation ====================
 
 // Free the memory used by the JSON node 'that' and its subnodes
 // The memory used by the label of each node is freed too
+// If 'that' is allocated in an arena, the nodes and labels of the arena
+// are released only when the arena is reset or freed
 void JSONFree(JSONNode** that) {
   // Check arguments
   if (that == NULL || *that == NULL)
     // Nothing to do
     return;
-  // Free all the char* in the tree
-  if (JSONLabel(*that) != NULL)
-    free(JSONLabel(*that));
+  ++(JSONStatsCur._nbFree);
+  double start = JSONStatsClock();
+  // The node is removed from its parent, whose index doesn't match its
+  // subtrees anymore and whose serialization, as the ones of its 
+  // ancestors, changes
+  JSONNode* parent = (JSONNode*)GenTreeParent(*that);
+  if (parent != NULL) {
+    JSONIndexInvalidate(parent, true);
+    JSONCacheInvalidate(parent);
+  }
+  // If the node is allocated in an arena
+  JSONLbl* lbl = (JSONLbl*)GenTreeData(*that);
+  if (lbl != NULL && lbl->_arena != NULL) {
+    // Only release the subtrees, the memory of the nodes and labels 
+    // belongs to the arena
+    JSONFreeArenaRec(*that);
+    // Detach the node from its parent, as GenTreeFree does for the 
+    // nodes on the heap
+    if (parent != NULL)
+      GSetRemoveFirst(GenTreeSubtrees(parent), *that);
+    *that = NULL;
+    JSONStatsAddTime(&(JSONStatsCur._timeFree), start);
+    return;
+  }
+  // Free all the labels in the tree. The iterator can be on its last 
+  // subtree from the start if there is only one
+  JSONLblFree(lbl);
   GenTreeIterDepth iter = GenTreeIterDepthCreateStatic((GenTreeStr*)(*that));
-  if (!GenTreeIterIsLast(&iter)) {
+  if (GSetNbElem(GenTreeSubtrees(*that)) > 0) {
     do {
-      char* label = GenTreeIterGetData(&iter);
-      free(label);
+      JSONLbl* label = (JSONLbl*)GenTreeIterGetData(&iter);
+      JSONLblFree(label);
     } while (GenTreeIterStep(&iter));
   }
   GenTreeIterFreeStatic(&iter);
   // Free memory
   GenTreeFree(that);
+  JSONStatsAddTime(&(JSONStatsCur._timeFree), start);
+}
+
+// Release the subtrees of the node 'that' allocated in an arena
+// Subtrees allocated on the heap are freed
+static void JSONFreeArenaRec(JSONNode* const that) {
+  // Free the index and the cache of the node, which are always on the
+  // heap
+  JSONIndexFree(&(((JSONLbl*)GenTreeData(that))->_index));
+  JSONCacheFree(&(((JSONLbl*)GenTreeData(that))->_cache));
+  // Loop on the subtrees, the ones not loaded yet have nothing to 
+  // release
+  while (GSetNbElem(GenTreeSubtrees(that)) > 0) {
+    // Detach the subtree
+    JSONNode* subtree = GSetPop(GenTreeSubtrees(that));
+    // If the subtree is allocated in the arena
+    JSONLbl* lbl = (JSONLbl*)GenTreeData(subtree);
+    if (lbl != NULL && lbl->_arena != NULL) {
+      // Release its own subtrees
+      JSONFreeArenaRec(subtree);
+    // Else, the subtree is on the heap
+    } else {
+      // Free it
+      JSONFree(&subtree);
+    }
+  }
+}
+
+// Create a new arena
+JSONArena* JSONArenaCreate(void) {
+  // Allocate memory for the arena
+  JSONArena* that = PBErrMalloc(JSONErr, sizeof(JSONArena));
+  // Set the properties, the first block is allocated at the first 
+  // allocation
+  that->_head = NULL;
+  that->_cur = NULL;
+  that->_roots = JSONArrayStructCreateStatic();
+  that->_maps = NULL;
+  that->_flagLazy = false;
+  // Return the new arena
+  return that;
+}
+
+// Free the memory used by the arena 'that' and by all the JSON trees
+// allocated in it
+void JSONArenaFree(JSONArena** that) {
+  // Check arguments
+  if (that == NULL || *that == NULL)
+    // Nothing to do
+    return;
+  // Release the trees
+  JSONArenaReset(*that);
+  // Free the blocks
+  while ((*that)->_head != NULL) {
+    JSONArenaBlock* block = (*that)->_head;
+    (*that)->_head = block->_next;
+    free(block);
+  }
+  // Free memory
+  free(*that);
+  *that = NULL;
+}
+
+// Return the size of the header of an arena block, rounded to keep 
+// the allocations aligned
+static inline size_t JSONArenaBlockHeadSize() {
+  return (sizeof(JSONArenaBlock) + PBJSON_ARENAALIGN - 1) & 
+    ~((size_t)PBJSON_ARENAALIGN - 1);
+}
+
+// Release all the JSON trees allocated in the arena 'that' at once
+// The memory of the arena is kept for the next allocations
+void JSONArenaReset(JSONArena* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  // Release the subtrees of the roots, which frees the elements of the 
+  // sets of subtrees and the nodes attached from the heap
+  while (GSetNbElem(&(that->_roots)) > 0) {
+    JSONNode* root = GSetPop(&(that->_roots));
+    JSONFreeArenaRec(root);
+  }
+  // Unmap the files whose bytes were borrowed by the labels
+  while (that->_maps != NULL) {
+    JSONArenaMap* map = that->_maps;
+    that->_maps = map->_next;
+    munmap(map->_addr, map->_size);
+    free(map);
+  }
+  // Rewind the blocks
+  for (JSONArenaBlock* block = that->_head; block != NULL; 
+    block = block->_next)
+    block->_used = 0;
+  that->_cur = that->_head;
+}
+
+// Set the flag memorizing if the JSON trees of the arena 'that' are 
+// loaded lazily to 'flag'
+void JSONArenaSetLazy(JSONArena* const that, const bool flag) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  that->_flagLazy = flag;
+}
+
+// Allocate 'size' bytes in the arena 'that'
+void* JSONArenaAlloc(JSONArena* const that, const size_t size) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  // Round the size to keep the allocations aligned
+  size_t sizeAlign = 
+    (size + PBJSON_ARENAALIGN - 1) & ~((size_t)PBJSON_ARENAALIGN - 1);
+  // Move to the next block while the current one is too small
+  while (that->_cur != NULL && 
+    that->_cur->_used + sizeAlign > that->_cur->_size)
+    that->_cur = that->_cur->_next;
+  // If there is no block with enough space
+  if (that->_cur == NULL) {
+    // Allocate a new block, large enough for the requested size
+    size_t sizeBlock = PBJSON_ARENABLOCKSIZE;
+    if (sizeBlock < sizeAlign)
+      sizeBlock = sizeAlign;
+    JSONArenaBlock* block = 
+      PBErrMalloc(JSONErr, JSONArenaBlockHeadSize() + sizeBlock);
+    block->_size = sizeBlock;
+    block->_used = 0;
+    // Add it at the head of the list, blocks after the previous 
+    // current one were too small anyway
+    block->_next = that->_head;
+    that->_head = block;
+    that->_cur = block;
+  }
+  // Allocate the memory in the current block
+  void* ptr = 
+    (char*)(that->_cur) + JSONArenaBlockHeadSize() + that->_cur->_used;
+  that->_cur->_used += sizeAlign;
+  // Return the allocated memory
+  return ptr;
+}
+
+// Create a new JSON node allocated in the arena 'that'
+// The nodes and labels added later to this node by the JSONAddProp 
+// family and the loader are allocated in the same arena
+// Nodes allocated in an arena must only be attached to nodes of the 
+// same arena
+JSONNode* JSONCreateInArena(JSONArena* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  // Create the node
+  JSONNode* node = JSONArenaCreateNode(that);
+  // Memorize it as a root to release its subtrees when the arena is 
+  // reset
+  GSetAppend(&(that->_roots), node);
+  // Return the new node
+  return node;
+}
+
+// Create a new JSON node to be attached to the node 'that'
+// The new node is allocated in the arena of 'that' if any, else on the 
+// heap
+JSONNode* JSONCreateChild(const JSONNode* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  // If 'that' is allocated in an arena
+  JSONLbl* lbl = (JSONLbl*)GenTreeData(that);
+  if (lbl != NULL && lbl->_arena != NULL)
+    // Create the new node in the same arena
+    return JSONArenaCreateNode(lbl->_arena);
+  // Else, create the new node on the heap
+  ++(JSONStatsCur._nbNode);
+  return JSONCreate();
 }
 
+// Create a new JSON node in the arena 'that', without label
+static JSONNode* JSONArenaCreateNode(JSONArena* const that) {
+  // Allocate memory for the node and its data. The JSONLbl without 
+  // label is counted with the node, not as a label
+  ++(JSONStatsCur._nbNode);
+  JSONNode* node = JSONArenaAlloc(that, sizeof(JSONNode));
+  *(GenTree*)node = GenTreeCreateStatic();
+  JSONLbl* lbl = JSONArenaAlloc(that, sizeof(JSONLbl));
+  // The node has no label, the JSONLbl only memorizes the arena
+  lbl->_str = NULL;
+  lbl->_size = 0;
+  lbl->_arena = that;
+  lbl->_index = NULL;
+  lbl->_cache = NULL;
+  lbl->_type = JSONTypeStr;
+  lbl->_flagBorrowed = false;
+  lbl->_lazy = NULL;
+  lbl->_lazyLen = 0;
+  GenTreeSetData(node, (void*)lbl);
+  // Return the new node
+  return node;
+}
 // Add a property to the node 'that'. The property's key is a copy of a 
 // 'key' and its values are a copy of the values in the GSetStr 'set'
 void _JSONAddPropArr(JSONNode* const that, const char* const key, 
@@ -93,7 +996,7 @@ void _JSONAddPropArr(JSONNode* const that, const char* const key,
   }
 #endif
   // Create a new node for the key
-  JSONNode* nodeKey = JSONCreate();
+  JSONNode* nodeKey = JSONCreateChild(that);
   // Set the key label
   JSONSetLabel(nodeKey, key);
   int nbElem = GSetNbElem(set);
@@ -104,7 +1007,7 @@ void _JSONAddPropArr(JSONNode* const that, const char* const key,
       // Get the value
       char* val = GSetIterGet(&iter);
       // Create a new node for the val
-      JSONNode* nodeVal = JSONCreate();
+      JSONNode* nodeVal = JSONCreateChild(nodeKey);
       // Set the val label
       JSONSetLabel(nodeVal, val);
       // Attach the val to the key
@@ -115,7 +1018,7 @@ void _JSONAddPropArr(JSONNode* const that, const char* const key,
   // as a property when saving 
   while (nbElem < 1) {
     // Create a new empty node 
-    JSONNode* nodeVal = JSONCreate();
+    JSONNode* nodeVal = JSONCreateChild(nodeKey);
     // Attach the empty node to the key
     JSONAppendVal(nodeKey, nodeVal);
     ++nbElem;
@@ -124,17 +1027,76 @@ void _JSONAddPropArr(JSONNode* const that, const char* const key,
   JSONAppendVal(that, nodeKey);
 }
 
+// Add a property to the node 'that'. The property's key is a copy of a 
+// 'key' and its values are the values of the array of values 'set', 
+// moved into the new nodes instead of being copied. 'set' is empty 
+// after the call
+// If 'that' is in an arena the values are copied in the arena and 
+// freed
+void JSONAddPropArrMove(JSONNode* const that, const char* const key, 
+  JSONArrayLbl* const set) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (key == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'key' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (set == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'set' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  // If 'that' is in an arena, the JSONLbl of the values on the heap 
+  // can't be attached to nodes of the arena, they are copied
+  JSONLbl* lblThat = (JSONLbl*)GenTreeData(that);
+  bool flagCopy = (lblThat != NULL && lblThat->_arena != NULL);
+  // Create a new node for the key
+  JSONNode* nodeKey = JSONCreateChild(that);
+  // Set the key label
+  JSONSetLabel(nodeKey, key);
+  // If the array is empty, add an empty node to ensure it is viewed as 
+  // a property when saving
+  if (GSetNbElem(&(set->_set)) == 0)
+    JSONAppendVal(nodeKey, JSONCreateChild(nodeKey));
+  // For each val in the set, in order
+  while (GSetNbElem(&(set->_set)) > 0) {
+    // Remove the JSONLbl of the value from the set
+    JSONLbl* lbl = GSetPop(&(set->_set));
+    // Create a new node for the val
+    JSONNode* nodeVal = JSONCreateChild(nodeKey);
+    // Give the JSONLbl of the val to the node, or copy it in the arena
+    if (flagCopy) {
+      JSONSetLabel(nodeVal, lbl->_str);
+      free(lbl);
+    } else {
+      JSONLblAttach(nodeVal, lbl);
+    }
+    // Attach the val to the key
+    JSONAppendVal(nodeKey, nodeVal);
+  }
+  // Attach the new property to the node 'that'
+  JSONAppendVal(that, nodeKey);
+}
+
 // Add a property to the node 'that'. The property's key is a copy of a 
 // 'key' and its values are the GenTreeStr in the GSetGenTreeStr 'set'
 void _JSONAddPropArrObj(JSONNode* const that, const char* const key, 
   const GSetGenTreeStr* const set) {
   // Create a new node for the key
-  JSONNode* nodeKey = JSONCreate();
+  JSONNode* nodeKey = JSONCreateChild(that);
   // Set the key label with '[]' as prefix
-  char buffer[PBJSON_MAXLENGTHLBL + 3];
-  buffer[0] = '[';buffer[1] = ']';
-  sprintf(buffer + 2, "%s", key);
-  JSONSetLabel(nodeKey, buffer);
+  size_t len = strlen(key);
+  JSONLbl* lbl = JSONLblCreate(nodeKey, len + 2);
+  lbl->_str[0] = '[';
+  lbl->_str[1] = ']';
+  memcpy(lbl->_str + 2, key, sizeof(char) * len);
+  JSONLblAttach(nodeKey, lbl);
   // GEt the number of value
   int nbElem = GSetNbElem(set);
   // If the array is not empty
@@ -152,7 +1114,7 @@ void _JSONAddPropArrObj(JSONNode* const that, const char* const key,
   // as a property when saving 
   while (nbElem < 1) {
     // Create a new empty node 
-    JSONNode* nodeVal = JSONCreate();
+    JSONNode* nodeVal = JSONCreateChild(nodeKey);
     // Attach the empty node to the key
     JSONAppendVal(nodeKey, nodeVal);
     ++nbElem;
@@ -161,33 +1123,779 @@ void _JSONAddPropArrObj(JSONNode* const that, const char* const key,
   JSONAppendVal(that, nodeKey);
 }
 
-// Function to add indentation in beautiful mode
-static inline bool JSONIndent(FILE* stream, int depth) {
-  for (int i = depth; i--;)
-    if (!PBErrPrintf(JSONErr, stream, "%s", PBJSON_INDENT))
-      return false;
-  return true;
+// Indentation for PBJSON_INDENTSTRNB levels of depth, concatenated at 
+// compilation time
+#define JSONINDENT4 PBJSON_INDENT PBJSON_INDENT PBJSON_INDENT PBJSON_INDENT
+#define JSONINDENT16 JSONINDENT4 JSONINDENT4 JSONINDENT4 JSONINDENT4
+#define PBJSON_INDENTSTRNB 64
+static const char JSONIndentStr[] = 
+  JSONINDENT16 JSONINDENT16 JSONINDENT16 JSONINDENT16;
+
+// Initialise the writer 'that' on the stream 'stream' with the block
+// 'buf' of 'size' bytes
+// If 'stream' is null and 'flagGrow' is true the output is kept in 
+// 'buf' which grows as needed, if 'stream' is null and 'flagGrow' is 
+// false the output is only counted
+static inline void JSONWriterInit(JSONWriter* const that, 
+  FILE* const stream, char* const buf, const size_t size, 
+  const bool flagGrow) {
+  that->_stream = stream;
+  that->_buf = buf;
+  that->_len = 0;
+  that->_size = size;
+  that->_nbFlushed = 0;
+  that->_flagGrow = flagGrow;
+  that->_flagFixed = false;
+  that->_compact = true;
+  that->_depth = 0;
+  that->_flagKey = false;
+  that->_levels[0]._open = '\0';
+  that->_levels[0]._flagItem = false;
+  that->_levels[0]._flagNested = false;
+  pthread_once(&JSONSimdOnce, JSONSimdInit);
 }
 
-// Return true if the JSON node 'that' is a value (ie its subtree is 
-// empty)
-static inline bool JSONIsValue(JSONNode* const that) {
-  return (GSetNbElem(GenTreeSubtrees(that)) == 0);
+// Return the number of bytes written by the writer 'that'
+static inline size_t JSONWriterGetNb(const JSONWriter* const that) {
+  return that->_nbFlushed + that->_len;
 }
 
-// Save the JSON 'that' in the string 'str' of length at least equal to 
-// 'strLen'
-// If 'compact' equals true save in compact form, else save in easily 
-// readable form
-// Return true if it could save, false else
-bool JSONSaveToStr(const JSONNode* const that, char* const str, 
-  const size_t strLen, const bool compact) {
-#if BUILDMODE == 0
-  if (that == NULL) {
-    JSONErr->_type = PBErrTypeNullPointer;
-    sprintf(JSONErr->_msg, "'that' is null");
-    PBErrCatch(JSONErr);
-  }
+// Return true if the writer 'that' only counts the bytes
+static inline bool JSONWriterIsCounting(const JSONWriter* const that) {
+  return (that->_stream == NULL && !(that->_flagGrow));
+}
+
+// Give back the unused bytes of the buffer of the writer 'that' growing
+// in memory
+static inline void JSONWriterShrink(JSONWriter* const that) {
+  if (that->_len > 0 && that->_len < that->_size) {
+    char* buf = realloc(that->_buf, that->_len);
+    if (buf != NULL) {
+      that->_buf = buf;
+      that->_size = that->_len;
+    }
+  }
+}
+
+// Flush the block of the writer 'that' to make room for 'len' more 
+// bytes: write it on the stream, or grow it, or discard it if the 
+// output is only counted
+// Return false if there has been an I/O error or the buffer of fixed 
+// size is full
+static bool JSONWriterFlush(JSONWriter* const that, const size_t len) {
+  // If the buffer has a fixed size, it can't make room
+  if (that->_flagFixed) {
+    JSONErr->_type = PBErrTypeIOError;
+    sprintf(JSONErr->_msg, "JSONWriterFlush: buffer too small");
+    return false;
+  }
+  // If the output is kept in memory, double the size of the buffer 
+  // until the bytes fit
+  if (that->_flagGrow) {
+    size_t size = that->_size;
+    while (size < that->_len + len)
+      size *= 2;
+    char* buf = PBErrMalloc(JSONErr, size);
+    memcpy(buf, that->_buf, that->_len);
+    free(that->_buf);
+    that->_buf = buf;
+    that->_size = size;
+    return true;
+  }
+  // Write the block on the stream if there is one
+  double start = JSONStatsClock();
+  if (that->_stream != NULL && that->_len > 0 && 
+    fwrite(that->_buf, sizeof(char), that->_len, that->_stream) != 
+    that->_len) {
+    JSONErr->_type = PBErrTypeIOError;
+    sprintf(JSONErr->_msg, "JSONWriterFlush: write error");
+    that->_len = 0;
+    return false;
+  }
+  if (that->_stream != NULL)
+    JSONStatsAddTime(&(JSONStatsCur._timeWrite), start);
+  that->_nbFlushed += that->_len;
+  that->_len = 0;
+  return true;
+}
+
+// Append the 'len' chars of 'str' to the writer 'that'
+// Return false if there has been an I/O error
+static inline bool JSONWriterAppend(JSONWriter* const that, 
+  const char* const str, const size_t len) {
+  // If the chars don't fit in the block, flush it
+  if (that->_len + len > that->_size) {
+    if (!JSONWriterFlush(that, len))
+      return false;
+    // If the chars are larger than the block, write them directly
+    if (len > that->_size) {
+      if (that->_stream != NULL && 
+        fwrite(str, sizeof(char), len, that->_stream) != len) {
+        JSONErr->_type = PBErrTypeIOError;
+        sprintf(JSONErr->_msg, "JSONWriterAppend: write error");
+        return false;
+      }
+      that->_nbFlushed += len;
+      return true;
+    }
+  }
+  memcpy(that->_buf + that->_len, str, len);
+  that->_len += len;
+  return true;
+}
+
+// Append the char 'c' to the writer 'that'
+// Return false if there has been an I/O error
+static inline bool JSONWriterAppendChar(JSONWriter* const that, 
+  const char c) {
+  if (that->_len == that->_size && !JSONWriterFlush(that, 1))
+    return false;
+  that->_buf[that->_len] = c;
+  ++(that->_len);
+  return true;
+}
+
+// Decimal representation of the numbers from 0 to 99
+static const char JSONDigitPairs[] = 
+  "0001020304050607080910111213141516171819"
+  "2021222324252627282930313233343536373839"
+  "4041424344454647484950515253545556575859"
+  "6061626364656667686970717273747576777879"
+  "8081828384858687888990919293949596979899";
+
+// Powers of ten exactly representable as doubles
+static const double JSONPow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// Powers of ten 10^_k = _f*2^_e, for _k from -300 to 324 by step of 8,
+// used to scale the doubles in JSONGrisu2
+static const JSONCachedPow JSONCachedPows[] = {
+  {0xAB70FE17C79AC6CAULL, -1060, -300},
+  {0xFF77B1FCBEBCDC4FULL, -1034, -292},
+  {0xBE5691EF416BD60CULL, -1007, -284},
+  {0x8DD01FAD907FFC3CULL, -980, -276},
+  {0xD3515C2831559A83ULL, -954, -268},
+  {0x9D71AC8FADA6C9B5ULL, -927, -260},
+  {0xEA9C227723EE8BCBULL, -901, -252},
+  {0xAECC49914078536DULL, -874, -244},
+  {0x823C12795DB6CE57ULL, -847, -236},
+  {0xC21094364DFB5637ULL, -821, -228},
+  {0x9096EA6F3848984FULL, -794, -220},
+  {0xD77485CB25823AC7ULL, -768, -212},
+  {0xA086CFCD97BF97F4ULL, -741, -204},
+  {0xEF340A98172AACE5ULL, -715, -196},
+  {0xB23867FB2A35B28EULL, -688, -188},
+  {0x84C8D4DFD2C63F3BULL, -661, -180},
+  {0xC5DD44271AD3CDBAULL, -635, -172},
+  {0x936B9FCEBB25C996ULL, -608, -164},
+  {0xDBAC6C247D62A584ULL, -582, -156},
+  {0xA3AB66580D5FDAF6ULL, -555, -148},
+  {0xF3E2F893DEC3F126ULL, -529, -140},
+  {0xB5B5ADA8AAFF80B8ULL, -502, -132},
+  {0x87625F056C7C4A8BULL, -475, -124},
+  {0xC9BCFF6034C13053ULL, -449, -116},
+  {0x964E858C91BA2655ULL, -422, -108},
+  {0xDFF9772470297EBDULL, -396, -100},
+  {0xA6DFBD9FB8E5B88FULL, -369, -92},
+  {0xF8A95FCF88747D94ULL, -343, -84},
+  {0xB94470938FA89BCFULL, -316, -76},
+  {0x8A08F0F8BF0F156BULL, -289, -68},
+  {0xCDB02555653131B6ULL, -263, -60},
+  {0x993FE2C6D07B7FACULL, -236, -52},
+  {0xE45C10C42A2B3B06ULL, -210, -44},
+  {0xAA242499697392D3ULL, -183, -36},
+  {0xFD87B5F28300CA0EULL, -157, -28},
+  {0xBCE5086492111AEBULL, -130, -20},
+  {0x8CBCCC096F5088CCULL, -103, -12},
+  {0xD1B71758E219652CULL, -77, -4},
+  {0x9C40000000000000ULL, -50, 4},
+  {0xE8D4A51000000000ULL, -24, 12},
+  {0xAD78EBC5AC620000ULL, 3, 20},
+  {0x813F3978F8940984ULL, 30, 28},
+  {0xC097CE7BC90715B3ULL, 56, 36},
+  {0x8F7E32CE7BEA5C70ULL, 83, 44},
+  {0xD5D238A4ABE98068ULL, 109, 52},
+  {0x9F4F2726179A2245ULL, 136, 60},
+  {0xED63A231D4C4FB27ULL, 162, 68},
+  {0xB0DE65388CC8ADA8ULL, 189, 76},
+  {0x83C7088E1AAB65DBULL, 216, 84},
+  {0xC45D1DF942711D9AULL, 242, 92},
+  {0x924D692CA61BE758ULL, 269, 100},
+  {0xDA01EE641A708DEAULL, 295, 108},
+  {0xA26DA3999AEF774AULL, 322, 116},
+  {0xF209787BB47D6B85ULL, 348, 124},
+  {0xB454E4A179DD1877ULL, 375, 132},
+  {0x865B86925B9BC5C2ULL, 402, 140},
+  {0xC83553C5C8965D3DULL, 428, 148},
+  {0x952AB45CFA97A0B3ULL, 455, 156},
+  {0xDE469FBD99A05FE3ULL, 481, 164},
+  {0xA59BC234DB398C25ULL, 508, 172},
+  {0xF6C69A72A3989F5CULL, 534, 180},
+  {0xB7DCBF5354E9BECEULL, 561, 188},
+  {0x88FCF317F22241E2ULL, 588, 196},
+  {0xCC20CE9BD35C78A5ULL, 614, 204},
+  {0x98165AF37B2153DFULL, 641, 212},
+  {0xE2A0B5DC971F303AULL, 667, 220},
+  {0xA8D9D1535CE3B396ULL, 694, 228},
+  {0xFB9B7CD9A4A7443CULL, 720, 236},
+  {0xBB764C4CA7A44410ULL, 747, 244},
+  {0x8BAB8EEFB6409C1AULL, 774, 252},
+  {0xD01FEF10A657842CULL, 800, 260},
+  {0x9B10A4E5E9913129ULL, 827, 268},
+  {0xE7109BFBA19C0C9DULL, 853, 276},
+  {0xAC2820D9623BF429ULL, 880, 284},
+  {0x80444B5E7AA7CF85ULL, 907, 292},
+  {0xBF21E44003ACDD2DULL, 933, 300},
+  {0x8E679C2F5E44FF8FULL, 960, 308},
+  {0xD433179D9C8CB841ULL, 986, 316},
+  {0x9E19DB92B4E31BA9ULL, 1013, 324},
+};
+
+// Locale used to convert the numbers which can't be converted exactly 
+// by JSONScanNumber, and the control of its creation
+static locale_t JSONLocaleC = (locale_t)0;
+static pthread_once_t JSONLocaleOnce = PTHREAD_ONCE_INIT;
+
+// Create the C locale
+static void JSONLocaleCInit(void) {
+  JSONLocaleC = newlocale(LC_ALL_MASK, "C", (locale_t)0);
+}
+
+// Convert the null terminated string 'str' to a double with the C 
+// locale, whatever the locale of the application
+static double JSONStrToRealC(const char* const str) {
+  pthread_once(&JSONLocaleOnce, JSONLocaleCInit);
+  // If the C locale couldn't be created, use the current one
+  if (JSONLocaleC == (locale_t)0)
+    return strtod(str, NULL);
+  // Switch to the C locale for the current thread only
+  locale_t locale = uselocale(JSONLocaleC);
+  double val = strtod(str, NULL);
+  uselocale(locale);
+  return val;
+}
+
+// Write in 'str' the integer 'val' in decimal, followed by '\0'
+// 'str' must have room for PBJSON_SCALARSIZE chars
+// Return the number of chars written, excluding the '\0'
+size_t JSONFormatInt(const int64_t val, char* const str) {
+#if BUILDMODE == 0
+  if (str == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'str' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  // Work on the absolute value, as unsigned to support INT64_MIN
+  uint64_t abs = (val < 0 ? 0 - (uint64_t)val : (uint64_t)val);
+  // Write the digits backward, two by two, at the end of a local buffer
+  char digits[20];
+  char* ptr = digits + sizeof(digits);
+  while (abs >= 100) {
+    size_t pair = (size_t)(abs % 100);
+    abs /= 100;
+    ptr -= 2;
+    memcpy(ptr, JSONDigitPairs + 2 * pair, 2);
+  }
+  if (abs >= 10) {
+    ptr -= 2;
+    memcpy(ptr, JSONDigitPairs + 2 * abs, 2);
+  } else {
+    --ptr;
+    *ptr = (char)('0' + abs);
+  }
+  // Copy the sign and the digits in the result
+  size_t len = 0;
+  if (val < 0)
+    str[len++] = '-';
+  size_t nbDigit = (size_t)(digits + sizeof(digits) - ptr);
+  memcpy(str + len, ptr, nbDigit);
+  len += nbDigit;
+  str[len] = '\0';
+  // Return the length of the result
+  return len;
+}
+
+// Return the product of 'x' by 'y', rounded to 64 bits of mantissa
+static inline JSONDiyFp JSONDiyFpMul(const JSONDiyFp x, 
+  const JSONDiyFp y) {
+  // Multiply the 32 bits halves of the mantissas
+  const uint64_t mask = 0xFFFFFFFFULL;
+  uint64_t a = x._f >> 32;
+  uint64_t b = x._f & mask;
+  uint64_t c = y._f >> 32;
+  uint64_t d = y._f & mask;
+  uint64_t ac = a * c;
+  uint64_t bc = b * c;
+  uint64_t ad = a * d;
+  uint64_t bd = b * d;
+  // Sum the middle terms and round the lower 64 bits
+  uint64_t mid = (bd >> 32) + (ad & mask) + (bc & mask) + (1ULL << 31);
+  JSONDiyFp res = {
+    ._f = ac + (ad >> 32) + (bc >> 32) + (mid >> 32),
+    ._e = x._e + y._e + 64};
+  return res;
+}
+
+// Return 'x' shifted until the highest bit of its mantissa is set
+static inline JSONDiyFp JSONDiyFpNormalize(JSONDiyFp x) {
+  while ((x._f & (1ULL << 63)) == 0) {
+    x._f <<= 1;
+    --(x._e);
+  }
+  return x;
+}
+
+// Generate the digits of the number 'high' shifted by 'exp', within 
+// 'delta' of it and closest to 'high' minus 'dist' 
+static void JSONGrisu2Digits(const JSONDiyFp high, const uint64_t dist, 
+  uint64_t delta, char* const digits, int* const nbDigit, 
+  int* const exp) {
+  // Split 'high' in its integral part 'intPart' (at most 32 bits as 
+  // 'high' has been scaled to an exponent in [-60, -32]) and its 
+  // fractional part 'fracPart'
+  const int shift = -high._e;
+  const uint64_t one = 1ULL << shift;
+  uint32_t intPart = (uint32_t)(high._f >> shift);
+  uint64_t fracPart = high._f & (one - 1);
+  uint64_t distHigh = dist;
+  // Get the number of digits of the integral part and the matching 
+  // power of ten
+  int kappa = 10;
+  uint32_t pow10 = 1000000000;
+  while (kappa > 1 && intPart < pow10) {
+    --kappa;
+    pow10 /= 10;
+  }
+  int len = 0;
+  uint64_t rest = 0;
+  uint64_t unit = 0;
+  // Generate the digits of the integral part, and stop as soon as the 
+  // digits generated so far are within 'delta' of 'high'
+  bool flagDone = false;
+  while (kappa > 0 && !flagDone) {
+    digits[len++] = (char)('0' + intPart / pow10);
+    intPart %= pow10;
+    --kappa;
+    rest = ((uint64_t)intPart << shift) + fracPart;
+    if (rest <= delta) {
+      unit = (uint64_t)pow10 << shift;
+      *exp += kappa;
+      flagDone = true;
+    }
+    pow10 /= 10;
+  }
+  // Generate the digits of the fractional part if necessary
+  if (!flagDone) {
+    do {
+      fracPart *= 10;
+      delta *= 10;
+      distHigh *= 10;
+      digits[len++] = (char)('0' + (fracPart >> shift));
+      fracPart &= one - 1;
+      --(*exp);
+    } while (fracPart > delta);
+    rest = fracPart;
+    unit = one;
+  }
+  // Decrement the last digit while it brings the result closer to the 
+  // exact value and stays within 'delta' of 'high'
+  while (rest < distHigh && delta - rest >= unit && 
+    (rest + unit < distHigh || distHigh - rest > rest + unit - distHigh)) {
+    --(digits[len - 1]);
+    rest += unit;
+  }
+  *nbDigit = len;
+}
+
+// Write in 'digits' the shortest sequence of digits 'digits'*10^'*exp' 
+// which converts back to the strictly positive double 'val', and set 
+// '*nbDigit' to the number of digits (Grisu2 algorithm)
+static void JSONGrisu2(const double val, char* const digits, 
+  int* const nbDigit, int* const exp) {
+  // Decompose the double in its mantissa and binary exponent
+  uint64_t bits = 0;
+  memcpy(&bits, &val, sizeof(bits));
+  const uint64_t hiddenBit = 1ULL << 52;
+  int biasedExp = (int)(bits >> 52);
+  uint64_t mantissa = bits & (hiddenBit - 1);
+  JSONDiyFp v = {._f = mantissa, ._e = 1 - 1075};
+  if (biasedExp != 0) {
+    v._f = mantissa + hiddenBit;
+    v._e = biasedExp - 1075;
+  }
+  // Get the boundaries of the interval of the numbers which convert 
+  // back to 'val', the lower one is closer if 'val' is a power of two
+  JSONDiyFp high = {._f = 2 * v._f + 1, ._e = v._e - 1};
+  high = JSONDiyFpNormalize(high);
+  JSONDiyFp low = {._f = 2 * v._f - 1, ._e = v._e - 1};
+  if (mantissa == 0 && biasedExp > 1) {
+    low._f = 4 * v._f - 1;
+    low._e = v._e - 2;
+  }
+  low._f <<= low._e - high._e;
+  low._e = high._e;
+  v = JSONDiyFpNormalize(v);
+  // Get the cached power of ten which scales the boundaries to a 
+  // binary exponent in [-60, -32]
+  int f = -60 - high._e - 1;
+  int k = (f * 78913) / (1 << 18) + (f > 0 ? 1 : 0);
+  int index = (300 + k + 7) / 8;
+  JSONDiyFp pow = {
+    ._f = JSONCachedPows[index]._f, ._e = JSONCachedPows[index]._e};
+  *exp = -JSONCachedPows[index]._k;
+  // Scale the value and its boundaries, shrinking the interval by one 
+  // unit on each side to cover the rounding errors
+  JSONDiyFp w = JSONDiyFpMul(v, pow);
+  JSONDiyFp wLow = JSONDiyFpMul(low, pow);
+  JSONDiyFp wHigh = JSONDiyFpMul(high, pow);
+  ++(wLow._f);
+  --(wHigh._f);
+  // Generate the digits
+  JSONGrisu2Digits(wHigh, wHigh._f - w._f, wHigh._f - wLow._f, 
+    digits, nbDigit, exp);
+}
+
+// Format the 'nbDigit' chars of 'digits' which represent the number 
+// 'digits'*10^'exp' in decimal or exponential notation, in place
+// 'digits' must have room for PBJSON_SCALARSIZE chars
+// Return the number of chars of the result
+static size_t JSONFormatDigits(char* const digits, const int nbDigit, 
+  const int exp) {
+  // Position of the decimal point relative to the first digit
+  int point = nbDigit + exp;
+  size_t len = 0;
+  if (nbDigit <= point && point <= 15) {
+    // Integral number: digits, trailing zeros and ".0"
+    memset(digits + nbDigit, '0', (size_t)(point - nbDigit));
+    memcpy(digits + point, ".0", 3);
+    len = (size_t)point + 2;
+  } else if (0 < point && point <= 15) {
+    // Decimal point inside the digits
+    memmove(digits + point + 1, digits + point, 
+      (size_t)(nbDigit - point));
+    digits[point] = '.';
+    len = (size_t)nbDigit + 1;
+    digits[len] = '\0';
+  } else if (-4 < point && point <= 0) {
+    // Small number: "0.", leading zeros and digits
+    memmove(digits + 2 - point, digits, (size_t)nbDigit);
+    memcpy(digits, "0.", 2);
+    memset(digits + 2, '0', (size_t)(-point));
+    len = (size_t)(2 - point + nbDigit);
+    digits[len] = '\0';
+  } else {
+    // Exponential notation, with a decimal point after the first digit
+    // if there are several digits
+    len = 1;
+    if (nbDigit > 1) {
+      memmove(digits + 2, digits + 1, (size_t)(nbDigit - 1));
+      digits[1] = '.';
+      len = (size_t)nbDigit + 1;
+    }
+    // Exponent with its sign and at least two digits
+    int exp10 = point - 1;
+    digits[len++] = 'e';
+    digits[len++] = (exp10 < 0 ? '-' : '+');
+    if (exp10 < 0)
+      exp10 = -exp10;
+    if (exp10 >= 100) {
+      digits[len++] = (char)('0' + exp10 / 100);
+      exp10 %= 100;
+    }
+    memcpy(digits + len, JSONDigitPairs + 2 * exp10, 2);
+    len += 2;
+    digits[len] = '\0';
+  }
+  // Return the length of the result
+  return len;
+}
+
+// Write in 'str' the shortest decimal representation of the floating 
+// point number 'val' which converts back to 'val', followed by '\0'
+// It's the shortest for 99.9% of the numbers, one digit longer for the
+// others (Grisu2 algorithm)
+// The representation always has a decimal point or an exponent, and
+// infinity and NaN, which can't be represented in JSON, are written as 
+// null. It doesn't depend on the locale
+// 'str' must have room for PBJSON_SCALARSIZE chars
+// Return the number of chars written, excluding the '\0'
+size_t JSONFormatReal(const double val, char* const str) {
+#if BUILDMODE == 0
+  if (str == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'str' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  // JSON has no representation for infinity and NaN
+  if (!isfinite(val)) {
+    memcpy(str, "null", 5);
+    return 4;
+  }
+  // Write the sign
+  size_t len = 0;
+  if (signbit(val))
+    str[len++] = '-';
+  // Zero has no digit for Grisu2
+  if (val == 0.0) {
+    memcpy(str + len, "0.0", 4);
+    return len + 3;
+  }
+  // Generate the digits and format them
+  int nbDigit = 0;
+  int exp = 0;
+  JSONGrisu2(fabs(val), str + len, &nbDigit, &exp);
+  return len + JSONFormatDigits(str + len, nbDigit, exp);
+}
+
+// Convert the 'len' first chars of 'str', a JSON number, to its native 
+// value. Numbers without fraction nor exponent which fit in 64 bits are
+// integers, other numbers are floating point numbers. On success 
+// '*type' and '*val' are set to the type and value of the number
+// The conversion doesn't depend on the locale
+// Return false if 'str' is not a valid JSON number
+bool JSONScanNumber(const char* const str, const size_t len, 
+  JSONType* const type, JSONPayload* const val) {
+#if BUILDMODE == 0
+  if (str == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'str' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (type == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'type' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (val == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'val' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  // Accumulate the first 19 significant digits in 'mantissa', which 
+  // can't overflow, the number being 'mantissa'*10^'exp'
+  uint64_t mantissa = 0;
+  int nbSignificant = 0;
+  int exp = 0;
+  bool flagTruncated = false;
+  size_t pos = 0;
+  bool flagNeg = (len > 0 && str[0] == '-');
+  if (flagNeg)
+    ++pos;
+  // Integral part
+  size_t start = pos;
+  while (pos < len && str[pos] >= '0' && str[pos] <= '9') {
+    int digit = str[pos] - '0';
+    if (nbSignificant < 19) {
+      mantissa = mantissa * 10 + (uint64_t)digit;
+      if (mantissa != 0)
+        ++nbSignificant;
+    } else {
+      flagTruncated |= (digit != 0);
+      ++exp;
+    }
+    ++pos;
+  }
+  if (pos == start)
+    return false;
+  bool flagInt = true;
+  // Fractional part
+  if (pos < len && str[pos] == '.') {
+    flagInt = false;
+    ++pos;
+    start = pos;
+    while (pos < len && str[pos] >= '0' && str[pos] <= '9') {
+      int digit = str[pos] - '0';
+      if (nbSignificant < 19) {
+        mantissa = mantissa * 10 + (uint64_t)digit;
+        if (mantissa != 0)
+          ++nbSignificant;
+        --exp;
+      } else {
+        flagTruncated |= (digit != 0);
+      }
+      ++pos;
+    }
+    if (pos == start)
+      return false;
+  }
+  // Exponent, large exponents are clamped as they give anyway zero or 
+  // infinity
+  if (pos < len && (str[pos] == 'e' || str[pos] == 'E')) {
+    flagInt = false;
+    ++pos;
+    bool flagNegExp = (pos < len && str[pos] == '-');
+    if (pos < len && (str[pos] == '-' || str[pos] == '+'))
+      ++pos;
+    start = pos;
+    int exp10 = 0;
+    while (pos < len && str[pos] >= '0' && str[pos] <= '9') {
+      if (exp10 < 100000)
+        exp10 = exp10 * 10 + (str[pos] - '0');
+      ++pos;
+    }
+    if (pos == start)
+      return false;
+    exp += (flagNegExp ? -exp10 : exp10);
+  }
+  // The whole string must be the number
+  if (pos != len)
+    return false;
+  // Integers which fit in 64 bits
+  const uint64_t maxInt = (uint64_t)INT64_MAX;
+  if (flagInt && exp == 0 && 
+    (mantissa <= maxInt || (flagNeg && mantissa == maxInt + 1))) {
+    *type = JSONTypeInt;
+    if (mantissa == maxInt + 1)
+      val->_int = INT64_MIN;
+    else
+      val->_int = (flagNeg ? -(int64_t)mantissa : (int64_t)mantissa);
+    return true;
+  }
+  *type = JSONTypeReal;
+  // If the mantissa and the power of ten are exact doubles, one 
+  // multiplication or division gives the correctly rounded result
+  if (!flagTruncated && mantissa <= (1ULL << 53) && 
+    exp >= -22 && exp <= 22) {
+    double real = (double)mantissa;
+    if (exp < 0)
+      real /= JSONPow10[-exp];
+    else
+      real *= JSONPow10[exp];
+    val->_real = (flagNeg ? -real : real);
+    return true;
+  }
+  // Else fall back to the C library, in the C locale
+  char tok[PBJSON_SCALARSIZE];
+  char* buf = tok;
+  if (len >= sizeof(tok))
+    buf = PBErrMalloc(JSONErr, len + 1);
+  memcpy(buf, str, len);
+  buf[len] = '\0';
+  val->_real = JSONStrToRealC(buf);
+  if (buf != tok)
+    free(buf);
+  return true;
+}
+
+// Append the 'len' chars of 'str' to the writer 'that', escaping the 
+// double quotes, backslashes and control chars. The runs of chars 
+// which don't need to be escaped are appended at once
+// Return false if there has been an I/O error
+static bool JSONWriterAppendEscaped(JSONWriter* const that, 
+  const char* const str, const size_t len) {
+  size_t pos = 0;
+  while (true) {
+    // Append the run of chars up to the next char to escape
+    size_t end = JSONScanEscape(str, pos, len);
+    if (!JSONWriterAppend(that, str + pos, end - pos))
+      return false;
+    if (end >= len)
+      return true;
+    // Append the escape sequence of the char, the short one if it 
+    // exists, else its code point
+    unsigned char c = (unsigned char)(str[end]);
+    char esc[6] = {'\\', (char)c, '0', '0', '0', '0'};
+    size_t lenEsc = 2;
+    switch (c) {
+      case '"':
+      case '\\':
+        break;
+      case '\b':
+        esc[1] = 'b';
+        break;
+      case '\f':
+        esc[1] = 'f';
+        break;
+      case '\n':
+        esc[1] = 'n';
+        break;
+      case '\r':
+        esc[1] = 'r';
+        break;
+      case '\t':
+        esc[1] = 't';
+        break;
+      default:
+        esc[1] = 'u';
+        esc[4] = "0123456789abcdef"[c >> 4];
+        esc[5] = "0123456789abcdef"[c & 0xF];
+        lenEsc = 6;
+        break;
+    }
+    if (!JSONWriterAppend(that, esc, lenEsc))
+      return false;
+    pos = end + 1;
+  }
+}
+
+// Append the value of the node 'node' to the writer 'that', as a 
+// double quoted string or as a native JSON number, boolean or null
+// Return false if there has been an I/O error
+static bool JSONWriterAppendVal(JSONWriter* const that, 
+  const JSONNode* const node) {
+  JSONLbl* lbl = (JSONLbl*)GenTreeData(node);
+  JSONType type = (lbl != NULL ? lbl->_type : JSONTypeStr);
+  // Declare a buffer for the conversion of numbers
+  char num[PBJSON_SCALARSIZE];
+  size_t len = 0;
+  switch (type) {
+    case JSONTypeInt:
+      len = JSONFormatInt(lbl->_val._int, num);
+      return JSONWriterAppend(that, num, len);
+    case JSONTypeReal:
+      len = JSONFormatReal(lbl->_val._real, num);
+      return JSONWriterAppend(that, num, len);
+    case JSONTypeBool:
+      if (lbl->_val._bool)
+        return JSONWriterAppend(that, "true", 4);
+      return JSONWriterAppend(that, "false", 5);
+    case JSONTypeNull:
+      return JSONWriterAppend(that, "null", 4);
+    default:
+      if (!JSONWriterAppendChar(that, '"'))
+        return false;
+      if (lbl != NULL && lbl->_str != NULL && 
+        !JSONWriterAppendEscaped(that, lbl->_str, strlen(lbl->_str)))
+        return false;
+      return JSONWriterAppendChar(that, '"');
+  }
+}
+
+// Function to add indentation in beautiful mode
+static inline bool JSONIndent(JSONWriter* const writer, int depth) {
+  // Append the precomputed indentation, by packs of PBJSON_INDENTSTRNB
+  // levels
+  const size_t lenIndent = sizeof(PBJSON_INDENT) - 1;
+  while (depth > PBJSON_INDENTSTRNB) {
+    if (!JSONWriterAppend(writer, JSONIndentStr, 
+      lenIndent * PBJSON_INDENTSTRNB))
+      return false;
+    depth -= PBJSON_INDENTSTRNB;
+  }
+  return JSONWriterAppend(writer, JSONIndentStr, lenIndent * depth);
+}
+
+// Return true if the JSON node 'that' is a value (ie its subtree is 
+// empty)
+static inline bool JSONIsValue(JSONNode* const that) {
+  return (JSONGetNbValue(that) == 0);
+}
+
+// Save the JSON 'that' in the string 'str' of length at least equal to 
+// 'strLen'
+// If 'compact' equals true save in compact form, else save in easily 
+// readable form
+// Return true if it could save, false else
+bool JSONSaveToStr(const JSONNode* const that, char* const str, 
+  const size_t strLen, const bool compact) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
   if (str == NULL) {
     JSONErr->_type = PBErrTypeNullPointer;
     sprintf(JSONErr->_msg, "'str' is null");
@@ -227,32 +1935,165 @@ bool JSONSave(const JSONNode* const that, FILE* const stream,
     PBErrCatch(JSONErr);
   }
 #endif
+  double start = JSONStatsClock();
+  // Declare a writer on the stream, its block is allocated on the heap
+  // to keep it out of the stack
+  JSONWriter writer;
+  JSONWriterInit(&writer, stream, 
+    PBErrMalloc(JSONErr, PBJSON_WRITEBLOCKSIZE), PBJSON_WRITEBLOCKSIZE,
+    false);
   // Start the recursion at depth 0
-  return JSONSaveRec(that, stream, compact, 0);
+  bool ret = JSONSaveRec(that, &writer, compact, 0);
+  // Write the remaining bytes
+  if (!JSONWriterFlush(&writer, 0))
+    ret = false;
+  free(writer._buf);
+  JSONStatsEndSave(JSONWriterGetNb(&writer), start);
+  // Return the success code
+  return ret;
+}
+
+// Save the JSON 'that' in a null terminated buffer sized exactly to 
+// the output and return it
+// If 'arena' is not null the buffer is allocated in it, else it is 
+// allocated on the heap and must be freed by the user
+// If 'len' is not null it's set to the length of the output (without 
+// the terminating '\0')
+// If 'compact' equals true save in compact form, else save in easily 
+// readable form
+char* JSONSaveToBuffer(const JSONNode* const that, 
+  JSONArena* const arena, size_t* const len, const bool compact) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  double start = JSONStatsClock();
+  // Declare a writer in memory
+  JSONWriter writer;
+  // If the buffer is allocated in the arena, which can't shrink an 
+  // allocation, count the bytes first and save directly in a buffer 
+  // of the exact size
+  if (arena != NULL) {
+    size_t size = JSONGetSaveSize(that, compact);
+    JSONWriterInit(&writer, NULL, JSONArenaAlloc(arena, size + 1), 
+      size + 1, false);
+  // Else, save in a buffer growing as needed
+  } else {
+    JSONWriterInit(&writer, NULL, PBErrMalloc(JSONErr, PBJSON_BLOCKSIZE),
+      PBJSON_BLOCKSIZE, true);
+  }
+  // Save the JSON, writing in memory can't fail
+  (void)JSONSaveRec(that, &writer, compact, 0);
+  (void)JSONWriterAppendChar(&writer, '\0');
+  // Give back the bytes unused by the buffer on the heap
+  if (arena == NULL)
+    JSONWriterShrink(&writer);
+  // Set the length of the output
+  if (len != NULL)
+    *len = writer._len - 1;
+  JSONStatsEndSave(writer._len - 1, start);
+  // Return the buffer
+  return writer._buf;
+}
+
+// Return the number of bytes of the JSON 'that' saved in compact form 
+// if 'compact' equals true, else in easily readable form, without 
+// writing it
+size_t JSONGetSaveSize(const JSONNode* const that, const bool compact) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  // Declare a writer only counting the bytes, flushing a small block 
+  // on the stack
+  char block[PBJSON_BLOCKSIZE];
+  JSONWriter writer;
+  JSONWriterInit(&writer, NULL, block, PBJSON_BLOCKSIZE, false);
+  // Save the JSON, counting can't fail
+  (void)JSONSaveRec(that, &writer, compact, 0);
+  // Return the number of bytes
+  return JSONWriterGetNb(&writer);
 }
 
-// Save recursively the JSON tree 'that' into the stream 'stream'
+// Save recursively the JSON tree 'that' into the writer 'writer'
 // Return true if it could save, false else
-bool JSONSaveRec(const JSONNode* const that, FILE* const stream, 
+bool JSONSaveRec(const JSONNode* const that, JSONWriter* const writer, 
   const bool compact, int depth) {
+  // Get the cache of the node. It's used only in compact form and for 
+  // nodes other than the root, whose serialization doesn't depend on 
+  // their depth
+  JSONLbl* lbl = (JSONLbl*)GenTreeData(that);
+  JSONCache* cache = (lbl != NULL ? lbl->_cache : NULL);
+  if (cache == NULL || !compact || depth == 0)
+    return JSONSaveRecNode(that, writer, compact, depth);
+  // If the cache is valid
+  if (cache->_flagValid) {
+    // Copy the cached bytes if any
+    if (cache->_bytes != NULL)
+      return JSONWriterAppend(writer, cache->_bytes, cache->_len);
+    // If the writer only counts, skip the cached length
+    if (JSONWriterIsCounting(writer)) {
+      writer->_nbFlushed += cache->_len;
+      return true;
+    }
+    // Else, only the length is cached, save the node
+    return JSONSaveRecNode(that, writer, compact, depth);
+  }
+  // If the bytes are cached, save the node in memory, keep the bytes 
+  // in the cache and copy them to the writer
+  if (cache->_flagBytes) {
+    JSONWriter writerCache;
+    JSONWriterInit(&writerCache, NULL, 
+      PBErrMalloc(JSONErr, PBJSON_BLOCKSIZE), PBJSON_BLOCKSIZE, true);
+    (void)JSONSaveRecNode(that, &writerCache, compact, depth);
+    JSONWriterShrink(&writerCache);
+    free(cache->_bytes);
+    cache->_bytes = writerCache._buf;
+    cache->_len = writerCache._len;
+    cache->_flagValid = true;
+    return JSONWriterAppend(writer, cache->_bytes, cache->_len);
+  }
+  // Else, save the node and keep the number of bytes written
+  size_t nb = JSONWriterGetNb(writer);
+  if (!JSONSaveRecNode(that, writer, compact, depth))
+    return false;
+  cache->_len = JSONWriterGetNb(writer) - nb;
+  cache->_flagValid = true;
+  // Return the success code
+  return true;
+}
+
+// Save recursively the JSON tree 'that' into the writer 'writer', 
+// without using the cache of 'that'
+// Return true if it could save, false else
+static bool JSONSaveRecNode(const JSONNode* const that, 
+  JSONWriter* const writer, const bool compact, int depth) {
   // Declare a flag to memorize if the current node is a key for an 
   // array of object
   bool flagArrObj = false;
   // Declare a variable to memorize the opening and closing char
-  char openChar[2] = "{";
-  char closeChar[2] = "}";
+  char openChar = '{';
+  char closeChar = '}';
   // Print the label of the property if it's not null
-  if (JSONLabel(that) != NULL && strlen(JSONLabel(that)) > 0) {
-    if (!compact && !JSONIndent(stream, depth)) 
+  if (JSONLabel(that) != NULL && JSONLabel(that)[0] != '\0') {
+    if (!compact && !JSONIndent(writer, depth)) 
       return false;
     char* lbl = JSONLabel(that);
     if (lbl[0] == '[' && lbl[1] == ']') {
       flagArrObj = true;
       lbl += 2;
-      openChar[0] = '[';
-      closeChar[0] = ']';
+      openChar = '[';
+      closeChar = ']';
     }
-    if (!PBErrPrintf(JSONErr, stream, "\"%s\":", lbl))
+    if (!JSONWriterAppendChar(writer, '"') ||
+      !JSONWriterAppendEscaped(writer, lbl, strlen(lbl)) ||
+      !JSONWriterAppend(writer, "\":", 2))
       return false;
   }
   // Loop on properties
@@ -264,17 +2105,17 @@ bool JSONSaveRec(const JSONNode* const that, FILE* const stream,
   // single array
   bool flagEscapeBracket = (depth == 0 && 
     GSetNbElem(JSONProperties(that)) == 1 && 
-    (JSONLabel(firstProp) == NULL || strlen(JSONLabel(firstProp)) == 0));
+    (JSONLabel(firstProp) == NULL || JSONLabel(firstProp)[0] == '\0'));
   // Print the opening char if the first prop is not a value
   // It's enough to check on the first prop as the json is supposed
   // to be well formed, meaning if the first prop is not a value then
   // all the others too
   if (!JSONIsValue(firstProp) && !flagEscapeBracket) {
-    if (!PBErrPrintf(JSONErr, stream, "%s", openChar))
+    if (!JSONWriterAppendChar(writer, openChar))
       return false;
-    if (!compact && !PBErrPrintf(JSONErr, stream, "%s", "\n")) 
+    if (!compact && !JSONWriterAppendChar(writer, '\n')) 
       return false;
-    if (!compact && flagArrObj && !JSONIndent(stream, depth + 1))
+    if (!compact && flagArrObj && !JSONIndent(writer, depth + 1))
       return false;
   }
   // Declare a flag to manage comma between values
@@ -286,364 +2127,1508 @@ bool JSONSaveRec(const JSONNode* const that, FILE* const stream,
     // If it's not a value (ie not a leaf)
     if (!JSONIsValue(prop)) {
       // Save the property's values
-      if (!JSONSaveRec(prop, stream, compact, depth + 1))
+      if (!JSONSaveRec(prop, writer, compact, depth + 1))
         return false;
       if (!GSetIterIsLast(&iter)) {
-        if (!PBErrPrintf(JSONErr, stream, "%s", ","))
+        if (!JSONWriterAppendChar(writer, ','))
           return false;
       }
-      if (!compact && !PBErrPrintf(JSONErr, stream, "%s", "\n")) 
+      if (!compact && !JSONWriterAppendChar(writer, '\n')) 
         return false;
       if (!compact && flagArrObj && !GSetIterIsLast(&iter) && 
-        !JSONIndent(stream, depth + 1))
+        !JSONIndent(writer, depth + 1))
         return false;
     // Else, it's a value
     } else {
       if (GSetNbElem(JSONProperties(that)) > 1 && GSetIterIsFirst(&iter))
-        if (!PBErrPrintf(JSONErr, stream, "%s", "["))
+        if (!JSONWriterAppendChar(writer, '['))
           return false;
       if (flagComma) {
-        if (!PBErrPrintf(JSONErr, stream, "%s", ","))
-          return false;
-      }
-      if (JSONLabel(prop) != NULL) {
-        if (!PBErrPrintf(JSONErr, stream, "\"%s\"", 
-          JSONLabel(prop)))
-          return false;
-      } else {
-        if (!PBErrPrintf(JSONErr, stream, "%s", "\"\""))
+        if (!JSONWriterAppendChar(writer, ','))
           return false;
       }
+      if (!JSONWriterAppendVal(writer, prop))
+        return false;
       flagComma = true;
       if (GSetNbElem(JSONProperties(that)) > 1 && GSetIterIsLast(&iter))
-        if (!PBErrPrintf(JSONErr, stream, "%s", "]")) 
+        if (!JSONWriterAppendChar(writer, ']')) 
           return false;
     }
   } while (GSetIterStep(&iter));
   // Print the closing char if the first prop is not a value
   if (!JSONIsValue(firstProp) && !flagEscapeBracket) {
-    if (!compact && !JSONIndent(stream, depth)) 
+    if (!compact && !JSONIndent(writer, depth)) 
       return false;
-    if (!PBErrPrintf(JSONErr, stream, "%s", closeChar)) 
+    if (!JSONWriterAppendChar(writer, closeChar)) 
       return false;
   }
-  if (depth == 0 && !PBErrPrintf(JSONErr, stream, "%s", "\n"))
+  if (depth == 0 && !JSONWriterAppendChar(writer, '\n'))
     return false;
   // Return the success code
   return true;
 }
 
-// Scan the 'stream' char by char until the next significant char
-// ie anything else than a space or a new line or a tab or a comma 
-// and store the result in 'c'
-// Return false if there has been an I/O error
-static inline bool JSONGetNextChar(FILE* stream, char* c) {
-  // Loop until the next significant char
-  do {
-    // If we coudln't read the next character
-    if (fscanf(stream, "%c", c) == EOF) {
-      JSONErr->_type = PBErrTypeIOError;
-      sprintf(JSONErr->_msg, 
-        "Premature end of file or fscanf error in JSONGetNextChar");
-      return false;
+// Return true if the char 'c' is insignificant between the tokens of a
+// JSON (space, new line, tab or comma)
+static inline bool JSONIsSpace(const char c) {
+  return (c == ' ' || c == '\n' || c == '\t' || c == ',');
+}
+
+// Return the position of the first significant char of the 'len' bytes
+// of 'buf' from the position 'pos', 'len' if there is none
+static size_t JSONScanSpaceScalar(const char* const buf, size_t pos, 
+  const size_t len) {
+  while (pos < len && JSONIsSpace(buf[pos]))
+    ++pos;
+  return pos;
+}
+
+// Return the position of the first double quote or backslash of the 
+// 'len' bytes of 'buf' from the position 'pos', 'len' if there is none
+static size_t JSONScanQuoteScalar(const char* const buf, size_t pos, 
+  const size_t len) {
+  while (pos < len && buf[pos] != '"' && buf[pos] != '\\')
+    ++pos;
+  return pos;
+}
+
+// Return the position of the first char of the 'len' bytes of 'buf' 
+// from the position 'pos' which must be escaped in a JSON string 
+// (double quote, backslash or control char), 'len' if there is none
+static size_t JSONScanEscapeScalar(const char* const buf, size_t pos, 
+  const size_t len) {
+  while (pos < len && buf[pos] != '"' && buf[pos] != '\\' && 
+    (unsigned char)(buf[pos]) >= 0x20)
+    ++pos;
+  return pos;
+}
+
+#ifdef PBJSON_X86
+// Vectorized version of JSONScanSpaceScalar, 16 bytes at a time
+__attribute__((target("sse2")))
+static size_t JSONScanSpaceSSE2(const char* const buf, size_t pos, 
+  const size_t len) {
+  const __m128i space = _mm_set1_epi8(' ');
+  const __m128i newLine = _mm_set1_epi8('\n');
+  const __m128i tab = _mm_set1_epi8('\t');
+  const __m128i comma = _mm_set1_epi8(',');
+  while (pos + 16 <= len) {
+    // Get the mask of the significant chars among the next 16 ones
+    __m128i v = _mm_loadu_si128((const __m128i*)(buf + pos));
+    __m128i isSpace = _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi8(v, space), _mm_cmpeq_epi8(v, newLine)),
+      _mm_or_si128(_mm_cmpeq_epi8(v, tab), _mm_cmpeq_epi8(v, comma)));
+    unsigned int mask = ~(unsigned int)_mm_movemask_epi8(isSpace) & 0xFFFFU;
+    if (mask != 0)
+      return pos + (size_t)__builtin_ctz(mask);
+    pos += 16;
+  }
+  // Scan the remaining bytes one by one
+  return JSONScanSpaceScalar(buf, pos, len);
+}
+
+// Vectorized version of JSONScanQuoteScalar, 16 bytes at a time
+__attribute__((target("sse2")))
+static size_t JSONScanQuoteSSE2(const char* const buf, size_t pos, 
+  const size_t len) {
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  while (pos + 16 <= len) {
+    // Get the mask of the double quotes and backslashes among the next
+    // 16 chars
+    __m128i v = _mm_loadu_si128((const __m128i*)(buf + pos));
+    __m128i isQuote = _mm_or_si128(_mm_cmpeq_epi8(v, quote), 
+      _mm_cmpeq_epi8(v, backslash));
+    unsigned int mask = (unsigned int)_mm_movemask_epi8(isQuote);
+    if (mask != 0)
+      return pos + (size_t)__builtin_ctz(mask);
+    pos += 16;
+  }
+  // Scan the remaining bytes one by one
+  return JSONScanQuoteScalar(buf, pos, len);
+}
+
+// Vectorized version of JSONScanEscapeScalar, 16 bytes at a time
+__attribute__((target("sse2")))
+static size_t JSONScanEscapeSSE2(const char* const buf, size_t pos, 
+  const size_t len) {
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i control = _mm_set1_epi8(0x1F);
+  while (pos + 16 <= len) {
+    // Get the mask of the chars to escape among the next 16 ones, the 
+    // control chars being the ones unchanged by an unsigned min with 
+    // 0x1F
+    __m128i v = _mm_loadu_si128((const __m128i*)(buf + pos));
+    __m128i isEscape = _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi8(v, quote), 
+        _mm_cmpeq_epi8(v, backslash)),
+      _mm_cmpeq_epi8(_mm_min_epu8(v, control), v));
+    unsigned int mask = (unsigned int)_mm_movemask_epi8(isEscape);
+    if (mask != 0)
+      return pos + (size_t)__builtin_ctz(mask);
+    pos += 16;
+  }
+  // Scan the remaining bytes one by one
+  return JSONScanEscapeScalar(buf, pos, len);
+}
+
+// Vectorized version of JSONScanSpaceScalar, 32 bytes at a time
+__attribute__((target("avx2")))
+static size_t JSONScanSpaceAVX2(const char* const buf, size_t pos, 
+  const size_t len) {
+  const __m256i space = _mm256_set1_epi8(' ');
+  const __m256i newLine = _mm256_set1_epi8('\n');
+  const __m256i tab = _mm256_set1_epi8('\t');
+  const __m256i comma = _mm256_set1_epi8(',');
+  while (pos + 32 <= len) {
+    // Get the mask of the significant chars among the next 32 ones
+    __m256i v = _mm256_loadu_si256((const __m256i*)(buf + pos));
+    __m256i isSpace = _mm256_or_si256(
+      _mm256_or_si256(_mm256_cmpeq_epi8(v, space), 
+        _mm256_cmpeq_epi8(v, newLine)),
+      _mm256_or_si256(_mm256_cmpeq_epi8(v, tab), 
+        _mm256_cmpeq_epi8(v, comma)));
+    unsigned int mask = ~(unsigned int)_mm256_movemask_epi8(isSpace);
+    if (mask != 0)
+      return pos + (size_t)__builtin_ctz(mask);
+    pos += 32;
+  }
+  // Scan the remaining bytes one by one
+  return JSONScanSpaceScalar(buf, pos, len);
+}
+
+// Vectorized version of JSONScanQuoteScalar, 32 bytes at a time
+__attribute__((target("avx2")))
+static size_t JSONScanQuoteAVX2(const char* const buf, size_t pos, 
+  const size_t len) {
+  const __m256i quote = _mm256_set1_epi8('"');
+  const __m256i backslash = _mm256_set1_epi8('\\');
+  while (pos + 32 <= len) {
+    // Get the mask of the double quotes and backslashes among the next
+    // 32 chars
+    __m256i v = _mm256_loadu_si256((const __m256i*)(buf + pos));
+    __m256i isQuote = _mm256_or_si256(_mm256_cmpeq_epi8(v, quote), 
+      _mm256_cmpeq_epi8(v, backslash));
+    unsigned int mask = (unsigned int)_mm256_movemask_epi8(isQuote);
+    if (mask != 0)
+      return pos + (size_t)__builtin_ctz(mask);
+    pos += 32;
+  }
+  // Scan the remaining bytes one by one
+  return JSONScanQuoteScalar(buf, pos, len);
+}
+// Vectorized version of JSONScanEscapeScalar, 32 bytes at a time
+__attribute__((target("avx2")))
+static size_t JSONScanEscapeAVX2(const char* const buf, size_t pos, 
+  const size_t len) {
+  const __m256i quote = _mm256_set1_epi8('"');
+  const __m256i backslash = _mm256_set1_epi8('\\');
+  const __m256i control = _mm256_set1_epi8(0x1F);
+  while (pos + 32 <= len) {
+    // Get the mask of the chars to escape among the next 32 ones
+    __m256i v = _mm256_loadu_si256((const __m256i*)(buf + pos));
+    __m256i isEscape = _mm256_or_si256(
+      _mm256_or_si256(_mm256_cmpeq_epi8(v, quote), 
+        _mm256_cmpeq_epi8(v, backslash)),
+      _mm256_cmpeq_epi8(_mm256_min_epu8(v, control), v));
+    unsigned int mask = (unsigned int)_mm256_movemask_epi8(isEscape);
+    if (mask != 0)
+      return pos + (size_t)__builtin_ctz(mask);
+    pos += 32;
+  }
+  // Scan the remaining bytes one by one
+  return JSONScanEscapeScalar(buf, pos, len);
+}
+
+#endif
+
+// Return the best instruction set supported by the processor to scan 
+// the JSONs
+static JSONSimd JSONSimdGetBest(void) {
+#ifdef PBJSON_X86
+  if (__builtin_cpu_supports("avx2"))
+    return JSONSimdAVX2;
+  if (__builtin_cpu_supports("sse2"))
+    return JSONSimdSSE2;
+#endif
+  return JSONSimdScalar;
+}
+
+// Select the scan kernels for the instruction set 'simd'
+static void JSONSimdUse(const JSONSimd simd) {
+  JSONSimdCur = simd;
+  switch (simd) {
+#ifdef PBJSON_X86
+    case JSONSimdAVX2:
+      JSONScanSpace = JSONScanSpaceAVX2;
+      JSONScanQuote = JSONScanQuoteAVX2;
+      JSONScanEscape = JSONScanEscapeAVX2;
+      break;
+    case JSONSimdSSE2:
+      JSONScanSpace = JSONScanSpaceSSE2;
+      JSONScanQuote = JSONScanQuoteSSE2;
+      JSONScanEscape = JSONScanEscapeSSE2;
+      break;
+#endif
+    default:
+      JSONSimdCur = JSONSimdScalar;
+      JSONScanSpace = JSONScanSpaceScalar;
+      JSONScanQuote = JSONScanQuoteScalar;
+      JSONScanEscape = JSONScanEscapeScalar;
+      break;
+  }
+}
+
+// Select the scan kernels for the best instruction set supported by the
+// processor
+static void JSONSimdInit(void) {
+  JSONSimdUse(JSONSimdGetBest());
+}
+
+// Return the instruction set used to scan the JSONs being loaded, by 
+// default the best one supported by the processor
+JSONSimd JSONGetSimd(void) {
+  pthread_once(&JSONSimdOnce, JSONSimdInit);
+  return JSONSimdCur;
+}
+
+// Use the instruction set 'simd' to scan the JSONs being loaded, or the
+// best one supported by the processor if it doesn't support 'simd'
+// Must not be called while JSONs are being loaded
+// Return the instruction set actually used
+JSONSimd JSONSetSimd(const JSONSimd simd) {
+  pthread_once(&JSONSimdOnce, JSONSimdInit);
+  JSONSimd best = JSONSimdGetBest();
+  JSONSimdUse(simd < best ? simd : best);
+  return JSONSimdCur;
+}
+
+// Initialise the reader 'that' on the stream 'stream'
+static void JSONReaderInitStream(JSONReader* const that, 
+  FILE* const stream) {
+  pthread_once(&JSONSimdOnce, JSONSimdInit);
+  that->_stream = stream;
+  that->_buf = that->_block;
+  that->_len = 0;
+  that->_pos = 0;
+  JSONStrBufInit(&(that->_scratch));
+  // Terminals, pipes and sockets are read line by line to avoid 
+  // waiting for bytes which may never come after the JSON. Other 
+  // streams (regular files, memory streams without file descriptor) 
+  // are read by full blocks
+  that->_flagReuse = false;
+  that->_map = NULL;
+  that->_mapLen = 0;
+  that->_arenaLazy = NULL;
+  that->_nbRead = 0;
+  that->_depth = 0;
+  that->_depthMax = 0;
+  that->_blockMode = true;
+  struct stat st;
+  int fd = fileno(stream);
+  if (fd >= 0 && fstat(fd, &st) == 0 && 
+    (S_ISCHR(st.st_mode) || S_ISFIFO(st.st_mode) || 
+    S_ISSOCK(st.st_mode)))
+    that->_blockMode = false;
+}
+
+// Initialise the reader 'that' on the 'len' bytes of the buffer 'buf'
+static void JSONReaderInitBuffer(JSONReader* const that, 
+  const char* const buf, const size_t len) {
+  pthread_once(&JSONSimdOnce, JSONSimdInit);
+  that->_stream = NULL;
+  that->_flagReuse = false;
+  that->_map = NULL;
+  that->_mapLen = 0;
+  that->_arenaLazy = NULL;
+  that->_nbRead = 0;
+  that->_depth = 0;
+  that->_depthMax = 0;
+  that->_blockMode = true;
+  that->_buf = buf;
+  that->_len = len;
+  that->_pos = 0;
+  JSONStrBufInit(&(that->_scratch));
+}
+
+// Read the next block of bytes from the stream of the reader 'that'
+// Return false if there is no more byte available
+static bool JSONReaderFill(JSONReader* const that) {
+  // If the reader is on a buffer there is nothing more to read
+  if (that->_stream == NULL)
+    return false;
+  // The bytes of the current block have been consumed
+  that->_nbRead += that->_pos;
+  double start = JSONStatsClock();
+  // Declare a variable to memorize the number of bytes read
+  size_t nb = 0;
+  // If the stream can be read by block
+  if (that->_blockMode) {
+    nb = fread(that->_block, sizeof(char), PBJSON_BLOCKSIZE, 
+      that->_stream);
+  // Else, read up to the end of the current line
+  } else {
+    int c = EOF;
+    while (nb < PBJSON_BLOCKSIZE && c != '\n' && 
+      (c = getc(that->_stream)) != EOF) {
+      that->_block[nb] = (char)c;
+      ++nb;
     }
-  } while (*c == ' ' || *c == '\n' || *c == '\t' || *c == ',');
+  }
+  JSONStatsAddTime(&(JSONStatsCur._timeRead), start);
+  // Update the available bytes
+  that->_buf = that->_block;
+  that->_len = nb;
+  that->_pos = 0;
+  // Return true if we could read something
+  return (nb > 0);
+}
+
+// Give back to the stream of the reader 'that' the bytes which have 
+// been read in advance but not consumed
+static void JSONReaderRelease(JSONReader* const that) {
+  // If the reader is on a stream and some bytes have not been 
+  // consumed, move back the stream to the first unconsumed byte
+  // If the stream is not seekable the bytes are lost, but in that 
+  // case they are at most the end of the current line
+  if (that->_stream != NULL && that->_pos < that->_len) {
+    int ret = fseek(that->_stream, 
+      -(long)(that->_len - that->_pos), SEEK_CUR);
+    (void)ret;
+  }
+  // Update the statistics with the bytes consumed and the depth
+  JSONStatsCur._nbByteRead += that->_nbRead + that->_pos;
+  if (that->_depthMax > JSONStatsCur._depthMax)
+    JSONStatsCur._depthMax = that->_depthMax;
+  that->_nbRead = 0;
+  that->_depthMax = 0;
+  that->_len = 0;
+  that->_pos = 0;
+  JSONStrBufFree(&(that->_scratch));
+}
+
+// Get the next char from the reader 'reader' and store it in 'c'
+// Return false if there is no more char available
+static inline bool JSONReaderGetChar(JSONReader* const reader, 
+  char* const c) {
+  // If all the available bytes have been consumed, get the next ones
+  if (reader->_pos >= reader->_len && !JSONReaderFill(reader))
+    return false;
+  // Get the char and move the cursor
+  *c = reader->_buf[reader->_pos];
+  ++(reader->_pos);
   // Return the success code
   return true;
 }
 
-// Load the string 'str' from the 'stream'
+// Scan the 'reader' until the next significant char ie anything else 
+// than a space or a new line or a tab or a comma, skipping runs of 
+// insignificant chars with JSONScanSpace, and store the result in 'c'
 // Return false if there has been an I/O error
-bool JSONLoadStr(FILE* stream, char* str) {
-  // Declare a variable ot memorize the position in the string
-  int i = 0;
-  // Declare a flag to manage escape character
-  bool flagEsc = false;
-  // Loop on character of the string
-  do {
-    // If the previous char was an escaped char 
-    if (flagEsc && i > 0 && str[i - 1] == '"')
-      // Reset the flag
-      flagEsc = false;
-    // Read one character
-    if (fscanf(stream, "%c", str + i) == EOF) {
+static inline bool JSONGetNextChar(JSONReader* const reader, 
+  char* const c) {
+  // Loop until the next significant char
+  while (true) {
+    // If all the available bytes have been consumed, get the next ones
+    if (reader->_pos >= reader->_len && !JSONReaderFill(reader)) {
       JSONErr->_type = PBErrTypeIOError;
       sprintf(JSONErr->_msg, 
-        "Premature end of file or fscanf error in JSONLoadStr");
+        "Premature end of file or read error in JSONGetNextChar");
       return false;
     }
-    // If it's an escape char
-    if (str[i] == '\\')
-      // Set the flag
-      flagEsc = true;
-    // Increment the position in the string
-    ++i;
-  // Loop until the buffer is full or we reached the final double quote
-  } while ((flagEsc || str[i - 1] != '"') && i < PBJSON_MAXLENGTHLBL);
-  // Add the null character at the end of the string
-  str[i - 1] = '\0';
-  // Return the success code
-  return true;
+    // Consume the next char, and stop if it's significant
+    *c = reader->_buf[reader->_pos];
+    ++(reader->_pos);
+    if (!JSONIsSpace(*c))
+      return true;
+    // Skip the insignificant chars following it in the available bytes
+    reader->_pos = JSONScanSpace(reader->_buf, reader->_pos, reader->_len);
+  }
 }
 
-// Load the array of values of property 'prop' in the JSON 'that' 
-// Return true if it could load, false else
-bool JSONAddArr(JSONNode* const that, char* prop, FILE* stream) {
-  // Declare the array of values
-  JSONArrayVal set = JSONArrayValCreateStatic();
-  // Declare a buffer for the value
-  char bufferValue[PBJSON_MAXLENGTHLBL + 1] = {'\0'};
-  // Declare a char to memorize the next significant char
-  char c = '\0';
+// Initialise the growable string 'that' to the empty string
+static inline void JSONStrBufInit(JSONStrBuf* const that) {
+  that->_str = that->_local;
+  that->_len = 0;
+  that->_size = PBJSON_STRBUFSIZE;
+  that->_str[0] = '\0';
+}
+
+// Free the memory used by the growable string 'that'
+static inline void JSONStrBufFree(JSONStrBuf* const that) {
+  if (that->_str != that->_local)
+    free(that->_str);
+  JSONStrBufInit(that);
+}
+
+// Reserve room in the growable string 'that' for 'len' more chars
+static void JSONStrBufReserve(JSONStrBuf* const that, const size_t len) {
+  // If there is not enough room for the new chars
+  if (that->_len + len + 1 > that->_size) {
+    // Double the size until it's large enough
+    size_t size = that->_size;
+    while (that->_len + len + 1 > size)
+      size *= 2;
+    char* ptr = PBErrMalloc(JSONErr, sizeof(char) * size);
+    memcpy(ptr, that->_str, sizeof(char) * that->_len);
+    if (that->_str != that->_local)
+      free(that->_str);
+    that->_str = ptr;
+    that->_size = size;
+  }
+}
+
+// Append the 'len' chars of 'str' to the growable string 'that'
+static void JSONStrBufAppend(JSONStrBuf* const that, 
+  const char* const str, const size_t len) {
+  JSONStrBufReserve(that, len);
+  // Append the chars
+  memcpy(that->_str + that->_len, str, sizeof(char) * len);
+  that->_len += len;
+  that->_str[that->_len] = '\0';
+}
+
+// Read the 4 hexadecimal digits at the beginning of the 'len' chars of 
+// 'str' into '*code'
+// Return false if they are not 4 hexadecimal digits
+static bool JSONReadHex4(const char* const str, const size_t len, 
+  uint32_t* const code) {
+  if (len < 4)
+    return false;
+  *code = 0;
+  for (int i = 0; i < 4; ++i) {
+    char c = str[i];
+    uint32_t digit = 0;
+    if (c >= '0' && c <= '9')
+      digit = (uint32_t)(c - '0');
+    else if (c >= 'a' && c <= 'f')
+      digit = (uint32_t)(c - 'a' + 10);
+    else if (c >= 'A' && c <= 'F')
+      digit = (uint32_t)(c - 'A' + 10);
+    else
+      return false;
+    *code = (*code << 4) | digit;
+  }
+  return true;
+}
+
+// Set the error for an invalid escape sequence
+// Return false
+static bool JSONUnescapeInvalid(void) {
+  JSONErr->_type = PBErrTypeInvalidData;
+  sprintf(JSONErr->_msg, "JSONUnescape: Invalid escape sequence");
+  return false;
+}
+
+// Decode the escape sequences of the 'len' chars of 'src', the content 
+// of a JSON string, into 'dst' and set '*lenDst' to the number of 
+// decoded chars. The runs of chars without escape sequence are copied 
+// at once. '\uXXXX' sequences are converted to UTF-8, lone surrogates 
+// to U+FFFD. '\u0000' is rejected, it would truncate the null 
+// terminated label. The decoded string is never longer than 'src', and 
+// 'dst' can be equal to 'src'
+// Return false and set JSONErr if there is an invalid escape sequence
+static bool JSONUnescape(char* const dst, const char* const src, 
+  const size_t len, size_t* const lenDst) {
+  size_t iSrc = 0;
+  size_t iDst = 0;
+  while (true) {
+    // Copy the run of chars up to the next escape char, the double 
+    // quotes of the content of a string are all escaped so JSONScanQuote
+    // only stops on escape chars
+    size_t end = JSONScanQuote(src, iSrc, len);
+    if (dst + iDst != src + iSrc)
+      memmove(dst + iDst, src + iSrc, end - iSrc);
+    iDst += end - iSrc;
+    iSrc = end;
+    if (iSrc >= len)
+      break;
+    if (iSrc + 1 >= len)
+      return JSONUnescapeInvalid();
+    // Decode the escape sequence
+    char c = src[iSrc + 1];
+    iSrc += 2;
+    switch (c) {
+      case '"':
+      case '\\':
+      case '/':
+        dst[iDst++] = c;
+        break;
+      case 'b':
+        dst[iDst++] = '\b';
+        break;
+      case 'f':
+        dst[iDst++] = '\f';
+        break;
+      case 'n':
+        dst[iDst++] = '\n';
+        break;
+      case 'r':
+        dst[iDst++] = '\r';
+        break;
+      case 't':
+        dst[iDst++] = '\t';
+        break;
+      case 'u': {
+        uint32_t code = 0;
+        if (!JSONReadHex4(src + iSrc, len - iSrc, &code))
+          return JSONUnescapeInvalid();
+        iSrc += 4;
+        // The labels are null terminated, a null char would silently 
+        // truncate the string
+        if (code == 0) {
+          JSONErr->_type = PBErrTypeInvalidData;
+          sprintf(JSONErr->_msg, 
+            "JSONUnescape: '\\u0000' can't be stored in a label");
+          return false;
+        }
+        // A high surrogate must be followed by a low one, together they
+        // make a code point above U+FFFF
+        uint32_t low = 0;
+        if (code >= 0xD800 && code <= 0xDBFF) {
+          if (iSrc + 6 <= len && src[iSrc] == '\\' && 
+            src[iSrc + 1] == 'u' && 
+            JSONReadHex4(src + iSrc + 2, len - iSrc - 2, &low) &&
+            low >= 0xDC00 && low <= 0xDFFF) {
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+            iSrc += 6;
+          } else {
+            code = 0xFFFD;
+          }
+        } else if (code >= 0xDC00 && code <= 0xDFFF) {
+          code = 0xFFFD;
+        }
+        // Encode the code point in UTF-8
+        if (code < 0x80) {
+          dst[iDst++] = (char)code;
+        } else if (code < 0x800) {
+          dst[iDst++] = (char)(0xC0 | (code >> 6));
+          dst[iDst++] = (char)(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+          dst[iDst++] = (char)(0xE0 | (code >> 12));
+          dst[iDst++] = (char)(0x80 | ((code >> 6) & 0x3F));
+          dst[iDst++] = (char)(0x80 | (code & 0x3F));
+        } else {
+          dst[iDst++] = (char)(0xF0 | (code >> 18));
+          dst[iDst++] = (char)(0x80 | ((code >> 12) & 0x3F));
+          dst[iDst++] = (char)(0x80 | ((code >> 6) & 0x3F));
+          dst[iDst++] = (char)(0x80 | (code & 0x3F));
+        }
+        break;
+      }
+      default:
+        return JSONUnescapeInvalid();
+    }
+  }
+  *lenDst = iDst;
+  return true;
+}
+
+// Load a string from the 'reader', up to its closing double quote, and 
+// decode its escape sequences
+// On success '*str' points to the '*len' chars of the string, which 
+// are not null terminated and stay valid until the next read on the 
+// reader
+// Return false if there has been an I/O error or an invalid escape 
+// sequence
+bool JSONLoadStr(JSONReader* const reader, const char** const str, 
+  size_t* const len) {
+  // Declare a flag to manage escape character, a double quote after an
+  // escape char is part of the string
+  bool flagEsc = false;
+  // Declare a flag to memorize if the string spans several blocks and 
+  // is accumulated in the scratch buffer
+  bool flagScratch = false;
+  // Declare a flag to memorize if the string contains escape sequences
+  // to decode
+  bool flagDecode = false;
+  // Loop until the closing double quote
+  while (true) {
+    // Scan the available bytes for the closing double quote, jumping 
+    // from one double quote or backslash to the next one
+    const char* buf = reader->_buf;
+    size_t start = reader->_pos;
+    size_t i = start;
+    // If the previous bytes ended with an escape char, skip the escaped
+    // char
+    if (flagEsc && i < reader->_len) {
+      ++i;
+      flagEsc = false;
+    }
+    while (true) {
+      i = JSONScanQuote(buf, i, reader->_len);
+      if (i >= reader->_len || buf[i] == '"')
+        break;
+      // Skip the escape char and the escaped char
+      flagDecode = true;
+      if (i + 1 < reader->_len) {
+        i += 2;
+      } else {
+        flagEsc = true;
+        i = reader->_len;
+        break;
+      }
+    }
+    // If we have found the closing double quote
+    if (i < reader->_len) {
+      // Consume the string and its closing double quote
+      reader->_pos = i + 1;
+      // If the string is entirely in the available bytes and has no 
+      // escape sequence
+      if (!flagScratch && !flagDecode) {
+        // Return a pointer directly on the bytes of the reader
+        *str = buf + start;
+        *len = i - start;
+        return true;
+      }
+      // If the string is entirely in the available bytes, decode it 
+      // from them into the scratch buffer
+      bool ret = true;
+      JSONStrBuf* scratch = &(reader->_scratch);
+      if (!flagScratch) {
+        scratch->_len = 0;
+        JSONStrBufReserve(scratch, i - start);
+        ret = JSONUnescape(scratch->_str, buf + start, i - start, 
+          &(scratch->_len));
+      // Else, complete the string in the scratch buffer and decode it in 
+      // place if necessary
+      } else {
+        JSONStrBufAppend(scratch, buf + start, i - start);
+        if (flagDecode)
+          ret = JSONUnescape(scratch->_str, scratch->_str, scratch->_len,
+            &(scratch->_len));
+      }
+      // JSONUnescape has set the error
+      if (!ret)
+        return false;
+      scratch->_str[scratch->_len] = '\0';
+      *str = scratch->_str;
+      *len = scratch->_len;
+      // Return the success code
+      return true;
+    }
+    // The string continues after the available bytes, memorize them in
+    // the scratch buffer
+    if (!flagScratch) {
+      reader->_scratch._len = 0;
+      flagScratch = true;
+    }
+    JSONStrBufAppend(&(reader->_scratch), buf + start, i - start);
+    reader->_pos = i;
+    // Get the next bytes
+    if (!JSONReaderFill(reader)) {
+      JSONErr->_type = PBErrTypeIOError;
+      sprintf(JSONErr->_msg, 
+        "Premature end of file or read error in JSONLoadStr");
+      return false;
+    }
+  }
+}
+
+// Skip the object or array whose opening char has just been consumed 
+// from the 'reader', up to its matching closing char, without loading
+// nor checking its content
+// On success '*first' is set to the first significant char after the 
+// opening one, and '*span' and '*len' to the bytes of the object or 
+// array. They are borrowed from the file mapped by the reader if they 
+// lie in it, else they are copied in the arena 'arena'. If 'arena' is 
+// NULL the bytes are only skipped and 'span' and 'len' are not used
+// Return false if the bytes end before the closing char
+static bool JSONLoadSkip(JSONReader* const reader, 
+  JSONArena* const arena, char** const span, size_t* const len, 
+  char* const first) {
+  // Declare the depth of nested objects and arrays, the opening char 
+  // being already consumed
+  long depth = 1;
+  // Declare a flag to memorize if the scan is in a string, where the 
+  // brackets are ignored, and a flag to manage escape character as in
+  // JSONLoadStr
+  bool flagStr = false;
+  bool flagEsc = false;
+  *first = '\0';
+  // Declare a buffer to accumulate the bytes if they span several 
+  // blocks, and the position of the first byte of the object or array
+  // in the available bytes
+  JSONStrBuf acc;
+  bool flagAcc = false;
+  size_t start = reader->_pos - 1;
+  // Loop until the closing char
+  while (true) {
+    // Scan the available bytes
+    const char* buf = reader->_buf;
+    size_t i = reader->_pos;
+    while (i < reader->_len && depth > 0) {
+      // If the scan is in a string, jump to its next double quote or 
+      // backslash
+      if (flagStr) {
+        if (flagEsc) {
+          flagEsc = false;
+          ++i;
+          continue;
+        }
+        i = JSONScanQuote(buf, i, reader->_len);
+        if (i >= reader->_len)
+          break;
+        if (buf[i] == '\\')
+          flagEsc = true;
+        else
+          flagStr = false;
+        ++i;
+        continue;
+      }
+      // Else, update the depth on brackets and look for strings
+      char c = buf[i];
+      if (*first == '\0' && !JSONIsSpace(c))
+        *first = c;
+      switch (c) {
+        case '"':
+          flagStr = true;
+          break;
+        case '{':
+        case '[':
+          ++depth;
+          break;
+        case '}':
+        case ']':
+          --depth;
+          break;
+        default:
+          break;
+      }
+      ++i;
+    }
+    // If we have found the closing char
+    if (depth == 0) {
+      // Consume the object or array
+      reader->_pos = i;
+      if (arena == NULL)
+        return true;
+      // Get its bytes
+      const char* bytes = buf + start;
+      *len = i - start;
+      if (flagAcc) {
+        JSONStrBufAppend(&acc, buf, i);
+        bytes = acc._str;
+        *len = acc._len;
+      }
+      // If they lie in the mapped file, borrow them, else copy them in
+      // the arena
+      if (!flagAcc && reader->_map != NULL && bytes >= reader->_map && 
+        bytes < reader->_map + reader->_mapLen) {
+        *span = reader->_map + (bytes - reader->_map);
+      } else {
+        *span = JSONArenaAlloc(arena, *len);
+        memcpy(*span, bytes, *len);
+      }
+      if (flagAcc)
+        JSONStrBufFree(&acc);
+      // Return the success code
+      return true;
+    }
+    // The object or array continues after the available bytes, 
+    // memorize them
+    if (arena != NULL) {
+      if (!flagAcc) {
+        JSONStrBufInit(&acc);
+        flagAcc = true;
+      }
+      JSONStrBufAppend(&acc, buf + start, reader->_len - start);
+    }
+    start = 0;
+    reader->_pos = reader->_len;
+    // Get the next bytes
+    if (!JSONReaderFill(reader)) {
+      if (flagAcc)
+        JSONStrBufFree(&acc);
+      JSONErr->_type = PBErrTypeIOError;
+      sprintf(JSONErr->_msg, 
+        "Premature end of file or read error in JSONLoadSkip");
+      return false;
+    }
+  }
+}
+
+// Return true if the char 'c' can start a number, a boolean or null
+static inline bool JSONIsScalarStart(const char c) {
+  return ((c >= '0' && c <= '9') || c == '-' || 
+    c == 't' || c == 'f' || c == 'n');
+}
+
+// Return true if the char 'c' can be part of a number, a boolean or 
+// null
+static inline bool JSONIsScalarChar(const char c) {
+  return ((c >= '0' && c <= '9') || c == '.' || c == '-' || c == '+' ||
+    (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'));
+}
+
+// Read the chars of a number, a boolean or null from the 'reader', 
+// 'first' being its first char already consumed, into the 'tok' null 
+// terminated string of PBJSON_SCALARSIZE chars, and set '*len' to its 
+// length
+// Return false if the value is too long
+static bool JSONReadScalar(JSONReader* const reader, const char first,
+  char* const tok, size_t* const len) {
+  // Copy the chars of the value, up to the first char which can't be 
+  // part of it
+  *len = 0;
+  tok[(*len)++] = first;
+  while (reader->_pos < reader->_len || JSONReaderFill(reader)) {
+    char c = reader->_buf[reader->_pos];
+    if (!JSONIsScalarChar(c))
+      break;
+    if (*len == PBJSON_SCALARSIZE - 1) {
+      tok[*len] = '\0';
+      JSONErr->_type = PBErrTypeInvalidData;
+      sprintf(JSONErr->_msg, "JSONLoadScalar: Value too long '%s...'", 
+        tok);
+      return false;
+    }
+    tok[(*len)++] = c;
+    ++(reader->_pos);
+  }
+  tok[*len] = '\0';
+  // Return the success code
+  return true;
+}
+
+// Load a number, a boolean or null from the 'reader', 'first' being 
+// its first char already consumed. On success '*type' and '*val' are 
+// set to its type and native value
+// Return false if it's not a valid value
+static bool JSONLoadScalar(JSONReader* const reader, const char first,
+  JSONType* const type, JSONPayload* const val) {
+  char tok[PBJSON_SCALARSIZE];
+  size_t len = 0;
+  return JSONReadScalar(reader, first, tok, &len) && 
+    JSONScanScalar(tok, len, type, val);
+}
+
+// Convert the 'len' chars of the null terminated string 'tok' to a 
+// number, a boolean or null. On success '*type' and '*val' are set to 
+// its type and native value
+// Return false if it's not a valid value
+static bool JSONScanScalar(const char* const tok, const size_t len,
+  JSONType* const type, JSONPayload* const val) {
+  // Convert the value
+  bool flagValid = false;
+  if (strcmp(tok, "true") == 0 || strcmp(tok, "false") == 0) {
+    *type = JSONTypeBool;
+    val->_bool = (tok[0] == 't');
+    flagValid = true;
+  } else if (strcmp(tok, "null") == 0) {
+    *type = JSONTypeNull;
+    val->_int = 0;
+    flagValid = true;
+  } else if (tok[0] != 't' && tok[0] != 'f' && tok[0] != 'n') {
+    flagValid = JSONScanNumber(tok, len, type, val);
+  }
+  if (!flagValid) {
+    JSONErr->_type = PBErrTypeInvalidData;
+    sprintf(JSONErr->_msg, "JSONLoadScalar: Invalid value '%s'", tok);
+    return false;
+  }
+  // Return the success code
+  return true;
+}
+
+// Initialise the cursor 'that' on the children of the node 'node' 
+// loaded from the reader 'reader'
+static inline void JSONLoadCursorInit(JSONLoadCursor* const that, 
+  JSONNode* const node, const JSONReader* const reader) {
+  that->_node = node;
+  that->_nb = 0;
+  that->_flagReuse = reader->_flagReuse;
+  that->_iter = GSetIterForwardCreateStatic(JSONProperties(node));
+  that->_flagIter = (reader->_flagReuse && JSONGetNbValue(node) > 0);
+  that->_map = reader->_map;
+  that->_mapLen = reader->_mapLen;
+}
+
+// Return the next child of the cursor 'that'
+// If the existing children are reused, return the next existing child, 
+// else create a new child and append it to the node of the cursor
+static inline JSONNode* JSONLoadCursorNext(JSONLoadCursor* const that) {
+  ++(that->_nb);
+  // If there is an existing child to reuse
+  if (that->_flagIter) {
+    JSONNode* child = GSetIterGet(&(that->_iter));
+    that->_flagIter = GSetIterStep(&(that->_iter));
+    return child;
+  }
+  // Else, create a new child
+  JSONNode* child = JSONCreateChild(that->_node);
+  JSONAppendVal(that->_node, child);
+  return child;
+}
+
+// End the loading of the children of the cursor 'that'
+// If the existing children are reused, the ones which have not been 
+// reused are released
+static inline void JSONLoadCursorEnd(JSONLoadCursor* const that) {
+  if (that->_flagReuse && JSONGetNbValue(that->_node) > that->_nb)
+    JSONLoadTrim(that->_node, that->_nb);
+}
+
+// Release the children of the node 'that' after the 'nb' first ones
+static void JSONLoadTrim(JSONNode* const that, const long nb) {
+  // Release the children from the last one
+  while (JSONGetNbValue(that) > nb) {
+    JSONNode* child = GSetDrop(JSONProperties(that));
+    JSONFreeArenaRec(child);
+  }
+  // The index and the serialization of the node are not valid anymore
+  JSONIndexInvalidate(that, true);
+  JSONCacheInvalidate(that);
+}
+
+// Set the label of the node 'that', child of the cursor 'cursor', to 
+// the 'lenPrefix' chars of 'prefix' followed by the 'len' chars of 
+// 'str'. If 'str' is NULL the node has no label.
+// If the nodes are reused the label is left unchanged if it's the 
+// same, or overwritten if its storage is large enough
+// If the cursor is on a mapped file and 'str' lies in the mapping, the
+// new label borrows its chars instead of copying them
+static void JSONLoadSetLabel(const JSONLoadCursor* const cursor, 
+  JSONNode* const that, const char* const prefix, 
+  const size_t lenPrefix, const char* const str, const size_t len) {
+  JSONLbl* lbl = (JSONLbl*)GenTreeData(that);
+  // If the nodes are reused and the node has already a JSONLbl
+  if (cursor->_flagReuse && lbl != NULL) {
+    // If the label is the same, there is nothing to do
+    if (str == NULL && lbl->_str == NULL && lbl->_type == JSONTypeStr)
+      return;
+    if (str != NULL && lbl->_str != NULL && 
+      memcmp(lbl->_str, prefix, lenPrefix) == 0 && 
+      memcmp(lbl->_str + lenPrefix, str, len) == 0 && 
+      lbl->_str[lenPrefix + len] == '\0')
+      return;
+    // The label changes, the hash table of the index of the parent is 
+    // not valid anymore. Only this index depends on the label
+    JSONIndexInvalidate(cursor->_node, false);
+    // The serialization of the node changes too
+    JSONCacheInvalidate(that);
+    lbl->_type = JSONTypeStr;
+    lbl->_flagBorrowed = false;
+    // If the node must have no label
+    if (str == NULL) {
+      lbl->_str = NULL;
+      return;
+    }
+    // If the storage of the label is large enough, overwrite it. A 
+    // JSONLbl with a '_size' of 0 may have no storage at all, not even 
+    // for the null char (cf JSONArenaCreateNode and JSONGetLbl)
+    if (lbl->_size > 0 && lenPrefix + len <= lbl->_size) {
+      lbl->_str = (char*)(lbl + 1);
+    // Else, replace the JSONLbl with a larger one
+    } else {
+      JSONLbl* newLbl = JSONLblCreate(that, lenPrefix + len);
+      JSONLblReplace(that, newLbl);
+      lbl = newLbl;
+    }
+    memcpy(lbl->_str, prefix, sizeof(char) * lenPrefix);
+    memcpy(lbl->_str + lenPrefix, str, sizeof(char) * len);
+    lbl->_str[lenPrefix + len] = '\0';
+    return;
+  }
+  // Else, if the label can be borrowed from the mapped file, the node
+  // being in the arena owning the mapping, its JSONLbl without label 
+  // points directly to the chars of the mapping. They are null 
+  // terminated in place, over the closing double quote of the string
+  // which has already been consumed
+  if (str != NULL && cursor->_map != NULL && lenPrefix == 0 && 
+    str >= cursor->_map && str < cursor->_map + cursor->_mapLen && 
+    lbl != NULL && lbl->_arena != NULL && lbl->_str == NULL && 
+    lbl->_type == JSONTypeStr) {
+    char* borrowed = cursor->_map + (str - cursor->_map);
+    borrowed[len] = '\0';
+    lbl->_str = borrowed;
+    lbl->_flagBorrowed = true;
+  // Else, create a new label
+  } else if (str != NULL) {
+    JSONLbl* newLbl = JSONLblCreate(that, lenPrefix + len);
+    memcpy(newLbl->_str, prefix, sizeof(char) * lenPrefix);
+    memcpy(newLbl->_str + lenPrefix, str, sizeof(char) * len);
+    JSONLblAttach(that, newLbl);
+  }
+}
+
+// Set the value of the node 'that', child of the cursor 'cursor', to 
+// the value of type 'type' and payload 'val'
+// If the nodes are reused the value is left unchanged if it's the same
+static void JSONLoadSetTyped(const JSONLoadCursor* const cursor, 
+  JSONNode* const that, const JSONType type, const JSONPayload val) {
+  JSONLbl* lbl = (JSONLbl*)GenTreeData(that);
+  // If the nodes are not reused or the node has no JSONLbl yet
+  if (!(cursor->_flagReuse) || lbl == NULL) {
+    JSONLblSetTyped(that, type, val);
+    return;
+  }
+  // If the value is the same, there is nothing to do
+  if (lbl->_str == NULL && lbl->_type == type && 
+    (type == JSONTypeNull ||
+    (type == JSONTypeInt && lbl->_val._int == val._int) ||
+    (type == JSONTypeReal && lbl->_val._real == val._real) ||
+    (type == JSONTypeBool && lbl->_val._bool == val._bool)))
+    return;
+  // If the node was labelled, the hash table of the index of the 
+  // parent is not valid anymore, as in JSONLoadSetLabel
+  if (lbl->_str != NULL)
+    JSONIndexInvalidate(cursor->_node, false);
+  JSONCacheInvalidate(that);
+  // Overwrite the value, the storage of the label is kept
+  lbl->_str = NULL;
+  lbl->_flagBorrowed = false;
+  lbl->_type = type;
+  lbl->_val = val;
+}
+
+// Load the array of values of property 'prop' as the next child of the
+// cursor 'cursor', 'c' being the first char of the first value already
+// consumed
+// Return true if it could load, false else
+bool JSONAddArr(JSONLoadCursor* const cursor, const char* const prop, 
+  const size_t lenProp, JSONReader* const reader, char c) {
+  // Get the node of the property, the values are added to it as they 
+  // are loaded
+  JSONNode* nodeKey = JSONLoadCursorNext(cursor);
+  JSONLoadSetLabel(cursor, nodeKey, "", 0, prop, lenProp);
+  return JSONLoadArrVal(nodeKey, reader, c);
+}
+
+// Load the values of an array as the children of the node 'that', 'c' 
+// being the first char of the first value already consumed
+// Return true if it could load, false else
+static bool JSONLoadArrVal(JSONNode* const that, 
+  JSONReader* const reader, char c) {
+  JSONLoadCursor cursorVal;
+  JSONLoadCursorInit(&cursorVal, that, reader);
   // Loop on values
   do {
-    // Load the value
-    if (!JSONLoadStr(stream, bufferValue))
-      return false;
-    // Add the string to the array
-    JSONArrayValAdd(&set, bufferValue);
+    // Load the value, a string or a number, a boolean or null, and add
+    // it to the property
+    JSONNode* nodeVal = NULL;
+    if (c == '"') {
+      const char* val = NULL;
+      size_t len = 0;
+      if (!JSONLoadStr(reader, &val, &len))
+        return false;
+      nodeVal = JSONLoadCursorNext(&cursorVal);
+      JSONLoadSetLabel(&cursorVal, nodeVal, "", 0, val, len);
+    } else {
+      JSONType type = JSONTypeStr;
+      JSONPayload val;
+      if (!JSONLoadScalar(reader, c, &type, &val))
+        return false;
+      nodeVal = JSONLoadCursorNext(&cursorVal);
+      JSONLoadSetTyped(&cursorVal, nodeVal, type, val);
+    }
+    if (reader->_flagReuse && JSONGetNbValue(nodeVal) > 0)
+      JSONLoadTrim(nodeVal, 0);
     // Move to the next significant char
-    if (!JSONGetNextChar(stream, &c))
+    if (!JSONGetNextChar(reader, &c))
       return false;
-    // Check the next significant character is '"' or ']'
-    if (c != '"' && c != ']') {
+    // Check the next significant character is the start of a value or 
+    // ']'
+    if (c != '"' && c != ']' && !JSONIsScalarStart(c)) {
       JSONErr->_type = PBErrTypeInvalidData;
       char ctx[2 * PBJSON_CONTEXTSIZE + 1];
-      JSONGetContextStream(stream, ctx);
+      JSONGetContext(reader, ctx);
       sprintf(JSONErr->_msg, 
-        "JSONAddArr: Expected '\"' or ']' but found '%c' near ...%s...", 
+        "JSONAddArr: Expected a value or ']' but found '%c' near ...%s...", 
         c, ctx);
       return false;
     }
   } while (c != ']');
-  // Add the property to the JSON
-  JSONAddProp(that, prop, &set);
-  // Flush the array
-  JSONArrayValFlush(&set);
+  JSONLoadCursorEnd(&cursorVal);
   // Return the success code
   return true;
 }
 
-// Load the array of structs of property 'prop' in the JSON 'that' 
+// Load the array of structs of property 'prop' as the next child of 
+// the cursor 'cursor'
+// Return true if it could load, false else
+bool JSONAddArrStruct(JSONLoadCursor* const cursor, 
+  const char* const prop, const size_t lenProp, 
+  JSONReader* const reader) {
+  // Get the node of the property, its label is prefixed with '[]' and 
+  // the structs are added to it as they are loaded
+  JSONNode* nodeKey = JSONLoadCursorNext(cursor);
+  JSONLoadSetLabel(cursor, nodeKey, "[]", 2, prop, lenProp);
+  return JSONLoadArrStruct(nodeKey, reader);
+}
+
+// Load the structs of an array as the children of the node 'that', 
+// the opening '{' of the first struct being already consumed
 // Return true if it could load, false else
-bool JSONAddArrStruct(JSONNode* const that, char* prop, FILE* stream) {
-  // Declare the array of values
-  JSONArrayStruct set = JSONArrayStructCreateStatic();
+static bool JSONLoadArrStruct(JSONNode* const that, 
+  JSONReader* const reader) {
+  JSONLoadCursor cursorObj;
+  JSONLoadCursorInit(&cursorObj, that, reader);
   // Declare a char to memorize the next significant char
   char c = '\0';
   // Loop on values
   do {
-    // Allocate memory for the next object
-    JSONNode* obj = JSONCreate();
-    // Rewind one char as JSONLoad expect to read '{'
-    if (fseek(stream, -1, SEEK_CUR) != 0) {
-      JSONErr->_type = PBErrTypeIOError;
-      sprintf(JSONErr->_msg, "fseek error in JSONAddArrStruct");
-      return false;
-    } 
-    // Load the value
-    if (!JSONLoad(obj, stream))
+    // Get the node of the next object, which has no label
+    JSONNode* obj = JSONLoadCursorNext(&cursorObj);
+    JSONLoadSetLabel(&cursorObj, obj, "", 0, NULL, 0);
+    // Load the value, the opening '{' has already been consumed
+    if (!JSONLoadStruct(obj, reader))
       return false;
-    // Add the string to the array
-    JSONArrayStructAdd(&set, obj);
     // Move the next significant char
-    if (!JSONGetNextChar(stream, &c))
+    if (!JSONGetNextChar(reader, &c))
       return false;
     // check the next significant character is '{' or ']'
     if (c != '{' && c != ']') {
       JSONErr->_type = PBErrTypeInvalidData;
       char ctx[2 * PBJSON_CONTEXTSIZE + 1];
-      JSONGetContextStream(stream, ctx);
+      JSONGetContext(reader, ctx);
       sprintf(JSONErr->_msg, 
         "JSONAddStruct: Expected '{' or ']' but found '%c' near ...%s...", 
         c, ctx);
       return false;
     }
   } while (c != ']');
-  // Add the property to the JSON
-  JSONAddProp(that, prop, &set);
-  // Flush the array
-  JSONArrayStructFlush(&set);
+  JSONLoadCursorEnd(&cursorObj);
   // Return the success code
   return true;
 }
 
-// Load a key/value in the JSON 'that' from the stream 'stream'
+// Load a key/value as the next child of the cursor 'cursor' from the 
+// reader 'reader'
 // Return true if it could load, false else
-bool JSONLoadProp(JSONNode* const that, FILE* stream) {
-  // Declare a buffer to read the key
-  char bufferKey[PBJSON_MAXLENGTHLBL + 1] = {'\0'};
+bool JSONLoadProp(JSONLoadCursor* const cursor, JSONReader* const reader) {
   // Read the property's key
-  if (!JSONLoadStr(stream, bufferKey))
+  const char* key = NULL;
+  size_t lenKey = 0;
+  if (!JSONLoadStr(reader, &key, &lenKey))
     return false;
+  // Keep the key valid while reading the value
+  JSONStrBuf bufferKey;
+  JSONStrBufInit(&bufferKey);
+  const char* keyProp = JSONLoadKeepStr(reader, &bufferKey, key, lenKey);
+  // Load the value
+  bool ret = JSONLoadPropVal(cursor, reader, keyProp, lenKey);
+  // Free the memory used by the key
+  JSONStrBufFree(&bufferKey);
+  // Return the success code
+  return ret;
+}
+
+// Return the 'len' chars of 'str', read from the 'reader', in a form 
+// which stays valid while reading further: 'str' itself if the reader 
+// is on a buffer and 'str' lies in it, as the buffer is never 
+// overwritten, else a copy in 'buf'
+static const char* JSONLoadKeepStr(const JSONReader* const reader, 
+  JSONStrBuf* const buf, const char* const str, const size_t len) {
+  if (reader->_stream == NULL && str >= reader->_buf && 
+    str < reader->_buf + reader->_len)
+    return str;
+  JSONStrBufAppend(buf, str, len);
+  return buf->_str;
+}
+
+// Load the value of the property of key 'keyProp' as the next child of
+// the cursor 'cursor' from the reader 'reader', the key being already
+// consumed
+// Return true if it could load, false else
+static bool JSONLoadPropVal(JSONLoadCursor* const cursor, 
+  JSONReader* const reader, const char* const keyProp, 
+  const size_t lenKey) {
+  // Declare a variable to memorize the success code
+  bool ret = true;
   // Read the next significant character which must be a ':'
   char c;
-  if (!JSONGetNextChar(stream, &c))
-    return false;
-  if (c != ':') {
+  if (!JSONGetNextChar(reader, &c)) {
+    ret = false;
+  } else if (c != ':') {
     JSONErr->_type = PBErrTypeInvalidData;
     char ctx[2 * PBJSON_CONTEXTSIZE + 1];
-    JSONGetContextStream(stream, ctx);
+    JSONGetContext(reader, ctx);
     sprintf(JSONErr->_msg, 
       "JSONLoadProp: Expected ':' but found '%c' near ...%s...", 
       c, ctx);
-    return false;
-  }
+    ret = false;
   // Read the next significant character
-  if (!JSONGetNextChar(stream, &c))
-    return false;
+  } else if (!JSONGetNextChar(reader, &c)) {
+    ret = false;
   // If the next character is a double quote
-  if (c == '"') {
+  } else if (c == '"') {
     // Read the property's value
-    char bufferVal[PBJSON_MAXLENGTHLBL + 1] = {'\0'};
-    if (!JSONLoadStr(stream, bufferVal))
-      return false;
-    // Add the property to the JSON
-    JSONAddProp(that, bufferKey, bufferVal);
+    const char* val = NULL;
+    size_t lenVal = 0;
+    if (!JSONLoadStr(reader, &val, &lenVal)) {
+      ret = false;
+    } else {
+      // Add the property to the JSON, the value is copied directly 
+      // from the reader into its label
+      JSONNode* nodeKey = JSONLoadCursorNext(cursor);
+      JSONLoadSetLabel(cursor, nodeKey, "", 0, 
+        keyProp, lenKey);
+      JSONLoadCursor cursorVal;
+      JSONLoadCursorInit(&cursorVal, nodeKey, reader);
+      JSONNode* nodeVal = JSONLoadCursorNext(&cursorVal);
+      JSONLoadSetLabel(&cursorVal, nodeVal, "", 0, val, lenVal);
+      if (reader->_flagReuse && JSONGetNbValue(nodeVal) > 0)
+        JSONLoadTrim(nodeVal, 0);
+      JSONLoadCursorEnd(&cursorVal);
+    }
+  // Else, if the next character starts a number, a boolean or null
+  } else if (JSONIsScalarStart(c)) {
+    // Read the property's value
+    JSONType type = JSONTypeStr;
+    JSONPayload val;
+    if (!JSONLoadScalar(reader, c, &type, &val)) {
+      ret = false;
+    } else {
+      // Add the property to the JSON
+      JSONNode* nodeKey = JSONLoadCursorNext(cursor);
+      JSONLoadSetLabel(cursor, nodeKey, "", 0, 
+        keyProp, lenKey);
+      JSONLoadCursor cursorVal;
+      JSONLoadCursorInit(&cursorVal, nodeKey, reader);
+      JSONNode* nodeVal = JSONLoadCursorNext(&cursorVal);
+      JSONLoadSetTyped(&cursorVal, nodeVal, type, val);
+      if (reader->_flagReuse && JSONGetNbValue(nodeVal) > 0)
+        JSONLoadTrim(nodeVal, 0);
+      JSONLoadCursorEnd(&cursorVal);
+    }
   // Else, if the next character is a square bracket
   } else if (c == '[') {
-    JSONLoadArr(that, stream, bufferKey);
+    ret = JSONLoadArr(cursor, reader, keyProp, lenKey);
   // Else, if the next character is an accolade
   } else if (c == '{') {
     // This property is an object
-    // Create a new node for the object
-    JSONNode* prop = JSONCreate();
-    // Set the property name
-    JSONSetLabel(prop, bufferKey);
-    // Add the new node to the JSON
-    JSONAppendVal(that, prop);
-    // Load the object
-    JSONLoadStruct(prop, stream);
+    // Get the node for the object and set the property name
+    JSONNode* prop = JSONLoadCursorNext(cursor);
+    JSONLoadSetLabel(cursor, prop, "", 0, 
+      keyProp, lenKey);
+    // If the loading is lazy, skip the object and memorize its bytes on
+    // the node to load it when it's accessed
+    if (reader->_arenaLazy != NULL) {
+      char first = '\0';
+      JSONLbl* lbl = (JSONLbl*)GenTreeData(prop);
+      ret = JSONLoadSkip(reader, reader->_arenaLazy, &(lbl->_lazy), 
+        &(lbl->_lazyLen), &first);
+      // An empty object has nothing to load
+      if (first == '}') {
+        lbl->_lazy = NULL;
+        lbl->_lazyLen = 0;
+      }
+    // Else, load the object
+    } else {
+      ret = JSONLoadStruct(prop, reader);
+    }
   // Else, it's not a valid file
   } else {
     // Return the failure code
     JSONErr->_type = PBErrTypeInvalidData;
     char ctx[2 * PBJSON_CONTEXTSIZE + 1];
-    JSONGetContextStream(stream, ctx);
+    JSONGetContext(reader, ctx);
     sprintf(JSONErr->_msg, 
-      "JSONLoadProp: Expected '\"','{' or '[' but found '%c' near ...%s...", 
+      "JSONLoadProp: Expected a value, '{' or '[' but found '%c' "
+      "near ...%s...", 
       c, ctx);
-    return false;
+    ret = false;
   }
   // Return the success code
-  return true;
+  return ret;
 }
 
-// Get the characters around the current position in the 'stream'
-void JSONGetContextStream(FILE* stream, char* buffer) {
-  int pos = fseek(stream, -PBJSON_CONTEXTSIZE, SEEK_CUR);
-  (void)pos;
-  int nb = fread(buffer, sizeof(char), 2 * PBJSON_CONTEXTSIZE, stream);
-  (void)nb;
-  buffer[2 * PBJSON_CONTEXTSIZE] = '\0';
+// Get the characters around the current position in the 'reader'
+void JSONGetContext(const JSONReader* const reader, char* buffer) {
+  // Get the position of the first char of the context, clipped to the 
+  // bytes currently available
+  size_t start = 0;
+  if (reader->_pos > PBJSON_CONTEXTSIZE)
+    start = reader->_pos - PBJSON_CONTEXTSIZE;
+  // Get the number of chars in the context
+  size_t nb = reader->_len - start;
+  if (nb > 2 * PBJSON_CONTEXTSIZE)
+    nb = 2 * PBJSON_CONTEXTSIZE;
+  // Copy the context
+  memcpy(buffer, reader->_buf + start, nb);
+  buffer[nb] = '\0';
 }
 
-// Load a struct in the JSON 'that' from the stream 'stream'
+// Load a struct in the JSON 'that' from the reader 'reader'
 // Return true if it could load, false else
-bool JSONLoadStruct(JSONNode* const that, FILE* stream) {
+bool JSONLoadStruct(JSONNode* const that, JSONReader* const reader) {
+  // Update the depth
+  ++(reader->_depth);
+  if (reader->_depth > reader->_depthMax)
+    reader->_depthMax = reader->_depth;
+  // Declare a cursor on the properties of the struct
+  JSONLoadCursor cursor;
+  JSONLoadCursorInit(&cursor, that, reader);
   char c = '\0';
   // Loop until the end of the structure
   while (c != '}') {
     // Read the next significant character
-    if (!JSONGetNextChar(stream, &c))
+    if (!JSONGetNextChar(reader, &c))
       return false;
     // If it's not the end of the struct
     if (c != '}') {
       // Load the pair key/value
-      if (!JSONLoadProp(that, stream))
+      if (!JSONLoadProp(&cursor, reader))
         return false;
     } 
   }
+  JSONLoadCursorEnd(&cursor);
+  --(reader->_depth);
   // Return the success code
   return true;
 }
 
-// Load an array in the JSON 'that' from the stream 'stream'
+// Load an array with key 'key' as the next child of the cursor 
+// 'cursor' from the reader 'reader'
 // Return true if it could load, false else
-bool JSONLoadArr(JSONNode* const that, FILE* stream, char* key) {
+bool JSONLoadArr(JSONLoadCursor* const cursor, JSONReader* const reader, 
+  const char* const key, const size_t lenKey) {
   // Declare a variable ot memorize the next significant char
   char c;
-  // Read the next significant character
-  if (!JSONGetNextChar(stream, &c))
+  // Update the depth
+  ++(reader->_depth);
+  if (reader->_depth > reader->_depthMax)
+    reader->_depthMax = reader->_depth;
+  // If the loading is lazy
+  if (reader->_arenaLazy != NULL) {
+    // Skip the array, its first significant char tells if it's an 
+    // array of values or of structs
+    char* span = NULL;
+    size_t len = 0;
+    if (!JSONLoadSkip(reader, reader->_arenaLazy, &span, &len, &c))
+      return false;
+    // If the array is not empty, memorize its bytes on the node of the
+    // property to load its values when they're accessed. An empty 
+    // array is loaded as usual, its closing bracket has been consumed
+    if (c != ']') {
+      JSONNode* nodeKey = JSONLoadCursorNext(cursor);
+      if (c == '{')
+        JSONLoadSetLabel(cursor, nodeKey, "[]", 2, key, lenKey);
+      else
+        JSONLoadSetLabel(cursor, nodeKey, "", 0, key, lenKey);
+      JSONLbl* lbl = (JSONLbl*)GenTreeData(nodeKey);
+      lbl->_lazy = span;
+      lbl->_lazyLen = len;
+      --(reader->_depth);
+      return true;
+    }
+  // Else, read the next significant character
+  } else if (!JSONGetNextChar(reader, &c)) {
     return false;
-  // If the next character is a double quote
-  if (c == '"') {
+  }
+  // If the next character starts a value
+  if (c == '"' || JSONIsScalarStart(c)) {
     // Load the array of value
-    if (!JSONAddArr(that, key, stream))
+    if (!JSONAddArr(cursor, key, lenKey, reader, c))
       return false;
   // Else, if the next character is a closing square bracket
   } else if (c == ']') {
-    // It's an empty array
-    // Declare the empty array
-    JSONArrayVal set = JSONArrayValCreateStatic();
-    // Add the property to the JSON
-    JSONAddProp(that, key, &set);
+    // It's an empty array, it has one empty value to be viewed as a 
+    // property when saving, as in _JSONAddPropArr
+    JSONNode* nodeKey = JSONLoadCursorNext(cursor);
+    JSONLoadSetLabel(cursor, nodeKey, "", 0, key, lenKey);
+    JSONLoadCursor cursorVal;
+    JSONLoadCursorInit(&cursorVal, nodeKey, reader);
+    JSONNode* nodeVal = JSONLoadCursorNext(&cursorVal);
+    JSONLoadSetLabel(&cursorVal, nodeVal, "", 0, NULL, 0);
+    if (reader->_flagReuse && JSONGetNbValue(nodeVal) > 0)
+      JSONLoadTrim(nodeVal, 0);
+    JSONLoadCursorEnd(&cursorVal);
   // Else, if the next character is a bracket
   } else if (c == '{') {
     // This property is an array of structs
     // Load the array of structs
-    if (!JSONAddArrStruct(that, key, stream))
+    if (!JSONAddArrStruct(cursor, key, lenKey, reader))
       return false;
   // Else, it's not a valid file
   } else {
     // Return the failure code
     JSONErr->_type = PBErrTypeInvalidData;
     char ctx[2 * PBJSON_CONTEXTSIZE + 1];
-    JSONGetContextStream(stream, ctx);
+    JSONGetContext(reader, ctx);
     sprintf(JSONErr->_msg, 
-      "JSONLoadArr: Expected '\"' or '{' but found '%c' near ...%s...", 
+      "JSONLoadArr: Expected a value or '{' but found '%c' near ...%s...", 
       c, ctx);
     return false;
   }
+  --(reader->_depth);
   // Return the success code
   return true;
 }
 
-// Load the JSON 'that' from the stream 'stream'
+// Load the JSON 'that' from the reader 'reader'
 // Return true if it could load, false else
-bool JSONLoad(JSONNode* const that, FILE* const stream) {
-#if BUILDMODE == 0
-  if (that == NULL) {
-    JSONErr->_type = PBErrTypeNullPointer;
-    sprintf(JSONErr->_msg, "'that' is null");
-    PBErrCatch(JSONErr);
-  }
-  if (stream == NULL) {
-    JSONErr->_type = PBErrTypeNullPointer;
-    sprintf(JSONErr->_msg, "'stream' is null");
-    PBErrCatch(JSONErr);
-  }
-#endif
+bool JSONLoadFromReader(JSONNode* const that, JSONReader* const reader) {
+  // The loading is lazy if 'that' is in an arena loading lazily, and 
+  // the existing nodes are not reused
+  JSONLbl* lbl = (JSONLbl*)GenTreeData(that);
+  if (lbl != NULL && lbl->_arena != NULL && lbl->_arena->_flagLazy && 
+    !(reader->_flagReuse))
+    reader->_arenaLazy = lbl->_arena;
   char c;
   // Read the first significant character
-  if (!JSONGetNextChar(stream, &c))
+  if (!JSONGetNextChar(reader, &c))
     return false;
   // If the file starts with a '{'
   if (c == '{') {
     // The file contains a struct definion
     // Load the struct
-    return JSONLoadStruct(that, stream);
+    return JSONLoadStruct(that, reader);
   // Else if the file starts with a '['
   } else if (c == '[') {
     // The file contains an array 
-    // Load the array
-    return JSONLoadArr(that, stream, "");
+    // Load the array as a property with an empty key
+    JSONLoadCursor cursor;
+    JSONLoadCursorInit(&cursor, that, reader);
+    if (!JSONLoadArr(&cursor, reader, "", 0))
+      return false;
+    JSONLoadCursorEnd(&cursor);
+    return true;
   // Else, the file doesn't start with '{' or '['
   } else {
     // It's not a valid file, stop here
     JSONErr->_type = PBErrTypeInvalidData;
     char ctx[2 * PBJSON_CONTEXTSIZE + 1];
-    JSONGetContextStream(stream, ctx);
+    JSONGetContext(reader, ctx);
     sprintf(JSONErr->_msg, 
       "JSONLoad: Expected '{' or '[' but found '%c' near ...%s...", 
       c, ctx);
     return false;
   }
+}
+
+// Load the JSON 'that' from the stream 'stream'
+// Return true if it could load, false else
+bool JSONLoad(JSONNode* const that, FILE* const stream) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (stream == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'stream' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  double start = JSONStatsClock();
+  // Declare a reader on the stream
+  JSONReader reader;
+  JSONReaderInitStream(&reader, stream);
+  // Load the JSON from the reader
+  bool ret = JSONLoadFromReader(that, &reader);
+  // Give back the unconsumed bytes to the stream
+  JSONReaderRelease(&reader);
+  ++(JSONStatsCur._nbLoad);
+  JSONStatsAddTime(&(JSONStatsCur._timeLoad), start);
   // Return the success code
-  return true;
+  return ret;
 }
 
-// Load the JSON 'that' from the string 'str' seen as a stream
+// Load the JSON 'that' from the string 'str'
 // Return true if it could load, false else
 bool JSONLoadFromStr(JSONNode* const that, const char* const str) {
 #if BUILDMODE == 0
@@ -658,58 +3643,3593 @@ bool JSONLoadFromStr(JSONNode* const that, const char* const str) {
     PBErrCatch(JSONErr);
   }
 #endif
-  // Open the string as a stream
-  FILE* stream = fmemopen((void*)str, strlen(str), "r");
-  
-  // Load the JSON as with a normal stream
-  bool ret = JSONLoad(that, stream);
-  
-  // Close the stream
-  fclose(stream);
-  
+  // Load the JSON from the bytes of the string
+  return JSONLoadFromBuffer(that, str, strlen(str));
+}
+
+// Load the JSON 'that' from the 'len' first bytes of the buffer 'buf'
+// The buffer doesn't need to be null terminated
+// Return true if it could load, false else
+bool JSONLoadFromBuffer(JSONNode* const that, const char* const buf, 
+  const size_t len) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (buf == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'buf' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  double start = JSONStatsClock();
+  // Declare a reader directly on the buffer
+  JSONReader reader;
+  JSONReaderInitBuffer(&reader, buf, len);
+  // Load the JSON from the reader
+  bool ret = JSONLoadFromReader(that, &reader);
+  // Free the memory used by the reader
+  JSONReaderRelease(&reader);
+  ++(JSONStatsCur._nbLoad);
+  JSONStatsAddTime(&(JSONStatsCur._timeLoad), start);
   // Return the success code
   return ret;
 }
 
-// Return the JSONNode of the property with label 'lbl' of the 
-// JSON 'that'
-// If the property doesn't exist return NULL
-JSONNode* JSONProperty(const JSONNode* const that, 
-  const char* const lbl) {
+// Load the JSON 'that' from the file at path 'path' mapped in memory
+// 'that' must be allocated in an arena. The labels without escape 
+// sequence borrow their chars from the mapping instead of being 
+// copied, they stay valid until the arena is reset or freed, which 
+// also unmaps the file
+// The mapping is private and each borrowed label is null terminated in
+// place, which copies on write every page holding a label. For a usual
+// JSON the whole file ends up as private anonymous memory: it's not 
+// shared with other processes mapping the same file and can't be 
+// dropped and read again under memory pressure. It saves the copy of 
+// the labels and their JSONLbl, not the memory of the file
+// Return true if it could load, false else
+bool JSONLoadMapped(JSONNode* const that, const char* const path) {
 #if BUILDMODE == 0
   if (that == NULL) {
     JSONErr->_type = PBErrTypeNullPointer;
     sprintf(JSONErr->_msg, "'that' is null");
     PBErrCatch(JSONErr);
   }
-  if (lbl == NULL) {
+  if (path == NULL) {
     JSONErr->_type = PBErrTypeNullPointer;
-    sprintf(JSONErr->_msg, "'lbl' is null");
+    sprintf(JSONErr->_msg, "'path' is null");
     PBErrCatch(JSONErr);
   }
 #endif
-  // If the JSONNode has properties
-  if (JSONGetNbValue(that) > 0) {
-    // Declare an iterator on properties of the JSONNode
-    GSetIterForward iter = 
-      GSetIterForwardCreateStatic(JSONProperties(that));
-    // Loop on properties
-    do {
-      // Get the property
-      JSONNode* prop = GSetIterGet(&iter);
-      // Skip the eventual '[]'
-      char* propLbl = JSONLabel(prop);
-      if (propLbl[0] == '[' && propLbl[1] == ']')
-        propLbl += 2;
-      // If the label of the property is the same as the searched
-      // property
-      if (strcmp(propLbl, lbl) == 0) {
-        // Return the property
-        return prop;
-      }
-    } while (GSetIterStep(&iter));
+  // The mapping is released with the arena of the node, so the node 
+  // must be in an arena
+  JSONLbl* lbl = (JSONLbl*)GenTreeData(that);
+  if (lbl == NULL || lbl->_arena == NULL) {
+    JSONErr->_type = PBErrTypeInvalidArg;
+    sprintf(JSONErr->_msg, "JSONLoadMapped: 'that' is not in an arena");
+    return false;
   }
-  // If we reach here it means the searched property doesn't exist
-  return NULL;
+  // Open the file and get its size
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    JSONErr->_type = PBErrTypeIOError;
+    sprintf(JSONErr->_msg, "JSONLoadMapped: Can't open the file");
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+    close(fd);
+    JSONErr->_type = PBErrTypeIOError;
+    sprintf(JSONErr->_msg, "JSONLoadMapped: Can't get the file size");
+    return false;
+  }
+  size_t size = (size_t)(st.st_size);
+  // An empty file can't be mapped, load it from an empty buffer to 
+  // get the same error as the other loading functions
+  if (size == 0) {
+    close(fd);
+    return JSONLoadFromBuffer(that, "", 0);
+  }
+  // Map the file privately and writable, the labels borrowed from the
+  // mapping are null terminated in place without modifying the file,
+  // at the cost of a private copy of each page they are written in
+  void* addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, 
+    fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    JSONErr->_type = PBErrTypeIOError;
+    sprintf(JSONErr->_msg, "JSONLoadMapped: Can't map the file");
+    return false;
+  }
+  // The file is read sequentially
+  madvise(addr, size, MADV_SEQUENTIAL);
+  // Register the mapping in the arena, which releases it when it's 
+  // reset or freed, even if the loading fails as some labels may 
+  // already borrow from it
+  JSONArenaMap* map = PBErrMalloc(JSONErr, sizeof(JSONArenaMap));
+  map->_addr = addr;
+  map->_size = size;
+  map->_next = lbl->_arena->_maps;
+  lbl->_arena->_maps = map;
+  // Declare a reader directly on the mapping
+  double start = JSONStatsClock();
+  JSONReader reader;
+  JSONReaderInitBuffer(&reader, (const char*)addr, size);
+  reader._map = (char*)addr;
+  reader._mapLen = size;
+  // Load the JSON from the reader
+  bool ret = JSONLoadFromReader(that, &reader);
+  // Free the memory used by the reader
+  JSONReaderRelease(&reader);
+  ++(JSONStatsCur._nbLoad);
+  JSONStatsAddTime(&(JSONStatsCur._timeLoad), start);
+  // Return the success code
+  return ret;
 }
 
+// Load the subtrees of the node 'that' if they have not been loaded yet
+// by a lazy loading, see JSONArenaSetLazy
+// Return true if they are loaded, false if their bytes are invalid
+bool JSONLoadLazy(JSONNode* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  // If the subtrees are already loaded, there is nothing to do
+  JSONLbl* lbl = (JSONLbl*)GenTreeData(that);
+  if (lbl == NULL || lbl->_lazy == NULL)
+    return true;
+  // The subtrees are loaded once, even if their bytes are invalid
+  char* span = lbl->_lazy;
+  size_t len = lbl->_lazyLen;
+  lbl->_lazy = NULL;
+  lbl->_lazyLen = 0;
+  // Declare a reader on the bytes of the object or array. They are in
+  // the arena of the node, or in a mapped file released with it, so 
+  // the labels can borrow them as from a mapped file. The objects and 
+  // arrays nested in them are loaded lazily as well if the arena still
+  // loads lazily
+  JSONReader reader;
+  JSONReaderInitBuffer(&reader, span, len);
+  reader._map = span;
+  reader._mapLen = len;
+  if (lbl->_arena->_flagLazy)
+    reader._arenaLazy = lbl->_arena;
+  // Load the object, or the array of values or structs
+  bool ret = true;
+  char c = '\0';
+  if (!JSONGetNextChar(&reader, &c)) {
+    ret = false;
+  } else if (c == '{') {
+    ret = JSONLoadStruct(that, &reader);
+  } else if (!JSONGetNextChar(&reader, &c)) {
+    ret = false;
+  } else if (c == '{') {
+    ret = JSONLoadArrStruct(that, &reader);
+  } else {
+    ret = JSONLoadArrVal(that, &reader, c);
+  }
+  // Free the memory used by the reader
+  JSONReaderRelease(&reader);
+  // Return the success code
+  return ret;
+}
+
+// Set the error for a parsing stopped by a callback of the event 
+// handler
+// Return false
+static bool JSONParseStopped(void) {
+  JSONErr->_type = PBErrTypeOther;
+  sprintf(JSONErr->_msg, "JSONParse: Stopped by the event handler");
+  return false;
+}
+
+// Parse a number, a boolean or null from the reader 'reader', 'first' 
+// being its first char already consumed
+// Return true if it could parse, false else
+static bool JSONParseScalar(const JSONEventHandler* const handler, 
+  JSONReader* const reader, const char first) {
+  // Read and convert the value, it is checked even if there is no 
+  // callback to receive it
+  char tok[PBJSON_SCALARSIZE];
+  size_t len = 0;
+  JSONType type = JSONTypeStr;
+  JSONPayload val;
+  if (!JSONReadScalar(reader, first, tok, &len) || 
+    !JSONScanScalar(tok, len, &type, &val))
+    return false;
+  // Give the typed value to the handler, or its chars if it has no 
+  // callback for typed values
+  if (handler->_scalar != NULL) {
+    if (!handler->_scalar(handler->_data, type, val))
+      return JSONParseStopped();
+  } else if (handler->_val != NULL) {
+    if (!handler->_val(handler->_data, tok, len))
+      return JSONParseStopped();
+  }
+  // Return the success code
+  return true;
+}
+
+// Parse a struct from the reader 'reader', the opening '{' has already 
+// been consumed
+// Return true if it could parse, false else
+static bool JSONParseStruct(const JSONEventHandler* const handler, 
+  JSONReader* const reader) {
+  if (handler->_objStart != NULL && !handler->_objStart(handler->_data))
+    return JSONParseStopped();
+  char c = '\0';
+  // Loop until the end of the structure
+  while (c != '}') {
+    // Read the next significant character
+    if (!JSONGetNextChar(reader, &c))
+      return false;
+    // If it's not the end of the struct
+    if (c != '}') {
+      // Parse the pair key/value
+      if (!JSONParseProp(handler, reader))
+        return false;
+    } 
+  }
+  if (handler->_objEnd != NULL && !handler->_objEnd(handler->_data))
+    return JSONParseStopped();
+  // Return the success code
+  return true;
+}
+
+// Parse a key/value from the reader 'reader', the opening '"' of the 
+// key has already been consumed
+// Return true if it could parse, false else
+static bool JSONParseProp(const JSONEventHandler* const handler, 
+  JSONReader* const reader) {
+  // Read the property's key, the key is given to the handler before 
+  // reading the value so it doesn't need to be copied
+  const char* str = NULL;
+  size_t len = 0;
+  if (!JSONLoadStr(reader, &str, &len))
+    return false;
+  if (handler->_key != NULL && !handler->_key(handler->_data, str, len))
+    return JSONParseStopped();
+  // Read the next significant character which must be a ':'
+  char c;
+  if (!JSONGetNextChar(reader, &c))
+    return false;
+  if (c != ':') {
+    JSONErr->_type = PBErrTypeInvalidData;
+    char ctx[2 * PBJSON_CONTEXTSIZE + 1];
+    JSONGetContext(reader, ctx);
+    sprintf(JSONErr->_msg, 
+      "JSONParseProp: Expected ':' but found '%c' near ...%s...", 
+      c, ctx);
+    return false;
+  }
+  // Read the next significant character
+  if (!JSONGetNextChar(reader, &c))
+    return false;
+  // If the next character is a double quote
+  if (c == '"') {
+    // Read the property's value
+    if (!JSONLoadStr(reader, &str, &len))
+      return false;
+    if (handler->_val != NULL && !handler->_val(handler->_data, str, len))
+      return JSONParseStopped();
+  // Else, if the next character starts a number, a boolean or null
+  } else if (JSONIsScalarStart(c)) {
+    return JSONParseScalar(handler, reader, c);
+  // Else, if the next character is a square bracket
+  } else if (c == '[') {
+    return JSONParseArr(handler, reader);
+  // Else, if the next character is an accolade
+  } else if (c == '{') {
+    return JSONParseStruct(handler, reader);
+  // Else, it's not a valid file
+  } else {
+    JSONErr->_type = PBErrTypeInvalidData;
+    char ctx[2 * PBJSON_CONTEXTSIZE + 1];
+    JSONGetContext(reader, ctx);
+    sprintf(JSONErr->_msg, 
+      "JSONParseProp: Expected a value,'{' or '[' but found '%c' near ...%s...", 
+      c, ctx);
+    return false;
+  }
+  // Return the success code
+  return true;
+}
+
+// Parse an array from the reader 'reader', the opening '[' has already 
+// been consumed
+// Return true if it could parse, false else
+static bool JSONParseArr(const JSONEventHandler* const handler, 
+  JSONReader* const reader) {
+  if (handler->_arrStart != NULL && !handler->_arrStart(handler->_data))
+    return JSONParseStopped();
+  // Read the first significant character, it decides the type of the 
+  // array as in JSONLoadArr: an array of structs or an array of 
+  // strings, numbers, booleans and null
+  char c;
+  if (!JSONGetNextChar(reader, &c))
+    return false;
+  bool flagStruct = (c == '{');
+  if (c != '"' && c != '{' && c != ']' && !JSONIsScalarStart(c)) {
+    JSONErr->_type = PBErrTypeInvalidData;
+    char ctx[2 * PBJSON_CONTEXTSIZE + 1];
+    JSONGetContext(reader, ctx);
+    sprintf(JSONErr->_msg, 
+      "JSONParseArr: Expected a value or '{' but found '%c' near ...%s...", 
+      c, ctx);
+    return false;
+  }
+  // Loop on the elements of the array
+  while (c != ']') {
+    // If it's a string value
+    if (c == '"') {
+      const char* str = NULL;
+      size_t len = 0;
+      if (!JSONLoadStr(reader, &str, &len))
+        return false;
+      if (handler->_val != NULL && 
+        !handler->_val(handler->_data, str, len))
+        return JSONParseStopped();
+    // Else, if it's a struct
+    } else if (c == '{') {
+      if (!JSONParseStruct(handler, reader))
+        return false;
+    // Else, it's a number, a boolean or null
+    } else {
+      if (!JSONParseScalar(handler, reader, c))
+        return false;
+    }
+    // Move to the next significant char, which must be the opening 
+    // char of the next element of the same type of array or the end of 
+    // the array
+    if (!JSONGetNextChar(reader, &c))
+      return false;
+    bool flagValid = (flagStruct ? c == '{' : 
+      c == '"' || JSONIsScalarStart(c));
+    if (!flagValid && c != ']') {
+      JSONErr->_type = PBErrTypeInvalidData;
+      char ctx[2 * PBJSON_CONTEXTSIZE + 1];
+      JSONGetContext(reader, ctx);
+      sprintf(JSONErr->_msg, 
+        "JSONParseArr: Expected %s or ']' but found '%c' near ...%s...", 
+        (flagStruct ? "'{'" : "a value"), c, ctx);
+      return false;
+    }
+  }
+  if (handler->_arrEnd != NULL && !handler->_arrEnd(handler->_data))
+    return JSONParseStopped();
+  // Return the success code
+  return true;
+}
+
+// Parse the JSON from the reader 'reader'
+// Return true if it could parse, false else
+static bool JSONParseFromReader(const JSONEventHandler* const handler, 
+  JSONReader* const reader) {
+  char c;
+  // Read the first significant character
+  if (!JSONGetNextChar(reader, &c))
+    return false;
+  // If the file starts with a '{'
+  if (c == '{') {
+    return JSONParseStruct(handler, reader);
+  // Else if the file starts with a '['
+  } else if (c == '[') {
+    return JSONParseArr(handler, reader);
+  // Else, the file doesn't start with '{' or '['
+  } else {
+    JSONErr->_type = PBErrTypeInvalidData;
+    char ctx[2 * PBJSON_CONTEXTSIZE + 1];
+    JSONGetContext(reader, ctx);
+    sprintf(JSONErr->_msg, 
+      "JSONParse: Expected '{' or '[' but found '%c' near ...%s...", 
+      c, ctx);
+    return false;
+  }
+}
+
+// Parse the JSON in the stream 'stream' and call the callbacks of the 
+// handler 'handler' on each event, without building the JSON tree
+// The memory used is independent of the size of the JSON
+// Return true if it could parse, false if the JSON is invalid or a 
+// callback stopped the parsing
+bool JSONParse(const JSONEventHandler* const handler, 
+  FILE* const stream) {
+#if BUILDMODE == 0
+  if (handler == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'handler' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (stream == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'stream' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  // Declare a reader on the stream
+  JSONReader reader;
+  JSONReaderInitStream(&reader, stream);
+  // Parse the JSON from the reader
+  bool ret = JSONParseFromReader(handler, &reader);
+  // Give back the unconsumed bytes to the stream
+  JSONReaderRelease(&reader);
+  // Return the success code
+  return ret;
+}
+
+// Parse the JSON in the null terminated string 'str' and call the 
+// callbacks of the handler 'handler' on each event
+// Return true if it could parse, false else
+bool JSONParseFromStr(const JSONEventHandler* const handler, 
+  const char* const str) {
+#if BUILDMODE == 0
+  if (str == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'str' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  return JSONParseFromBuffer(handler, str, strlen(str));
+}
+
+// Parse the JSON in the 'len' first bytes of the buffer 'buf' and call 
+// the callbacks of the handler 'handler' on each event
+// The buffer doesn't need to be null terminated
+// Return true if it could parse, false else
+bool JSONParseFromBuffer(const JSONEventHandler* const handler, 
+  const char* const buf, const size_t len) {
+#if BUILDMODE == 0
+  if (handler == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'handler' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (buf == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'buf' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  // Declare a reader directly on the buffer
+  JSONReader reader;
+  JSONReaderInitBuffer(&reader, buf, len);
+  // Parse the JSON from the reader
+  bool ret = JSONParseFromReader(handler, &reader);
+  // Free the memory used by the reader
+  JSONReaderRelease(&reader);
+  // Return the success code
+  return ret;
+}
+
+// Create an incremental parser loading its input into the JSON 'json'
+JSONFeeder* JSONFeederCreate(JSONNode* const json) {
+  // Allocate memory for the parser
+  JSONFeeder* that = PBErrMalloc(JSONErr, sizeof(JSONFeeder));
+  // Initialise properties
+  that->_stack = NULL;
+  that->_size = 0;
+  JSONStrBufInit(&(that->_key));
+  JSONStrBufInit(&(that->_str));
+  JSONFeederReset(that, json);
+  // Return the parser
+  return that;
+}
+
+// Free the memory used by the incremental parser 'that'
+// The JSON it has loaded is not freed
+void JSONFeederFree(JSONFeeder** that) {
+  // Check arguments
+  if (that == NULL || *that == NULL)
+    // Nothing to do
+    return;
+  // Free memory
+  free((*that)->_stack);
+  JSONStrBufFree(&((*that)->_key));
+  JSONStrBufFree(&((*that)->_str));
+  free(*that);
+  *that = NULL;
+}
+
+// Reset the incremental parser 'that' to load a new JSON into 'json'
+void JSONFeederReset(JSONFeeder* const that, JSONNode* const json) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (json == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'json' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  that->_json = json;
+  that->_state = JSONFeederStateStart;
+  that->_depth = 0;
+  that->_key._len = 0;
+  that->_str._len = 0;
+  that->_flagEsc = false;
+  pthread_once(&JSONSimdOnce, JSONSimdInit);
+}
+
+// Push the node 'node' of type 'type' on the stack of the incremental 
+// parser 'that'
+static void JSONFeederPush(JSONFeeder* const that, JSONNode* const node, 
+  const char type) {
+  // If the stack is full, double its size
+  if (that->_depth == that->_size) {
+    long size = (that->_size > 0 ? 2 * that->_size : 16);
+    JSONFeederFrame* stack = 
+      PBErrMalloc(JSONErr, sizeof(JSONFeederFrame) * size);
+    if (that->_stack != NULL) {
+      memcpy(stack, that->_stack, sizeof(JSONFeederFrame) * that->_depth);
+      free(that->_stack);
+    }
+    that->_stack = stack;
+    that->_size = size;
+  }
+  that->_stack[that->_depth]._node = node;
+  that->_stack[that->_depth]._type = type;
+  ++(that->_depth);
+}
+
+// Update the state of the incremental parser 'that' after the end of a 
+// value
+static void JSONFeederValueDone(JSONFeeder* const that) {
+  // If the stack is empty, the JSON is complete
+  if (that->_depth == 0) {
+    that->_state = JSONFeederStateDone;
+    return;
+  }
+  // Else, the next state depends on the node containing the value
+  switch (that->_stack[that->_depth - 1]._type) {
+    case '{':
+      that->_state = JSONFeederStateObj;
+      break;
+    case '[':
+      that->_state = JSONFeederStateArrObjNext;
+      break;
+    default:
+      // End of the array at the root of the JSON
+      --(that->_depth);
+      that->_state = JSONFeederStateDone;
+      break;
+  }
+}
+
+// Scan the bytes of 'buf' from '*pos' up to 'len' for the end of the 
+// string being loaded by the incremental parser 'that', and append 
+// them to its string, decoded once the string is complete
+// Return true if the closing double quote has been found, false if not 
+// or if the string has an invalid escape sequence
+static bool JSONFeederLoadStr(JSONFeeder* const that, 
+  const char* const buf, const size_t len, size_t* const pos) {
+  // Scan the bytes for the closing double quote, a double quote after 
+  // an escape char is part of the string
+  size_t start = *pos;
+  size_t i = start;
+  if (that->_flagEsc && i < len) {
+    ++i;
+    that->_flagEsc = false;
+  }
+  while (true) {
+    i = JSONScanQuote(buf, i, len);
+    if (i >= len || buf[i] == '"')
+      break;
+    if (i + 1 < len) {
+      i += 2;
+    } else {
+      that->_flagEsc = true;
+      i = len;
+      break;
+    }
+  }
+  // Append the scanned bytes to the string
+  JSONStrBufAppend(&(that->_str), buf + start, i - start);
+  // If we have found the closing double quote, consume it and decode 
+  // the escape sequences of the string
+  if (i < len) {
+    *pos = i + 1;
+    JSONStrBuf* str = &(that->_str);
+    // JSONUnescape sets the error
+    if (!JSONUnescape(str->_str, str->_str, str->_len, &(str->_len))) {
+      that->_state = JSONFeederStateError;
+      return false;
+    }
+    str->_str[str->_len] = '\0';
+    return true;
+  }
+  *pos = i;
+  return false;
+}
+
+// Scan the bytes of 'buf' from '*pos' up to 'len' for the end of the 
+// number, boolean or null being loaded by the incremental parser 
+// 'that', and append them to its string. Once the value is complete, 
+// '*type' and '*val' are set to its type and native value
+// Return true if the value is complete, false if not or if it's not a 
+// valid value
+static bool JSONFeederLoadScalar(JSONFeeder* const that, 
+  const char* const buf, const size_t len, size_t* const pos, 
+  JSONType* const type, JSONPayload* const val) {
+  // Scan the bytes up to the first one which can't be part of the 
+  // value, it's the first char after the value and is not consumed
+  size_t start = *pos;
+  size_t i = start;
+  while (i < len && JSONIsScalarChar(buf[i]))
+    ++i;
+  *pos = i;
+  // Append the scanned bytes to the string, the value can't be longer 
+  // than a value loaded by JSONLoadScalar
+  if (that->_str._len + (i - start) > PBJSON_SCALARSIZE - 1) {
+    JSONErr->_type = PBErrTypeInvalidData;
+    sprintf(JSONErr->_msg, "JSONFeed: Value too long");
+    that->_state = JSONFeederStateError;
+    return false;
+  }
+  JSONStrBufAppend(&(that->_str), buf + start, i - start);
+  // If we have reached the end of the bytes, the value may continue in
+  // the next ones
+  if (i >= len)
+    return false;
+  // Convert the value
+  JSONStrBuf* str = &(that->_str);
+  str->_str[str->_len] = '\0';
+  if (!JSONScanScalar(str->_str, str->_len, type, val)) {
+    that->_state = JSONFeederStateError;
+    return false;
+  }
+  return true;
+}
+
+// Set the error of the incremental parser 'that' for the unexpected 
+// char at position 'pos' in the 'len' bytes of 'buf'
+// Return JSONFeedError
+static JSONFeedRet JSONFeederInvalid(JSONFeeder* const that, 
+  const char* const expected, const char* const buf, const size_t len, 
+  const size_t pos) {
+  // Get the context around the unexpected char
+  JSONReader reader;
+  JSONReaderInitBuffer(&reader, buf, len);
+  reader._pos = pos + 1;
+  char ctx[2 * PBJSON_CONTEXTSIZE + 1];
+  JSONGetContext(&reader, ctx);
+  // Set the error
+  JSONErr->_type = PBErrTypeInvalidData;
+  sprintf(JSONErr->_msg, 
+    "JSONFeed: Expected %s but found '%c' near ...%s...", 
+    expected, buf[pos], ctx);
+  that->_state = JSONFeederStateError;
+  return JSONFeedError;
+}
+
+// Feed the 'len' bytes of 'buf' to the incremental parser 'that'
+// The bytes can be any piece of the JSON, they are loaded as they 
+// arrive, without seeking or buffering the whole JSON
+// If 'nbUsed' is not NULL, it's set to the number of bytes consumed, 
+// which is less than 'len' only if the JSON is complete before the 
+// end of 'buf'
+// Return JSONFeedNeedMore until the JSON is complete, JSONFeedComplete 
+// once it is, or JSONFeedError if the bytes are not a valid JSON
+JSONFeedRet JSONFeed(JSONFeeder* const that, const char* const buf, 
+  const size_t len, size_t* const nbUsed) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (buf == NULL && len > 0) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'buf' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  // Declare a variable to memorize the position in the bytes
+  size_t pos = 0;
+  // Loop on the bytes until the end of the JSON
+  while (pos < len && that->_state != JSONFeederStateDone && 
+    that->_state != JSONFeederStateError) {
+    // If we are in a string
+    if (that->_state == JSONFeederStateKey || 
+      that->_state == JSONFeederStateValStr || 
+      that->_state == JSONFeederStateArrStr) {
+      // Load the string up to its end or the end of the bytes
+      if (!JSONFeederLoadStr(that, buf, len, &pos))
+        break;
+      JSONNode* top = that->_stack[that->_depth - 1]._node;
+      // If it's a key, memorize it
+      if (that->_state == JSONFeederStateKey) {
+        that->_key._len = 0;
+        JSONStrBufAppend(&(that->_key), that->_str._str, that->_str._len);
+        that->_state = JSONFeederStateColon;
+      // Else, if it's the value of a property, add the property
+      } else if (that->_state == JSONFeederStateValStr) {
+        JSONNode* nodeKey = JSONCreateChild(top);
+        JSONNode* nodeVal = JSONCreateChild(top);
+        JSONSetLabelLen(nodeKey, that->_key._str, that->_key._len);
+        JSONSetLabelLen(nodeVal, that->_str._str, that->_str._len);
+        JSONAppendVal(nodeKey, nodeVal);
+        JSONAppendVal(top, nodeKey);
+        that->_state = JSONFeederStateObj;
+      // Else, it's a value of an array, add it to the array
+      } else {
+        JSONNode* nodeVal = JSONCreateChild(top);
+        JSONSetLabelLen(nodeVal, that->_str._str, that->_str._len);
+        JSONAppendVal(top, nodeVal);
+        that->_state = JSONFeederStateArrValNext;
+      }
+      continue;
+    }
+    // If we are in a number, a boolean or null
+    if (that->_state == JSONFeederStateValScalar || 
+      that->_state == JSONFeederStateArrScalar) {
+      // Load the value up to its end or the end of the bytes
+      JSONType type = JSONTypeStr;
+      JSONPayload val;
+      if (!JSONFeederLoadScalar(that, buf, len, &pos, &type, &val))
+        break;
+      JSONNode* top = that->_stack[that->_depth - 1]._node;
+      JSONNode* nodeVal = JSONCreateChild(top);
+      JSONLblSetTyped(nodeVal, type, val);
+      // If it's the value of a property, add the property
+      if (that->_state == JSONFeederStateValScalar) {
+        JSONNode* nodeKey = JSONCreateChild(top);
+        JSONSetLabelLen(nodeKey, that->_key._str, that->_key._len);
+        JSONAppendVal(nodeKey, nodeVal);
+        JSONAppendVal(top, nodeKey);
+        that->_state = JSONFeederStateObj;
+      // Else, it's a value of an array, add it to the array
+      } else {
+        JSONAppendVal(top, nodeVal);
+        that->_state = JSONFeederStateArrValNext;
+      }
+      continue;
+    }
+    // Get the next char and skip it if it's not significant
+    char c = buf[pos];
+    ++pos;
+    if (c == ' ' || c == '\n' || c == '\t' || c == ',')
+      continue;
+    // Declare a variable to memorize the node receiving the value
+    JSONNode* top = 
+      (that->_depth > 0 ? that->_stack[that->_depth - 1]._node : NULL);
+    switch (that->_state) {
+      case JSONFeederStateStart:
+        if (c == '{') {
+          JSONFeederPush(that, that->_json, '{');
+          that->_state = JSONFeederStateObj;
+        } else if (c == '[') {
+          // The JSON is an array, it's loaded as a property with an 
+          // empty key of the root
+          JSONFeederPush(that, that->_json, '\0');
+          that->_key._len = 0;
+          JSONStrBufAppend(&(that->_key), "", 0);
+          that->_state = JSONFeederStateArrFirst;
+        } else {
+          return JSONFeederInvalid(that, "'{' or '['", buf, len, pos - 1);
+        }
+        break;
+      case JSONFeederStateObj:
+        if (c == '"') {
+          that->_str._len = 0;
+          that->_flagEsc = false;
+          that->_state = JSONFeederStateKey;
+        } else if (c == '}') {
+          --(that->_depth);
+          JSONFeederValueDone(that);
+        } else {
+          return JSONFeederInvalid(that, "'\"' or '}'", buf, len, pos - 1);
+        }
+        break;
+      case JSONFeederStateColon:
+        if (c == ':')
+          that->_state = JSONFeederStateValue;
+        else
+          return JSONFeederInvalid(that, "':'", buf, len, pos - 1);
+        break;
+      case JSONFeederStateValue:
+        if (c == '"') {
+          that->_str._len = 0;
+          that->_flagEsc = false;
+          that->_state = JSONFeederStateValStr;
+        } else if (JSONIsScalarStart(c)) {
+          that->_str._len = 0;
+          JSONStrBufAppend(&(that->_str), &c, 1);
+          that->_state = JSONFeederStateValScalar;
+        } else if (c == '[') {
+          that->_state = JSONFeederStateArrFirst;
+        } else if (c == '{') {
+          // Create the node of the object and load its properties
+          JSONNode* prop = JSONCreateChild(top);
+          JSONSetLabelLen(prop, that->_key._str, that->_key._len);
+          JSONAppendVal(top, prop);
+          JSONFeederPush(that, prop, '{');
+          that->_state = JSONFeederStateObj;
+        } else {
+          return JSONFeederInvalid(that, "a value,'{' or '['", 
+            buf, len, pos - 1);
+        }
+        break;
+      case JSONFeederStateArrFirst:
+        if (c == '"' || c == ']' || JSONIsScalarStart(c)) {
+          // Create the node of the property, its values are appended 
+          // to it as they are loaded
+          JSONNode* nodeKey = JSONCreateChild(top);
+          JSONSetLabelLen(nodeKey, that->_key._str, that->_key._len);
+          JSONAppendVal(top, nodeKey);
+          if (c == '"') {
+            JSONFeederPush(that, nodeKey, '"');
+            that->_str._len = 0;
+            that->_flagEsc = false;
+            that->_state = JSONFeederStateArrStr;
+          } else if (c != ']') {
+            JSONFeederPush(that, nodeKey, '"');
+            that->_str._len = 0;
+            JSONStrBufAppend(&(that->_str), &c, 1);
+            that->_state = JSONFeederStateArrScalar;
+          } else {
+            // An empty array has one empty value, as in _JSONAddPropArr
+            JSONAppendVal(nodeKey, JSONCreateChild(nodeKey));
+            JSONFeederValueDone(that);
+          }
+        } else if (c == '{') {
+          // Create the node of the property, with the '[]' prefix of 
+          // arrays of objects, and the node of the first object
+          JSONNode* nodeKey = JSONCreateChild(top);
+          JSONLbl* lbl = JSONLblCreate(nodeKey, that->_key._len + 2);
+          lbl->_str[0] = '[';
+          lbl->_str[1] = ']';
+          memcpy(lbl->_str + 2, that->_key._str, that->_key._len);
+          JSONLblAttach(nodeKey, lbl);
+          JSONAppendVal(top, nodeKey);
+          JSONFeederPush(that, nodeKey, '[');
+          JSONNode* obj = JSONCreateChild(nodeKey);
+          JSONAppendVal(nodeKey, obj);
+          JSONFeederPush(that, obj, '{');
+          that->_state = JSONFeederStateObj;
+        } else {
+          return JSONFeederInvalid(that, "a value or '{'", 
+            buf, len, pos - 1);
+        }
+        break;
+      case JSONFeederStateArrValNext:
+        if (c == '"') {
+          that->_str._len = 0;
+          that->_flagEsc = false;
+          that->_state = JSONFeederStateArrStr;
+        } else if (JSONIsScalarStart(c)) {
+          that->_str._len = 0;
+          JSONStrBufAppend(&(that->_str), &c, 1);
+          that->_state = JSONFeederStateArrScalar;
+        } else if (c == ']') {
+          --(that->_depth);
+          JSONFeederValueDone(that);
+        } else {
+          return JSONFeederInvalid(that, "a value or ']'", 
+            buf, len, pos - 1);
+        }
+        break;
+      case JSONFeederStateArrObjNext:
+        if (c == '{') {
+          JSONNode* obj = JSONCreateChild(top);
+          JSONAppendVal(top, obj);
+          JSONFeederPush(that, obj, '{');
+          that->_state = JSONFeederStateObj;
+        } else if (c == ']') {
+          --(that->_depth);
+          JSONFeederValueDone(that);
+        } else {
+          return JSONFeederInvalid(that, "'{' or ']'", buf, len, pos - 1);
+        }
+        break;
+      default:
+        break;
+    }
+  }
+  // Memorize the number of consumed bytes
+  if (nbUsed != NULL)
+    *nbUsed = pos;
+  // Return the state of the JSON
+  if (that->_state == JSONFeederStateDone)
+    return JSONFeedComplete;
+  else if (that->_state == JSONFeederStateError)
+    return JSONFeedError;
+  else
+    return JSONFeedNeedMore;
+}
+
+// Create a reader of JSON records, one per line, on the stream 
+// 'stream'
+JSONRecords* JSONRecordsCreate(FILE* const stream) {
+#if BUILDMODE == 0
+  if (stream == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'stream' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  // Allocate memory for the reader
+  JSONRecords* that = PBErrMalloc(JSONErr, sizeof(JSONRecords));
+  // Initialise properties
+  JSONReaderInitStream(&(that->_reader), stream);
+  that->_reader._flagReuse = true;
+  that->_arena = JSONArenaCreate();
+  that->_record = JSONCreateInArena(that->_arena);
+  that->_nbRecord = 0;
+  that->_flagError = false;
+  // Return the reader
+  return that;
+}
+
+// Create a reader of JSON records, one per line, on the 'len' first 
+// bytes of the buffer 'buf'
+// The buffer must stay valid until the reader is freed
+JSONRecords* JSONRecordsCreateFromBuffer(const char* const buf, 
+  const size_t len) {
+#if BUILDMODE == 0
+  if (buf == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'buf' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  // Allocate memory for the reader
+  JSONRecords* that = PBErrMalloc(JSONErr, sizeof(JSONRecords));
+  // Initialise properties
+  JSONReaderInitBuffer(&(that->_reader), buf, len);
+  that->_reader._flagReuse = true;
+  that->_arena = JSONArenaCreate();
+  that->_record = JSONCreateInArena(that->_arena);
+  that->_nbRecord = 0;
+  that->_flagError = false;
+  // Return the reader
+  return that;
+}
+
+// Free the memory used by the reader of records 'that' and its records
+// The unconsumed bytes are given back to the stream
+void JSONRecordsFree(JSONRecords** that) {
+  // Check arguments
+  if (that == NULL || *that == NULL)
+    // Nothing to do
+    return;
+  // Free memory
+  JSONReaderRelease(&((*that)->_reader));
+  JSONArenaFree(&((*that)->_arena));
+  free(*that);
+  *that = NULL;
+}
+
+// Load the next record of the reader 'that'
+// Empty lines are skipped
+// Return the record, or NULL if there is no more record or if the 
+// record is invalid (in which case JSONRecordsIsError() is true)
+// The record belongs to the reader and is valid until the next call, 
+// its nodes are reused for the next record
+JSONNode* JSONRecordsNext(JSONRecords* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  // If an error occured the position in the input is unknown, stop here
+  if (that->_flagError)
+    return NULL;
+  // Skip the empty lines up to the first char of the next record
+  char c;
+  do {
+    // If there is no more char, there is no more record
+    if (!JSONReaderGetChar(&(that->_reader), &c))
+      return NULL;
+  } while (c == ' ' || c == '\n' || c == '\t' || c == '\r');
+  // Give back the first char of the record, it has just been read 
+  // from the available bytes
+  --(that->_reader._pos);
+  // Load the record over the previous one
+  if (!JSONLoadFromReader(that->_record, &(that->_reader))) {
+    that->_flagError = true;
+    return NULL;
+  }
+  ++(that->_nbRecord);
+  // Return the record
+  return that->_record;
+}
+
+// Set the error used by the JSON functions in the calling thread to 
+// 'err', or back to the global JSONErr if 'err' is NULL
+// Each thread loading JSONs concurrently must use its own error
+void JSONSetThreadErr(PBErr* const err) {
+  JSONThreadErr = err;
+}
+
+// Return the error used by the JSON functions in the calling thread
+PBErr* JSONGetThreadErr(void) {
+  return JSONErr;
+}
+
+// Return the counters of the allocations made by the JSON functions in
+// the calling thread since the last call to JSONStatsReset
+JSONStats JSONStatsGet(void) {
+  return JSONStatsCur;
+}
+
+// Reset the statistics of the JSON functions in the calling thread
+void JSONStatsReset(void) {
+  JSONStatsCur = (JSONStats){0};
+}
+
+// Enable the timing of the phases in the statistics of the calling 
+// thread if 'flag' is true, disable it else. It's disabled by default 
+// as it reads the clock at each call and each block read or written
+void JSONStatsSetTiming(const bool flag) {
+  JSONStatsFlagTiming = flag;
+}
+
+// Return true if the timing of the phases is enabled in the calling 
+// thread, false else
+bool JSONStatsGetTiming(void) {
+  return JSONStatsFlagTiming;
+}
+
+// Save the statistics 'that' as a JSON object on the stream 'stream', 
+// with one property per field named as the field without its leading 
+// underscore
+// If 'compact' equals true save in compact form, else save in easily 
+// readable form
+// Return true if it could save, false else
+bool JSONStatsSave(const JSONStats* const that, FILE* const stream, 
+  const bool compact) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (stream == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'stream' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  // Names and values of the counters and of the times
+  const char* namesNb[] = {"nbNode", "nbLbl", "nbLblByte", 
+    "nbByteRead", "nbByteWritten", "depthMax", "nbLoad", "nbSave", "nbFree"};
+  const long valsNb[] = {that->_nbNode, that->_nbLbl, that->_nbLblByte,
+    that->_nbByteRead, that->_nbByteWritten, that->_depthMax, 
+    that->_nbLoad, that->_nbSave, that->_nbFree};
+  const char* namesTime[] = {"timeLoad", "timeRead", "timeSave", 
+    "timeWrite", "timeFree"};
+  const double valsTime[] = {that->_timeLoad, that->_timeRead, 
+    that->_timeSave, that->_timeWrite, that->_timeFree};
+  // Write them with the streaming writer
+  char buf[PBJSON_BLOCKSIZE];
+  JSONWriter writer = 
+    JSONWriterCreateStatic(stream, buf, PBJSON_BLOCKSIZE, compact);
+  bool ret = JSONWriterBeginObject(&writer);
+  for (size_t iNb = 0; ret && iNb < sizeof(valsNb) / sizeof(long); 
+    ++iNb)
+    ret = JSONWriterKey(&writer, namesNb[iNb]) && 
+      JSONWriterValue(&writer, valsNb[iNb]);
+  for (size_t iTime = 0; 
+    ret && iTime < sizeof(valsTime) / sizeof(double); ++iTime)
+    ret = JSONWriterKey(&writer, namesTime[iTime]) && 
+      JSONWriterValue(&writer, valsTime[iTime]);
+  ret = ret && JSONWriterEndObject(&writer) && 
+    JSONWriterEnd(&writer, NULL);
+  // Return the success code
+  return ret;
+}
+
+// Return the current time in seconds if the timing of the phases is 
+// enabled in the calling thread, 0.0 else
+static inline double JSONStatsClock(void) {
+  if (!JSONStatsFlagTiming)
+    return 0.0;
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Add to '*time' the time elapsed since 'start', got from 
+// JSONStatsClock, if the timing was enabled at 'start'
+static inline void JSONStatsAddTime(double* const time, 
+  const double start) {
+  if (start > 0.0)
+    *time += JSONStatsClock() - start;
+}
+
+// Update the statistics at the end of a call to a saving function 
+// started at 'start' and which has written 'nb' bytes
+static inline void JSONStatsEndSave(const size_t nb, 
+  const double start) {
+  ++(JSONStatsCur._nbSave);
+  JSONStatsCur._nbByteWritten += nb;
+  JSONStatsAddTime(&(JSONStatsCur._timeSave), start);
+}
+
+// Add the statistics 'stats' of a worker thread to the statistics of 
+// the calling thread
+static void JSONStatsMerge(const JSONStats* const stats) {
+  JSONStatsCur._nbNode += stats->_nbNode;
+  JSONStatsCur._nbLbl += stats->_nbLbl;
+  JSONStatsCur._nbLblByte += stats->_nbLblByte;
+  JSONStatsCur._nbByteRead += stats->_nbByteRead;
+  JSONStatsCur._nbByteWritten += stats->_nbByteWritten;
+  // The depth is a maximum, not a sum
+  if (stats->_depthMax > JSONStatsCur._depthMax)
+    JSONStatsCur._depthMax = stats->_depthMax;
+  JSONStatsCur._nbLoad += stats->_nbLoad;
+  JSONStatsCur._nbSave += stats->_nbSave;
+  JSONStatsCur._nbFree += stats->_nbFree;
+  JSONStatsCur._timeLoad += stats->_timeLoad;
+  JSONStatsCur._timeRead += stats->_timeRead;
+  JSONStatsCur._timeSave += stats->_timeSave;
+  JSONStatsCur._timeWrite += stats->_timeWrite;
+  JSONStatsCur._timeFree += stats->_timeFree;
+}
+
+// Run 'nbThread' threads executing 'fun' with the arguments 'args' of 
+// 'size' bytes each, and wait for their end
+// Return false if the threads couldn't be created
+static bool JSONRunThreads(void* (*fun)(void*), void* const args, 
+  const size_t size, const int nbThread) {
+  pthread_t* threads = PBErrMalloc(JSONErr, sizeof(pthread_t) * nbThread);
+  int nbRun = 0;
+  while (nbRun < nbThread && pthread_create(threads + nbRun, NULL, fun, 
+    (char*)args + size * nbRun) == 0)
+    ++nbRun;
+  for (int iThread = 0; iThread < nbRun; ++iThread)
+    pthread_join(threads[iThread], NULL);
+  free(threads);
+  if (nbRun < nbThread) {
+    JSONErr->_type = PBErrTypeOther;
+    sprintf(JSONErr->_msg, "JSONRunThreads: couldn't create the threads");
+    return false;
+  }
+  return true;
+}
+
+// Arguments shared by the threads of JSONLoadBuffersParallel
+typedef struct JSONLoadBuffersShared {
+  JSONNode** _jsons;
+  const char* const* _bufs;
+  const size_t* _lens;
+  long _nb;
+  PBErr* _errs;
+  // Index of the next buffer to load
+  _Atomic long _next;
+} JSONLoadBuffersShared;
+
+// Arguments of one thread of JSONLoadBuffersParallel
+typedef struct JSONLoadBuffersArg {
+  JSONLoadBuffersShared* _shared;
+  // Index of the first buffer which couldn't be loaded by this thread
+  long _firstErr;
+  // Error of the thread, for the buffer '_firstErr'
+  PBErr _err;
+  // Flag of the timing of the calling thread
+  bool _flagTiming;
+  // Statistics of the thread, merged into the ones of the calling 
+  // thread after its end
+  JSONStats _stats;
+} JSONLoadBuffersArg;
+
+// Thread loading the JSONs of JSONLoadBuffersParallel
+static void* JSONLoadBuffersThread(void* const arg) {
+  JSONLoadBuffersArg* that = arg;
+  JSONLoadBuffersShared* shared = that->_shared;
+  // Declare the error used while loading a buffer
+  PBErr err = that->_err;
+  JSONSetThreadErr(&err);
+  // Time the phases as in the calling thread
+  JSONStatsFlagTiming = that->_flagTiming;
+  // Loop on the buffers not yet loaded
+  long iBuf;
+  while ((iBuf = shared->_next++) < shared->_nb) {
+    // Load the buffer
+    err._type = PBErrTypeUnknown;
+    err._msg[0] = '\0';
+    bool ret = JSONLoadFromBuffer(shared->_jsons[iBuf], 
+      shared->_bufs[iBuf], shared->_lens[iBuf]);
+    // Memorize the error of the buffer
+    if (shared->_errs != NULL)
+      shared->_errs[iBuf] = err;
+    // Memorize the error of the first buffer of this thread which 
+    // couldn't be loaded
+    if (!ret && iBuf < that->_firstErr) {
+      that->_firstErr = iBuf;
+      that->_err = err;
+    }
+  }
+  // Give the statistics of the thread to the calling thread
+  that->_stats = JSONStatsCur;
+  JSONSetThreadErr(NULL);
+  return NULL;
+}
+
+// Load in parallel with 'nbThread' threads the 'nb' JSONs in the 
+// buffers 'bufs' of 'lens' bytes into the JSONs 'jsons'
+// Each JSON must be used by only one buffer
+// If 'errs' is not NULL, the error of each buffer is stored in the 
+// array of 'nb' PBErr 'errs'
+// Return true if all the buffers could be loaded, false else, in which 
+// case the error of the first invalid buffer is copied in the error of
+// the calling thread
+bool JSONLoadBuffersParallel(JSONNode** const jsons, 
+  const char* const* const bufs, const size_t* const lens, 
+  const long nb, const int nbThread, PBErr* const errs) {
+#if BUILDMODE == 0
+  if (jsons == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'jsons' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (bufs == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'bufs' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (lens == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'lens' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (nbThread < 1) {
+    JSONErr->_type = PBErrTypeInvalidArg;
+    sprintf(JSONErr->_msg, "'nbThread' is invalid (%d>0)", nbThread);
+    PBErrCatch(JSONErr);
+  }
+#endif
+  // Declare the arguments of the threads, each thread has its own 
+  // error initialised from the error of the calling thread
+  JSONLoadBuffersShared shared;
+  shared._jsons = jsons;
+  shared._bufs = bufs;
+  shared._lens = lens;
+  shared._nb = nb;
+  shared._errs = errs;
+  shared._next = 0;
+  JSONLoadBuffersArg* args = 
+    PBErrMalloc(JSONErr, sizeof(JSONLoadBuffersArg) * nbThread);
+  for (int iThread = 0; iThread < nbThread; ++iThread) {
+    args[iThread]._shared = &shared;
+    args[iThread]._firstErr = nb;
+    args[iThread]._err = *JSONErr;
+    args[iThread]._flagTiming = JSONStatsFlagTiming;
+    args[iThread]._stats = (JSONStats){0};
+  }
+  // Run the threads
+  bool ret = JSONRunThreads(JSONLoadBuffersThread, args, 
+    sizeof(JSONLoadBuffersArg), nbThread);
+  // Add the statistics of the threads to the ones of the calling thread
+  for (int iThread = 0; iThread < nbThread; ++iThread)
+    JSONStatsMerge(&(args[iThread]._stats));
+  // If a buffer couldn't be loaded, report the error of the first one
+  if (ret) {
+    long firstErr = nb;
+    for (int iThread = 0; iThread < nbThread; ++iThread) {
+      if (args[iThread]._firstErr < firstErr) {
+        firstErr = args[iThread]._firstErr;
+        JSONErr->_type = args[iThread]._err._type;
+        strcpy(JSONErr->_msg, args[iThread]._err._msg);
+        ret = false;
+      }
+    }
+  }
+  // Free memory
+  free(args);
+  // Return the success code
+  return ret;
+}
+
+// Arguments shared by the threads of JSONRecordsParallel
+typedef struct JSONRecordsShared {
+  const char* _buf;
+  // Position of the beginning of each chunk, plus the end of the buffer
+  size_t* _chunks;
+  long _nbChunk;
+  bool (*_fun)(JSONNode* const record, const int iThread, 
+    void* const data);
+  void* _data;
+  // Index of the next chunk to read
+  _Atomic long _next;
+  // Flag to stop the reading
+  _Atomic bool _flagStop;
+} JSONRecordsShared;
+
+// Arguments of one thread of JSONRecordsParallel
+typedef struct JSONRecordsArg {
+  JSONRecordsShared* _shared;
+  // Index of the thread
+  int _iThread;
+  // Index of the first chunk which couldn't be read by this thread
+  long _firstErr;
+  // Error of the thread, for the chunk '_firstErr'
+  PBErr _err;
+  // Flag of the timing of the calling thread
+  bool _flagTiming;
+  // Statistics of the thread, merged into the ones of the calling 
+  // thread after its end
+  JSONStats _stats;
+} JSONRecordsArg;
+
+// Thread reading the records of JSONRecordsParallel
+static void* JSONRecordsThread(void* const arg) {
+  JSONRecordsArg* that = arg;
+  JSONRecordsShared* shared = that->_shared;
+  JSONSetThreadErr(&(that->_err));
+  // Time the phases as in the calling thread
+  JSONStatsFlagTiming = that->_flagTiming;
+  // Declare the reader of records, reused for all the chunks of the 
+  // thread, with a reader on an empty buffer
+  JSONRecords* records = JSONRecordsCreateFromBuffer(shared->_buf, 0);
+  // Loop on the chunks not yet read
+  long iChunk;
+  while (!shared->_flagStop && 
+    (iChunk = shared->_next++) < shared->_nbChunk) {
+    // Move the reader to the chunk
+    JSONReaderRelease(&(records->_reader));
+    JSONReaderInitBuffer(&(records->_reader), 
+      shared->_buf + shared->_chunks[iChunk], 
+      shared->_chunks[iChunk + 1] - shared->_chunks[iChunk]);
+    records->_reader._flagReuse = true;
+    // Loop on the records of the chunk
+    JSONNode* record = NULL;
+    bool ret = true;
+    while (ret && !shared->_flagStop && 
+      (record = JSONRecordsNext(records)) != NULL) {
+      if (!shared->_fun(record, that->_iThread, shared->_data)) {
+        that->_err._type = PBErrTypeOther;
+        sprintf(that->_err._msg, 
+          "JSONRecordsParallel: Stopped by the callback");
+        ret = false;
+      }
+    }
+    if (JSONRecordsIsError(records)) {
+      records->_flagError = false;
+      ret = false;
+    }
+    // If the chunk couldn't be read, stop the reading
+    if (!ret) {
+      that->_firstErr = iChunk;
+      shared->_flagStop = true;
+    }
+  }
+  JSONRecordsFree(&records);
+  // Give the statistics of the thread to the calling thread
+  that->_stats = JSONStatsCur;
+  JSONSetThreadErr(NULL);
+  return NULL;
+}
+
+// Read in parallel with 'nbThread' threads the records, one per line, 
+// in the 'len' bytes of the buffer 'buf'
+// The buffer is split in chunks at line boundaries, each thread reads 
+// its chunks with its own JSONRecords and error, and calls 'fun' on 
+// each record with the index of the thread (to manage per-thread data) 
+// and 'data'. The records are not given in the order of the buffer. If
+// 'fun' returns false the reading stops.
+// Return true if all the records could be read, false else, in which 
+// case the error of the first invalid record is copied in the error of
+// the calling thread
+bool JSONRecordsParallel(const char* const buf, const size_t len, 
+  const int nbThread, bool (*fun)(JSONNode* const record, 
+  const int iThread, void* const data), void* const data) {
+#if BUILDMODE == 0
+  if (buf == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'buf' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (fun == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'fun' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (nbThread < 1) {
+    JSONErr->_type = PBErrTypeInvalidArg;
+    sprintf(JSONErr->_msg, "'nbThread' is invalid (%d>0)", nbThread);
+    PBErrCatch(JSONErr);
+  }
+#endif
+  // Split the buffer in several chunks per thread, to balance the load
+  // between threads, moving the end of each chunk to the end of its 
+  // line
+  long nbChunk = (long)nbThread * PBJSON_CHUNKPERTHREAD;
+  size_t* chunks = PBErrMalloc(JSONErr, sizeof(size_t) * (nbChunk + 1));
+  chunks[0] = 0;
+  for (long iChunk = 1; iChunk <= nbChunk; ++iChunk) {
+    size_t pos = len / nbChunk * iChunk;
+    if (pos < chunks[iChunk - 1])
+      pos = chunks[iChunk - 1];
+    while (pos < len && buf[pos] != '\n')
+      ++pos;
+    chunks[iChunk] = (iChunk == nbChunk || pos >= len ? len : pos + 1);
+  }
+  // Declare the arguments of the threads, each thread has its own 
+  // error initialised from the error of the calling thread
+  JSONRecordsShared shared;
+  shared._buf = buf;
+  shared._chunks = chunks;
+  shared._nbChunk = nbChunk;
+  shared._fun = fun;
+  shared._data = data;
+  shared._next = 0;
+  shared._flagStop = false;
+  JSONRecordsArg* args = 
+    PBErrMalloc(JSONErr, sizeof(JSONRecordsArg) * nbThread);
+  for (int iThread = 0; iThread < nbThread; ++iThread) {
+    args[iThread]._shared = &shared;
+    args[iThread]._iThread = iThread;
+    args[iThread]._firstErr = nbChunk;
+    args[iThread]._err = *JSONErr;
+    args[iThread]._flagTiming = JSONStatsFlagTiming;
+    args[iThread]._stats = (JSONStats){0};
+  }
+  // Run the threads
+  bool ret = JSONRunThreads(JSONRecordsThread, args, 
+    sizeof(JSONRecordsArg), nbThread);
+  // Add the statistics of the threads to the ones of the calling thread
+  for (int iThread = 0; iThread < nbThread; ++iThread)
+    JSONStatsMerge(&(args[iThread]._stats));
+  // If a chunk couldn't be read, report the error of the first one
+  if (ret) {
+    long firstErr = nbChunk;
+    for (int iThread = 0; iThread < nbThread; ++iThread) {
+      if (args[iThread]._firstErr < firstErr) {
+        firstErr = args[iThread]._firstErr;
+        JSONErr->_type = args[iThread]._err._type;
+        strcpy(JSONErr->_msg, args[iThread]._err._msg);
+        ret = false;
+      }
+    }
+  }
+  // Free memory
+  free(args);
+  free(chunks);
+  // Return the success code
+  return ret;
+}
+
+// Return the JSONNode of the property with label 'lbl' of the 
+// JSON 'that'
+// If the property doesn't exist return NULL
+JSONNode* JSONProperty(const JSONNode* const that, 
+  const char* const lbl) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (lbl == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'lbl' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  // If the JSONNode has enough properties to make the index worth it
+  if (JSONGetNbValue(that) >= PBJSON_INDEXMIN) {
+    // Get the index, the index is a cache and doesn't modify the 
+    // content of the JSON
+    JSONIndex* index = JSONGetIndex((JSONNode*)that);
+    JSONIndexHashNodes(index);
+    // Loop on the slots from the one of the hash of the label
+    size_t mask = index->_nbSlot - 1;
+    size_t iSlot = JSONIndexHash(lbl) & mask;
+    while (index->_slots[iSlot] != 0) {
+      // Get the property in the slot
+      JSONNode* prop = index->_nodes[index->_slots[iSlot] - 1];
+      // Skip the eventual '[]'
+      char* propLbl = JSONLabel(prop);
+      if (propLbl[0] == '[' && propLbl[1] == ']')
+        propLbl += 2;
+      // If the label of the property is the same as the searched
+      // property
+      if (strcmp(propLbl, lbl) == 0)
+        // Return the property
+        return prop;
+      iSlot = (iSlot + 1) & mask;
+    }
+  // Else, if the JSONNode has properties
+  } else if (JSONGetNbValue(that) > 0) {
+    // Declare an iterator on properties of the JSONNode
+    GSetIterForward iter = 
+      GSetIterForwardCreateStatic(JSONProperties(that));
+    // Loop on properties
+    do {
+      // Get the property
+      JSONNode* prop = GSetIterGet(&iter);
+      // Skip the eventual '[]'
+      char* propLbl = JSONLabel(prop);
+      if (propLbl == NULL)
+        continue;
+      if (propLbl[0] == '[' && propLbl[1] == ']')
+        propLbl += 2;
+      // If the label of the property is the same as the searched
+      // property
+      if (strcmp(propLbl, lbl) == 0) {
+        // Return the property
+        return prop;
+      }
+    } while (GSetIterStep(&iter));
+  }
+  // If we reach here it means the searched property doesn't exist
+  return NULL;
+}
+
+// Free the memory used by the JSONLbl 'that', its index and its cache
+static inline void JSONLblFree(JSONLbl* const that) {
+  if (that != NULL) {
+    JSONIndexFree(&(that->_index));
+    JSONCacheFree(&(that->_cache));
+    if (that->_arena == NULL)
+      free(that);
+  }
+}
+
+// Return the JSONLbl of the node 'that', creating one without label if
+// the node has none yet
+static JSONLbl* JSONGetLbl(JSONNode* const that) {
+  JSONLbl* lbl = (JSONLbl*)GenTreeData(that);
+  if (lbl == NULL) {
+    ++(JSONStatsCur._nbLbl);
+    JSONStatsCur._nbLblByte += sizeof(JSONLbl);
+    lbl = PBErrMalloc(JSONErr, sizeof(JSONLbl));
+    lbl->_str = NULL;
+    lbl->_size = 0;
+    lbl->_arena = NULL;
+    lbl->_index = NULL;
+    lbl->_cache = NULL;
+    lbl->_type = JSONTypeStr;
+    lbl->_flagBorrowed = false;
+    lbl->_lazy = NULL;
+    lbl->_lazyLen = 0;
+    GenTreeSetData(that, (void*)lbl);
+  }
+  return lbl;
+}
+
+// Enable the cache of the serialization in compact form of the node 
+// 'that' when it's not the root of the saved JSON, which lets JSONSave
+// and JSONGetSaveSize skip it while it's unchanged
+// The length of the serialization is always cached, its bytes are 
+// cached too if 'flagBytes' equals true
+// The cache is invalidated when the node or one of its subtrees is 
+// modified through JSONSetLabel, JSONAddProp, JSONAppendVal or a load
+void JSONCacheEnable(JSONNode* const that, const bool flagBytes) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  JSONLbl* lbl = JSONGetLbl(that);
+  // Create the cache if it doesn't exist yet
+  JSONCache* cache = lbl->_cache;
+  if (cache == NULL) {
+    cache = PBErrMalloc(JSONErr, sizeof(JSONCache));
+    cache->_len = 0;
+    cache->_bytes = NULL;
+    cache->_flagValid = false;
+    lbl->_cache = cache;
+    ++JSONNbCache;
+  }
+  // Update the caching of the bytes
+  cache->_flagBytes = flagBytes;
+  if (!flagBytes) {
+    free(cache->_bytes);
+    cache->_bytes = NULL;
+  } else if (cache->_bytes == NULL) {
+    cache->_flagValid = false;
+  }
+}
+
+// Disable and free the cache of the serialization of the node 'that'
+void JSONCacheDisable(JSONNode* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  JSONLbl* lbl = (JSONLbl*)GenTreeData(that);
+  if (lbl != NULL)
+    JSONCacheFree(&(lbl->_cache));
+}
+
+// Free the memory used by the cache 'that'
+static void JSONCacheFree(JSONCache** that) {
+  // Check arguments
+  if (that == NULL || *that == NULL)
+    // Nothing to do
+    return;
+  // Free memory
+  free((*that)->_bytes);
+  free(*that);
+  *that = NULL;
+  --JSONNbCache;
+}
+
+// Free the memory used by the index 'that'
+static void JSONIndexFree(JSONIndex** that) {
+  // Check arguments
+  if (that == NULL || *that == NULL)
+    // Nothing to do
+    return;
+  // Free memory
+  free((*that)->_nodes);
+  free((*that)->_slots);
+  free(*that);
+  *that = NULL;
+}
+
+// Return the hash of the label 'lbl', skipping the eventual '[]'
+// (FNV-1a)
+static inline size_t JSONIndexHash(const char* lbl) {
+  if (lbl[0] == '[' && lbl[1] == ']')
+    lbl += 2;
+  size_t hash = 2166136261u;
+  for (const unsigned char* c = (const unsigned char*)lbl; *c; ++c) {
+    hash ^= *c;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+// Return the index on the subtrees of the node 'that', creating it or 
+// updating its array of subtrees if necessary
+static JSONIndex* JSONGetIndex(JSONNode* const that) {
+  // Get the data of the node, the node may have no label and no data 
+  // yet
+  JSONLbl* lbl = JSONGetLbl(that);
+  // Create the index if it doesn't exist yet
+  JSONIndex* index = lbl->_index;
+  if (index == NULL) {
+    index = PBErrMalloc(JSONErr, sizeof(JSONIndex));
+    index->_nb = 0;
+    index->_size = 0;
+    index->_nodes = NULL;
+    index->_flagStale = false;
+    index->_nbHashed = 0;
+    index->_slots = NULL;
+    index->_nbSlot = 0;
+    lbl->_index = index;
+  }
+  // If the array of subtrees is up to date, return the index
+  long nb = JSONGetNbValue(that);
+  if (index->_nb == nb)
+    return index;
+  // If subtrees have been removed, the array and the hash table are 
+  // rebuilt from scratch
+  if (index->_nb > nb) {
+    index->_nb = 0;
+    index->_nbHashed = 0;
+  }
+  // Grow the array of subtrees if necessary
+  if (index->_size < nb) {
+    index->_size = (index->_size > 0 ? index->_size : PBJSON_INDEXMIN);
+    while (index->_size < nb)
+      index->_size *= 2;
+    JSONNode** nodes = 
+      PBErrMalloc(JSONErr, sizeof(JSONNode*) * index->_size);
+    if (index->_nodes != NULL) {
+      memcpy(nodes, index->_nodes, sizeof(JSONNode*) * index->_nb);
+      free(index->_nodes);
+    }
+    index->_nodes = nodes;
+  }
+  // Subtrees can only be appended to a JSON node, so the missing ones 
+  // are the last ones. Loop on them backward from the last subtree.
+  GSetIterBackward iter = 
+    GSetIterBackwardCreateStatic(JSONProperties(that));
+  for (long iNode = nb; iNode-- > index->_nb;) {
+    index->_nodes[iNode] = GSetIterGet(&iter);
+    (void)GSetIterStep(&iter);
+  }
+  index->_nb = nb;
+  // Return the index
+  return index;
+}
+
+// Update the hash table of the index 'that'
+static void JSONIndexHashNodes(JSONIndex* const that) {
+  // If nodes have been relabelled since the hash table has been built, 
+  // or if the table is too small to keep its load under one half, 
+  // rebuild the table
+  if (that->_flagStale || 
+    that->_nbSlot < 2 * (size_t)(that->_nb)) {
+    if (that->_nbSlot < 2 * (size_t)(that->_nb)) {
+      if (that->_nbSlot == 0)
+        that->_nbSlot = 1;
+      while (that->_nbSlot < 2 * (size_t)(that->_nb))
+        that->_nbSlot *= 2;
+      free(that->_slots);
+      that->_slots = PBErrMalloc(JSONErr, sizeof(long) * that->_nbSlot);
+    }
+    memset(that->_slots, 0, sizeof(long) * that->_nbSlot);
+    that->_flagStale = false;
+    that->_nbHashed = 0;
+  }
+  size_t mask = that->_nbSlot - 1;
+  // Loop on the subtrees not yet in the table
+  for (long iNode = that->_nbHashed; iNode < that->_nb; ++iNode) {
+    // If the subtree has a label, add it to the hash table. If several 
+    // subtrees have the same label only the first one is added, as 
+    // the linear search would do
+    char* nodeLbl = JSONLabel(that->_nodes[iNode]);
+    if (nodeLbl != NULL) {
+      if (nodeLbl[0] == '[' && nodeLbl[1] == ']')
+        nodeLbl += 2;
+      size_t iSlot = JSONIndexHash(nodeLbl) & mask;
+      bool flagDuplicate = false;
+      while (!flagDuplicate && that->_slots[iSlot] != 0) {
+        char* slotLbl = JSONLabel(that->_nodes[that->_slots[iSlot] - 1]);
+        if (slotLbl[0] == '[' && slotLbl[1] == ']')
+          slotLbl += 2;
+        flagDuplicate = (strcmp(slotLbl, nodeLbl) == 0);
+        iSlot = (iSlot + 1) & mask;
+      }
+      if (!flagDuplicate)
+        that->_slots[iSlot] = iNode + 1;
+    }
+  }
+  that->_nbHashed = that->_nb;
+}
+
+// Empty the hash table of the index of the node 'that', if any
+// If 'flagNodes' is true, empty its array of subtrees too
+static void JSONIndexInvalidate(JSONNode* const that, 
+  const bool flagNodes) {
+  JSONLbl* lbl = (JSONLbl*)GenTreeData(that);
+  if (lbl == NULL || lbl->_index == NULL)
+    return;
+  JSONIndex* index = lbl->_index;
+  if (flagNodes)
+    index->_nb = 0;
+  if (index->_nbHashed > 0) {
+    memset(index->_slots, 0, sizeof(long) * index->_nbSlot);
+    index->_nbHashed = 0;
+  }
+}
+
+// Return the 'iVal'-th value of the JSON 'that'
+// If 'that' has at least PBJSON_INDEXMIN values, the first call builds 
+// an array of its values which makes the following calls constant time. 
+// The array is updated automatically when values are appended
+JSONNode* JSONValue(const JSONNode* const that, const long iVal) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (iVal < 0 || iVal >= JSONGetNbValue(that)) {
+    JSONErr->_type = PBErrTypeInvalidArg;
+    sprintf(JSONErr->_msg, "'iVal' is invalid (0<=%ld<%ld)", 
+      iVal, JSONGetNbValue(that));
+    PBErrCatch(JSONErr);
+  }
+#endif
+  // If the JSON has few values or the first one is requested, walk 
+  // through the set of subtrees
+  if (iVal == 0 || JSONGetNbValue(that) < PBJSON_INDEXMIN)
+    return (JSONNode*)GenTreeSubtree(that, iVal);
+  // Else, use the array of subtrees of the index
+  JSONIndex* index = JSONGetIndex((JSONNode*)that);
+  return index->_nodes[iVal];
+}
+
+// Return the values of the JSON 'that' as an array of 
+// JSONGetNbValue(that) nodes, in order
+// The array belongs to 'that' and is valid until values are added to 
+// or removed from 'that'
+JSONNode* const* JSONGetValues(const JSONNode* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  JSONIndex* index = JSONGetIndex((JSONNode*)that);
+  return index->_nodes;
+}
+
+// Return true if the char 'c' ends a key of a step '.key' of a path
+static inline bool JSONPathIsKeyEnd(const char c) {
+  return (c == '\0' || c == '.' || c == '[');
+}
+
+// Parse the optional integer at the position '*pos' of the path 
+// expression 'expr' into '*val', and move '*pos' after it
+// Return true if there was an integer, false else
+static bool JSONPathParseLong(const char* const expr, size_t* const pos,
+  long* const val) {
+  // Get the sign
+  size_t i = *pos;
+  bool flagNeg = (expr[i] == '-');
+  if (flagNeg)
+    ++i;
+  // If there is no digit, there is no integer
+  if (expr[i] < '0' || expr[i] > '9')
+    return false;
+  // Accumulate the digits
+  long v = 0;
+  while (expr[i] >= '0' && expr[i] <= '9') {
+    v = v * 10 + (expr[i] - '0');
+    ++i;
+  }
+  *val = (flagNeg ? -v : v);
+  *pos = i;
+  return true;
+}
+
+// Compile the path expression 'expr' which selects nodes in a JSON
+// Return the compiled path, or NULL if the expression is invalid
+JSONPath* JSONPathCompile(const char* const expr) {
+#if BUILDMODE == 0
+  if (expr == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'expr' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  // Allocate memory for the path, each step takes at least two chars 
+  // of the expression and the keys are not longer than the expression
+  size_t len = strlen(expr);
+  JSONPath* that = PBErrMalloc(JSONErr, sizeof(JSONPath));
+  that->_nb = 0;
+  that->_steps = PBErrMalloc(JSONErr, sizeof(JSONPathStep) * (len / 2 + 1));
+  that->_keys = PBErrMalloc(JSONErr, sizeof(char) * (len + 1));
+  char* key = that->_keys;
+  // The expression starts with the root
+  size_t pos = 0;
+  bool ret = (expr[pos] == '$');
+  if (ret)
+    ++pos;
+  // Loop on the steps
+  while (ret && expr[pos] != '\0') {
+    JSONPathStep* step = that->_steps + that->_nb;
+    step->_key = NULL;
+    step->_lenKey = 0;
+    step->_start = 0;
+    step->_end = 0;
+    step->_flagStart = false;
+    step->_flagEnd = false;
+    step->_step = 1;
+    // If it's a step .key or .*
+    if (expr[pos] == '.') {
+      ++pos;
+      if (expr[pos] == '*') {
+        step->_type = JSONPathStepWild;
+        ++pos;
+      } else {
+        step->_type = JSONPathStepKey;
+        step->_key = key;
+        while (!JSONPathIsKeyEnd(expr[pos])) {
+          *(key++) = expr[pos];
+          ++pos;
+        }
+        step->_lenKey = key - step->_key;
+        *(key++) = '\0';
+        ret = (step->_lenKey > 0);
+      }
+    // Else, if it's a step between square brackets
+    } else if (expr[pos] == '[') {
+      ++pos;
+      // If it's a key between quotes, the backslash escapes the next 
+      // char
+      if (expr[pos] == '\'' || expr[pos] == '"') {
+        char quote = expr[pos];
+        ++pos;
+        step->_type = JSONPathStepKey;
+        step->_key = key;
+        while (expr[pos] != '\0' && expr[pos] != quote) {
+          if (expr[pos] == '\\' && expr[pos + 1] != '\0')
+            ++pos;
+          *(key++) = expr[pos];
+          ++pos;
+        }
+        step->_lenKey = key - step->_key;
+        *(key++) = '\0';
+        ret = (expr[pos] == quote);
+        if (ret)
+          ++pos;
+      // Else, if it's a wildcard
+      } else if (expr[pos] == '*') {
+        step->_type = JSONPathStepWild;
+        ++pos;
+      // Else, it's an index or a slice
+      } else {
+        step->_flagStart = 
+          JSONPathParseLong(expr, &pos, &(step->_start));
+        if (expr[pos] != ':') {
+          step->_type = JSONPathStepIndex;
+          ret = step->_flagStart;
+        } else {
+          step->_type = JSONPathStepSlice;
+          ++pos;
+          step->_flagEnd = JSONPathParseLong(expr, &pos, &(step->_end));
+          if (expr[pos] == ':') {
+            ++pos;
+            ret = JSONPathParseLong(expr, &pos, &(step->_step)) &&
+              step->_step >= 1;
+          }
+        }
+      }
+      // The step ends with the closing square bracket
+      if (ret && expr[pos] == ']')
+        ++pos;
+      else
+        ret = false;
+    // Else, the expression is invalid
+    } else {
+      ret = false;
+    }
+    if (ret)
+      ++(that->_nb);
+  }
+  // If the expression is invalid, free the path
+  if (!ret) {
+    JSONErr->_type = PBErrTypeInvalidArg;
+    sprintf(JSONErr->_msg, "JSONPathCompile: Invalid expression at "
+      "position %zu", pos);
+    JSONPathFree(&that);
+  }
+  // Return the compiled path
+  return that;
+}
+
+// Free the memory used by the compiled path 'that'
+void JSONPathFree(JSONPath** that) {
+  // Check arguments
+  if (that == NULL || *that == NULL)
+    // Nothing to do
+    return;
+  // Free memory
+  free((*that)->_steps);
+  free((*that)->_keys);
+  free(*that);
+  *that = NULL;
+}
+
+// Get in '*start' and '*end' the first position and the position after
+// the last one of the values selected by the slice 'step' among 'nb' 
+// values, in [0, nb]
+static void JSONPathGetRange(const JSONPathStep* const step, 
+  const long nb, long* const start, long* const end) {
+  *start = (step->_flagStart ? step->_start : 0);
+  *end = (step->_flagEnd ? step->_end : nb);
+  if (*start < 0)
+    *start += nb;
+  if (*end < 0)
+    *end += nb;
+  if (*start < 0)
+    *start = 0;
+  if (*end > nb)
+    *end = nb;
+}
+
+// Append to 'matches' the nodes selected by the steps from the 
+// 'iStep'-th one of the path 'that' among the subtrees of the node 
+// 'node', up to 'max' nodes in total if it's positive. '*nb' is the 
+// number of nodes appended so far
+static void JSONPathEvalRec(const JSONPath* const that, const long iStep, 
+  const JSONNode* const node, JSONArrayStruct* const matches, 
+  long* const nb, const long max) {
+  // If all the steps have been applied, the node is selected
+  if (iStep == that->_nb) {
+    JSONArrayStructAdd(matches, (JSONNode*)node);
+    ++(*nb);
+    return;
+  }
+  const JSONPathStep* step = that->_steps + iStep;
+  long nbVal = JSONGetNbValue(node);
+  // If the step selects a property, look it up in the index if the 
+  // node has one. The values of an array are not properties
+  if (step->_type == JSONPathStepKey) {
+    JSONNode* prop = JSONProperty(node, step->_key);
+    if (prop != NULL && !JSONIsValue(prop))
+      JSONPathEvalRec(that, iStep + 1, prop, matches, nb, max);
+  // Else, if the step selects one value
+  } else if (step->_type == JSONPathStepIndex) {
+    long iVal = (step->_start < 0 ? step->_start + nbVal : step->_start);
+    if (iVal >= 0 && iVal < nbVal)
+      JSONPathEvalRec(that, iStep + 1, JSONValue(node, iVal), matches, 
+        nb, max);
+  // Else, if the step selects several values and the node has enough 
+  // of them to jump from one to the next with the index
+  } else if (step->_type == JSONPathStepSlice && 
+    nbVal >= PBJSON_INDEXMIN) {
+    long start = 0;
+    long end = 0;
+    JSONPathGetRange(step, nbVal, &start, &end);
+    JSONNode* const* vals = JSONGetValues(node);
+    for (long iVal = start; iVal < end && (max <= 0 || *nb < max); 
+      iVal += step->_step)
+      JSONPathEvalRec(that, iStep + 1, vals[iVal], matches, nb, max);
+  // Else, walk through the values
+  } else if (nbVal > 0) {
+    long start = 0;
+    long end = nbVal;
+    if (step->_type == JSONPathStepSlice)
+      JSONPathGetRange(step, nbVal, &start, &end);
+    GSetIterForward iter = 
+      GSetIterForwardCreateStatic(JSONProperties(node));
+    long iVal = 0;
+    do {
+      if (iVal >= end || (max > 0 && *nb >= max))
+        break;
+      if (iVal >= start && (iVal - start) % step->_step == 0)
+        JSONPathEvalRec(that, iStep + 1, GSetIterGet(&iter), matches, 
+          nb, max);
+      ++iVal;
+    } while (GSetIterStep(&iter));
+  }
+}
+
+// Append to 'matches' the nodes of the JSON 'json' selected by the 
+// compiled path 'that', in the order of the JSON
+// Return the number of nodes appended
+long JSONPathEval(const JSONPath* const that, const JSONNode* const json, 
+  JSONArrayStruct* const matches) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (json == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'json' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (matches == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'matches' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  long nb = 0;
+  JSONPathEvalRec(that, 0, json, matches, &nb, 0);
+  return nb;
+}
+
+// Return the first node of the JSON 'json' selected by the compiled 
+// path 'that', NULL if there is none
+JSONNode* JSONPathGet(const JSONPath* const that, 
+  const JSONNode* const json) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (json == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'json' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  // Stop the evaluation at the first selected node
+  JSONArrayStruct matches = JSONArrayStructCreateStatic();
+  long nb = 0;
+  JSONPathEvalRec(that, 0, json, &matches, &nb, 1);
+  JSONNode* node = (nb > 0 ? GSetGet(&matches, 0) : NULL);
+  JSONArrayStructFlush(&matches);
+  return node;
+}
+
+// Return true if the 'iVal'-th subtree of a node, with key 'key' of 
+// length 'lenKey' if it's a property (NULL else), is selected by the 
+// step 'step' of a path whose positions are not relative to the end
+static bool JSONPathSelect(const JSONPathStep* const step, 
+  const long iVal, const char* const key, const size_t lenKey) {
+  switch (step->_type) {
+    case JSONPathStepKey:
+      return (key != NULL && lenKey == step->_lenKey && 
+        memcmp(key, step->_key, lenKey) == 0);
+    case JSONPathStepWild:
+      return true;
+    case JSONPathStepIndex:
+      return (iVal == step->_start);
+    case JSONPathStepSlice: {
+      long start = (step->_flagStart ? step->_start : 0);
+      return (iVal >= start && (!(step->_flagEnd) || iVal < step->_end) &&
+        (iVal - start) % step->_step == 0);
+    }
+    default:
+      return false;
+  }
+}
+
+// Skip the value starting with the char 'c', already consumed, from the
+// reader 'reader'
+// Return true if it could skip, false else
+static bool JSONPathSkipVal(JSONReader* const reader, const char c) {
+  if (c == '"') {
+    const char* str = NULL;
+    size_t len = 0;
+    return JSONLoadStr(reader, &str, &len);
+  } else if (c == '{' || c == '[') {
+    char first = '\0';
+    return JSONLoadSkip(reader, NULL, NULL, NULL, &first);
+  } else {
+    JSONType type = JSONTypeStr;
+    JSONPayload val;
+    return JSONLoadScalar(reader, c, &type, &val);
+  }
+}
+
+// Load the string, number, boolean or null starting with the char 'c',
+// already consumed, from the reader 'reader', as the next child of the
+// cursor 'cursor' if 'flagMatch' is true, else only consume it
+// Return true if it could load, false else
+static bool JSONPathLoadLeaf(JSONLoadCursor* const cursor, 
+  JSONReader* const reader, const char c, const bool flagMatch) {
+  if (c == '"') {
+    const char* str = NULL;
+    size_t len = 0;
+    if (!JSONLoadStr(reader, &str, &len))
+      return false;
+    if (flagMatch)
+      JSONLoadSetLabel(cursor, JSONLoadCursorNext(cursor), "", 0, str, 
+        len);
+  } else {
+    JSONType type = JSONTypeStr;
+    JSONPayload val;
+    if (!JSONLoadScalar(reader, c, &type, &val))
+      return false;
+    if (flagMatch)
+      JSONLoadSetTyped(cursor, JSONLoadCursorNext(cursor), type, val);
+  }
+  return true;
+}
+
+// Apply the steps from the 'iStep'-th one of the path 'that' to the 
+// subtrees of the node whose value starts with the char 'c', already 
+// consumed, from the reader 'reader', and load the selected nodes as 
+// the next children of the cursor 'cursor'. The subtrees are the 
+// properties of an object, the values of an array or the value of a 
+// string, number, boolean or null
+// Return true if it could parse, false else
+static bool JSONPathWalk(const JSONPath* const that, const long iStep, 
+  JSONLoadCursor* const cursor, JSONReader* const reader, char c) {
+  const JSONPathStep* step = that->_steps + iStep;
+  bool flagLast = (iStep + 1 == that->_nb);
+  // If it's an object, loop on its properties
+  if (c == '{') {
+    long iVal = 0;
+    while (true) {
+      if (!JSONGetNextChar(reader, &c))
+        return false;
+      if (c == '}')
+        return true;
+      // Read the key and keep it valid while reading the value
+      const char* key = NULL;
+      size_t lenKey = 0;
+      if (!JSONLoadStr(reader, &key, &lenKey))
+        return false;
+      JSONStrBuf bufferKey;
+      JSONStrBufInit(&bufferKey);
+      key = JSONLoadKeepStr(reader, &bufferKey, key, lenKey);
+      bool flagSelect = JSONPathSelect(step, iVal, key, lenKey);
+      bool ret = true;
+      // If the property is selected by the last step, load it
+      if (flagSelect && flagLast) {
+        ret = JSONLoadPropVal(cursor, reader, key, lenKey);
+      // Else, apply the next steps to its value if it's selected, or 
+      // skip it
+      } else if (!JSONGetNextChar(reader, &c) || c != ':' || 
+        !JSONGetNextChar(reader, &c)) {
+        ret = false;
+      } else if (flagSelect) {
+        ret = JSONPathWalk(that, iStep + 1, cursor, reader, c);
+      } else {
+        ret = JSONPathSkipVal(reader, c);
+      }
+      JSONStrBufFree(&bufferKey);
+      if (!ret)
+        return false;
+      ++iVal;
+    }
+  // Else, if it's an array, loop on its values
+  } else if (c == '[') {
+    if (!JSONGetNextChar(reader, &c))
+      return false;
+    // An empty array has one value without label, as in JSONLoadArr
+    if (c == ']') {
+      if (flagLast && JSONPathSelect(step, 0, NULL, 0))
+        JSONLoadSetLabel(cursor, JSONLoadCursorNext(cursor), "", 0, 
+          NULL, 0);
+      return true;
+    }
+    for (long iVal = 0; c != ']'; ++iVal) {
+      bool flagSelect = JSONPathSelect(step, iVal, NULL, 0);
+      bool ret = true;
+      // If it's a struct, load it if it's selected by the last step, 
+      // else apply the next steps to it if it's selected, else skip it
+      if (c == '{') {
+        if (flagSelect && flagLast) {
+          JSONNode* obj = JSONLoadCursorNext(cursor);
+          JSONLoadSetLabel(cursor, obj, "", 0, NULL, 0);
+          ret = JSONLoadStruct(obj, reader);
+        } else if (flagSelect) {
+          ret = JSONPathWalk(that, iStep + 1, cursor, reader, c);
+        } else {
+          ret = JSONPathSkipVal(reader, c);
+        }
+      // Else, it's a value without subtree, load it if it's selected by
+      // the last step
+      } else {
+        ret = JSONPathLoadLeaf(cursor, reader, c, flagSelect && flagLast);
+      }
+      if (!ret || !JSONGetNextChar(reader, &c))
+        return false;
+    }
+    return true;
+  // Else, it's a value, its only subtree has no subtree
+  } else if (c == '"' || JSONIsScalarStart(c)) {
+    return JSONPathLoadLeaf(cursor, reader, c, 
+      flagLast && JSONPathSelect(step, 0, NULL, 0));
+  // Else, it's not a valid file
+  } else {
+    JSONErr->_type = PBErrTypeInvalidData;
+    char ctx[2 * PBJSON_CONTEXTSIZE + 1];
+    JSONGetContext(reader, ctx);
+    sprintf(JSONErr->_msg, 
+      "JSONPathLoad: Expected a value, '{' or '[' but found '%c' "
+      "near ...%s...", c, ctx);
+    return false;
+  }
+}
+
+// Parse the JSON from the reader 'reader' and append to the node 
+// 'matches' a copy of each node selected by the compiled path 'that'
+// Return true if it could parse, false else
+static bool JSONPathLoadFromReader(const JSONPath* const that, 
+  JSONNode* const matches, JSONReader* const reader) {
+  // The streaming can't select positions relative to the end
+  for (long iStep = 0; iStep < that->_nb; ++iStep) {
+    const JSONPathStep* step = that->_steps + iStep;
+    if ((step->_type == JSONPathStepIndex && step->_start < 0) ||
+      (step->_type == JSONPathStepSlice && 
+      ((step->_flagStart && step->_start < 0) || 
+      (step->_flagEnd && step->_end < 0)))) {
+      JSONErr->_type = PBErrTypeInvalidArg;
+      sprintf(JSONErr->_msg, 
+        "JSONPathLoad: Positions relative to the end are not supported");
+      return false;
+    }
+  }
+  JSONLoadCursor cursor;
+  JSONLoadCursorInit(&cursor, matches, reader);
+  bool ret = true;
+  // If the path is the root, load the whole JSON
+  if (that->_nb == 0) {
+    ret = JSONLoadFromReader(JSONLoadCursorNext(&cursor), reader);
+  } else {
+    char c;
+    if (!JSONGetNextChar(reader, &c)) {
+      ret = false;
+    // If the file starts with a '{', apply the path to its properties
+    } else if (c == '{') {
+      ret = JSONPathWalk(that, 0, &cursor, reader, c);
+    // Else if the file starts with a '[', the root has one property 
+    // with an empty key whose values are the ones of the array, as in 
+    // JSONLoadFromReader
+    } else if (c == '[') {
+      if (!JSONPathSelect(that->_steps, 0, "", 0)) {
+        ret = JSONPathSkipVal(reader, c);
+      } else if (that->_nb == 1) {
+        ret = JSONLoadArr(&cursor, reader, "", 0);
+      } else {
+        ret = JSONPathWalk(that, 1, &cursor, reader, c);
+      }
+    } else {
+      JSONErr->_type = PBErrTypeInvalidData;
+      char ctx[2 * PBJSON_CONTEXTSIZE + 1];
+      JSONGetContext(reader, ctx);
+      sprintf(JSONErr->_msg, 
+        "JSONPathLoad: Expected '{' or '[' but found '%c' near ...%s...", 
+        c, ctx);
+      ret = false;
+    }
+  }
+  JSONLoadCursorEnd(&cursor);
+  return ret;
+}
+
+// Parse the JSON in the stream 'stream' and append to the node 
+// 'matches' a copy of each node selected by the compiled path 'that'
+// Return true if it could parse, false else
+bool JSONPathLoad(const JSONPath* const that, JSONNode* const matches, 
+  FILE* const stream) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (matches == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'matches' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (stream == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'stream' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  // Declare a reader on the stream
+  JSONReader reader;
+  JSONReaderInitStream(&reader, stream);
+  // Parse the JSON from the reader
+  bool ret = JSONPathLoadFromReader(that, matches, &reader);
+  // Give back the unconsumed bytes to the stream
+  JSONReaderRelease(&reader);
+  // Return the success code
+  return ret;
+}
+
+// Same as JSONPathLoad on the 'len' first bytes of the buffer 'buf'
+bool JSONPathLoadFromBuffer(const JSONPath* const that, 
+  JSONNode* const matches, const char* const buf, const size_t len) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (matches == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'matches' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (buf == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'buf' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  // Declare a reader directly on the buffer
+  JSONReader reader;
+  JSONReaderInitBuffer(&reader, buf, len);
+  // Parse the JSON from the reader
+  bool ret = JSONPathLoadFromReader(that, matches, &reader);
+  // Free the memory used by the reader
+  JSONReaderRelease(&reader);
+  // Return the success code
+  return ret;
+}
+
+// Append the LEB128 varint encoding of 'val' to the writer 'that'
+// Return false if there has been an I/O error
+static inline bool JSONWriterAppendVarint(JSONWriter* const that, 
+  uint64_t val) {
+  // Seven bits per byte, the high bit is set on all the bytes but the 
+  // last one
+  char bytes[10];
+  size_t len = 0;
+  do {
+    bytes[len] = (char)(val & 0x7f);
+    val >>= 7;
+    if (val != 0)
+      bytes[len] |= (char)0x80;
+    ++len;
+  } while (val != 0);
+  return JSONWriterAppend(that, bytes, len);
+}
+
+// Save recursively the node 'that' in the binary encoding into the 
+// writer 'writer'
+// Return true if it could save, false else
+static bool JSONSaveBinaryRec(const JSONNode* const that, 
+  JSONWriter* const writer) {
+  // Get the kind of the value of the node
+  JSONLbl* lbl = (JSONLbl*)GenTreeData(that);
+  JSONBinKind kind = JSONBinNone;
+  if (lbl == NULL)
+    kind = JSONBinNone;
+  else if (lbl->_str != NULL)
+    kind = JSONBinStr;
+  else if (lbl->_type == JSONTypeInt)
+    kind = JSONBinInt;
+  else if (lbl->_type == JSONTypeReal)
+    kind = JSONBinReal;
+  else if (lbl->_type == JSONTypeBool)
+    kind = (lbl->_val._bool ? JSONBinTrue : JSONBinFalse);
+  else if (lbl->_type == JSONTypeNull)
+    kind = JSONBinNull;
+  // Write the tag, the subtrees not loaded yet are loaded to know if 
+  // there are some
+  long nb = JSONGetNbValue(that);
+  char tag = (char)(kind | (nb > 0 ? JSONBinFlagChildren : 0));
+  if (!JSONWriterAppendChar(writer, tag))
+    return false;
+  // Write the payload
+  bool ret = true;
+  if (kind == JSONBinStr) {
+    size_t len = strlen(lbl->_str);
+    ret = JSONWriterAppendVarint(writer, len) && 
+      JSONWriterAppend(writer, lbl->_str, len);
+  } else if (kind == JSONBinInt) {
+    // Zigzag encoding, small negative numbers take few bytes too
+    uint64_t val = ((uint64_t)(lbl->_val._int) << 1) ^ 
+      (uint64_t)(lbl->_val._int >> 63);
+    ret = JSONWriterAppendVarint(writer, val);
+  } else if (kind == JSONBinReal) {
+    uint64_t bits = 0;
+    memcpy(&bits, &(lbl->_val._real), sizeof(bits));
+    char bytes[8];
+    for (int iByte = 0; iByte < 8; ++iByte)
+      bytes[iByte] = (char)((bits >> (8 * iByte)) & 0xff);
+    ret = JSONWriterAppend(writer, bytes, 8);
+  }
+  // Write the number of subtrees and the subtrees
+  if (ret && nb > 0) {
+    ret = JSONWriterAppendVarint(writer, (uint64_t)nb);
+    GSetIterForward iter = 
+      GSetIterForwardCreateStatic(JSONProperties(that));
+    do {
+      ret = ret && JSONSaveBinaryRec(GSetIterGet(&iter), writer);
+    } while (ret && GSetIterStep(&iter));
+  }
+  // Return the success code
+  return ret;
+}
+
+// Save the JSON 'that' in the binary encoding into the writer 'writer'
+// Return true if it could save, false else
+static bool JSONSaveBinaryToWriter(const JSONNode* const that, 
+  JSONWriter* const writer) {
+  // Write the header
+  char header[PBJSON_BINHEADERSIZE];
+  memcpy(header, PBJSON_BINMAGIC, PBJSON_BINHEADERSIZE - 1);
+  header[PBJSON_BINHEADERSIZE - 1] = (char)PBJSON_BINVERSION;
+  if (!JSONWriterAppend(writer, header, PBJSON_BINHEADERSIZE))
+    return false;
+  // Write the subtrees of the root, its label is not saved as in 
+  // JSONSave
+  long nb = JSONGetNbValue(that);
+  if (!JSONWriterAppendVarint(writer, (uint64_t)nb))
+    return false;
+  if (nb == 0)
+    return true;
+  bool ret = true;
+  GSetIterForward iter = GSetIterForwardCreateStatic(JSONProperties(that));
+  do {
+    ret = JSONSaveBinaryRec(GSetIterGet(&iter), writer);
+  } while (ret && GSetIterStep(&iter));
+  return ret;
+}
+
+// Save the JSON 'that' on the stream 'stream' in the binary encoding: 
+// the header PBJSON_BINMAGIC and PBJSON_BINVERSION, the number of 
+// subtrees of 'that' then each subtree in depth first order as a tag 
+// byte (cf JSONBinKind), its payload and its number of subtrees. 
+// Lengths and numbers of subtrees are LEB128 varints
+// Return true if it could save, false else
+bool JSONSaveBinary(const JSONNode* const that, FILE* const stream) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (stream == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'stream' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  double start = JSONStatsClock();
+  // Declare a writer on the stream, as in JSONSave
+  JSONWriter writer;
+  JSONWriterInit(&writer, stream, 
+    PBErrMalloc(JSONErr, PBJSON_WRITEBLOCKSIZE), PBJSON_WRITEBLOCKSIZE,
+    false);
+  // Save the JSON
+  bool ret = JSONSaveBinaryToWriter(that, &writer);
+  // Write the remaining bytes
+  if (!JSONWriterFlush(&writer, 0))
+    ret = false;
+  free(writer._buf);
+  JSONStatsEndSave(JSONWriterGetNb(&writer), start);
+  // Return the success code
+  return ret;
+}
+
+// Save the JSON 'that' in the binary encoding in a buffer sized 
+// exactly to the output and return it
+// If 'arena' is not null the buffer is allocated in it, else it is 
+// allocated on the heap and must be freed by the user
+// If 'len' is not null it's set to the length of the output
+char* JSONSaveBinaryToBuffer(const JSONNode* const that, 
+  JSONArena* const arena, size_t* const len) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  double start = JSONStatsClock();
+  // Declare a writer in memory
+  JSONWriter writer;
+  // If the buffer is allocated in the arena, count the bytes first as 
+  // in JSONSaveToBuffer
+  if (arena != NULL) {
+    char block[PBJSON_BLOCKSIZE];
+    JSONWriterInit(&writer, NULL, block, PBJSON_BLOCKSIZE, false);
+    (void)JSONSaveBinaryToWriter(that, &writer);
+    size_t size = JSONWriterGetNb(&writer);
+    JSONWriterInit(&writer, NULL, JSONArenaAlloc(arena, size), size, 
+      false);
+  // Else, save in a buffer growing as needed
+  } else {
+    JSONWriterInit(&writer, NULL, PBErrMalloc(JSONErr, PBJSON_BLOCKSIZE),
+      PBJSON_BLOCKSIZE, true);
+  }
+  // Save the JSON, writing in memory can't fail
+  (void)JSONSaveBinaryToWriter(that, &writer);
+  // Give back the bytes unused by the buffer on the heap
+  if (arena == NULL)
+    JSONWriterShrink(&writer);
+  // Set the length of the output
+  if (len != NULL)
+    *len = writer._len;
+  JSONStatsEndSave(writer._len, start);
+  // Return the buffer
+  return writer._buf;
+}
+
+// Get the 'len' next bytes from the reader 'reader', '*bytes' points 
+// to them on success and stays valid until the next read on the reader
+// Return false if there are not enough bytes available
+static bool JSONReaderGetBytes(JSONReader* const reader, 
+  const size_t len, const char** const bytes) {
+  // If the bytes are all available, point directly to them
+  if (reader->_len - reader->_pos >= len) {
+    *bytes = reader->_buf + reader->_pos;
+    reader->_pos += len;
+    return true;
+  }
+  // Else, accumulate them across the blocks in the scratch buffer
+  reader->_scratch._len = 0;
+  size_t nb = 0;
+  while (nb < len) {
+    if (reader->_pos >= reader->_len && !JSONReaderFill(reader)) {
+      JSONErr->_type = PBErrTypeInvalidData;
+      sprintf(JSONErr->_msg, "JSONLoadBinary: Unexpected end of data");
+      return false;
+    }
+    size_t nbAvail = reader->_len - reader->_pos;
+    if (nbAvail > len - nb)
+      nbAvail = len - nb;
+    JSONStrBufAppend(&(reader->_scratch), reader->_buf + reader->_pos, 
+      nbAvail);
+    reader->_pos += nbAvail;
+    nb += nbAvail;
+  }
+  *bytes = reader->_scratch._str;
+  return true;
+}
+
+// Get the LEB128 varint from the reader 'reader' into '*val'
+// Return false if there is no valid varint
+static bool JSONReaderGetVarint(JSONReader* const reader, 
+  uint64_t* const val) {
+  *val = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    char c;
+    if (!JSONReaderGetChar(reader, &c)) {
+      JSONErr->_type = PBErrTypeInvalidData;
+      sprintf(JSONErr->_msg, "JSONLoadBinary: Unexpected end of data");
+      return false;
+    }
+    *val |= (uint64_t)(c & 0x7f) << shift;
+    if ((c & 0x80) == 0)
+      return true;
+  }
+  JSONErr->_type = PBErrTypeInvalidData;
+  sprintf(JSONErr->_msg, "JSONLoadBinary: Invalid varint");
+  return false;
+}
+
+// Load 'nb' nodes in the binary encoding from the reader 'reader' as 
+// the next children of the cursor 'cursor', with their subtrees
+// Return true if it could load, false else
+static bool JSONLoadBinaryRec(JSONLoadCursor* const cursor, 
+  JSONReader* const reader, const uint64_t nb) {
+  for (uint64_t iNode = 0; iNode < nb; ++iNode) {
+    // Read the tag
+    char tag;
+    if (!JSONReaderGetChar(reader, &tag)) {
+      JSONErr->_type = PBErrTypeInvalidData;
+      sprintf(JSONErr->_msg, "JSONLoadBinary: Unexpected end of data");
+      return false;
+    }
+    JSONNode* node = JSONLoadCursorNext(cursor);
+    JSONPayload val;
+    val._int = 0;
+    uint64_t bits = 0;
+    const char* bytes = NULL;
+    // Set the value of the node from its payload, no delimiter to scan
+    switch (tag & ~JSONBinFlagChildren) {
+      case JSONBinNone:
+        JSONLoadSetLabel(cursor, node, "", 0, NULL, 0);
+        break;
+      case JSONBinStr:
+        if (!JSONReaderGetVarint(reader, &bits) || 
+          !JSONReaderGetBytes(reader, bits, &bytes))
+          return false;
+        JSONLoadSetLabel(cursor, node, "", 0, bytes, bits);
+        break;
+      case JSONBinInt:
+        if (!JSONReaderGetVarint(reader, &bits))
+          return false;
+        val._int = (int64_t)((bits >> 1) ^ (~(bits & 1) + 1));
+        JSONLoadSetTyped(cursor, node, JSONTypeInt, val);
+        break;
+      case JSONBinReal:
+        if (!JSONReaderGetBytes(reader, 8, &bytes))
+          return false;
+        for (int iByte = 0; iByte < 8; ++iByte)
+          bits |= (uint64_t)(unsigned char)bytes[iByte] << (8 * iByte);
+        memcpy(&(val._real), &bits, sizeof(bits));
+        JSONLoadSetTyped(cursor, node, JSONTypeReal, val);
+        break;
+      case JSONBinFalse:
+      case JSONBinTrue:
+        val._bool = ((tag & ~JSONBinFlagChildren) == JSONBinTrue);
+        JSONLoadSetTyped(cursor, node, JSONTypeBool, val);
+        break;
+      case JSONBinNull:
+        JSONLoadSetTyped(cursor, node, JSONTypeNull, val);
+        break;
+      default:
+        JSONErr->_type = PBErrTypeInvalidData;
+        sprintf(JSONErr->_msg, "JSONLoadBinary: Invalid tag 0x%02x", 
+          (unsigned char)tag);
+        return false;
+    }
+    // Load the subtrees
+    if (tag & JSONBinFlagChildren) {
+      uint64_t nbChild = 0;
+      if (!JSONReaderGetVarint(reader, &nbChild))
+        return false;
+      JSONLoadCursor cursorChild;
+      JSONLoadCursorInit(&cursorChild, node, reader);
+      ++(reader->_depth);
+      if (reader->_depth > reader->_depthMax)
+        reader->_depthMax = reader->_depth;
+      if (!JSONLoadBinaryRec(&cursorChild, reader, nbChild))
+        return false;
+      --(reader->_depth);
+      JSONLoadCursorEnd(&cursorChild);
+    }
+  }
+  return true;
+}
+
+// Load the JSON 'that' from the binary encoding in the reader 'reader'
+// Return true if it could load, false else
+static bool JSONLoadBinaryFromReader(JSONNode* const that, 
+  JSONReader* const reader) {
+  // Check the header
+  const char* header = NULL;
+  if (!JSONReaderGetBytes(reader, PBJSON_BINHEADERSIZE, &header))
+    return false;
+  if (memcmp(header, PBJSON_BINMAGIC, PBJSON_BINHEADERSIZE - 1) != 0 ||
+    header[PBJSON_BINHEADERSIZE - 1] != (char)PBJSON_BINVERSION) {
+    JSONErr->_type = PBErrTypeInvalidData;
+    sprintf(JSONErr->_msg, "JSONLoadBinary: Invalid header");
+    return false;
+  }
+  // Load the subtrees of the root
+  uint64_t nb = 0;
+  if (!JSONReaderGetVarint(reader, &nb))
+    return false;
+  JSONLoadCursor cursor;
+  JSONLoadCursorInit(&cursor, that, reader);
+  if (!JSONLoadBinaryRec(&cursor, reader, nb))
+    return false;
+  JSONLoadCursorEnd(&cursor);
+  return true;
+}
+
+// Load the JSON 'that' from the binary encoding in the stream 'stream'
+// Return true if it could load, false else
+bool JSONLoadBinary(JSONNode* const that, FILE* const stream) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (stream == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'stream' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  double start = JSONStatsClock();
+  // Declare a reader on the stream
+  JSONReader reader;
+  JSONReaderInitStream(&reader, stream);
+  // Load the JSON from the reader
+  bool ret = JSONLoadBinaryFromReader(that, &reader);
+  // Give back the unconsumed bytes to the stream
+  JSONReaderRelease(&reader);
+  ++(JSONStatsCur._nbLoad);
+  JSONStatsAddTime(&(JSONStatsCur._timeLoad), start);
+  // Return the success code
+  return ret;
+}
+
+// Load the JSON 'that' from the binary encoding in the 'len' first 
+// bytes of the buffer 'buf'
+// Return true if it could load, false else
+bool JSONLoadBinaryFromBuffer(JSONNode* const that, 
+  const char* const buf, const size_t len) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (buf == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'buf' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  double start = JSONStatsClock();
+  // Declare a reader directly on the buffer
+  JSONReader reader;
+  JSONReaderInitBuffer(&reader, buf, len);
+  // Load the JSON from the reader
+  bool ret = JSONLoadBinaryFromReader(that, &reader);
+  // Free the memory used by the reader
+  JSONReaderRelease(&reader);
+  ++(JSONStatsCur._nbLoad);
+  JSONStatsAddTime(&(JSONStatsCur._timeLoad), start);
+  // Return the success code
+  return ret;
+}
+
+// Return the size in bytes of one element of the field 'field'
+static inline size_t JSONStructFieldElemSize(
+  const JSONStructField* const field) {
+  return (field->_nb > 0 ? field->_size / field->_nb : field->_size);
+}
+
+// Save the element at 'ptr' of the field 'field' into the writer 
+// 'writer', the field being at depth 'depth'
+// Return true if it could save, false else
+static bool JSONStructSaveElem(const char* const ptr, 
+  const JSONStructField* const field, JSONWriter* const writer, 
+  const bool compact, const int depth) {
+  char num[PBJSON_SCALARSIZE];
+  switch (field->_type) {
+    case JSONFieldInt:
+      return JSONWriterAppend(writer, num, 
+        JSONFormatInt(*(const int*)ptr, num));
+    case JSONFieldInt64:
+      return JSONWriterAppend(writer, num, 
+        JSONFormatInt(*(const int64_t*)ptr, num));
+    case JSONFieldFloat:
+      return JSONWriterAppend(writer, num, 
+        JSONFormatReal(*(const float*)ptr, num));
+    case JSONFieldDouble:
+      return JSONWriterAppend(writer, num, 
+        JSONFormatReal(*(const double*)ptr, num));
+    case JSONFieldBool:
+      if (*(const bool*)ptr)
+        return JSONWriterAppend(writer, "true", 4);
+      return JSONWriterAppend(writer, "false", 5);
+    case JSONFieldStr:
+      return JSONWriterAppendChar(writer, '"') &&
+        JSONWriterAppendEscaped(writer, ptr, 
+          strnlen(ptr, JSONStructFieldElemSize(field))) &&
+        JSONWriterAppendChar(writer, '"');
+    case JSONFieldStruct:
+      return JSONStructSaveRec(ptr, field->_desc, writer, compact, depth);
+    default:
+      return false;
+  }
+}
+
+// Save the struct 'data' described by 'desc' into the writer 'writer',
+// as an object at depth 'depth'
+// Return true if it could save, false else
+static bool JSONStructSaveRec(const char* const data, 
+  const JSONStructDesc* const desc, JSONWriter* const writer, 
+  const bool compact, const int depth) {
+  if (!JSONWriterAppendChar(writer, '{') || 
+    (!compact && !JSONWriterAppendChar(writer, '\n')))
+    return false;
+  // Loop on the fields
+  for (long iField = 0; iField < desc->_nb; ++iField) {
+    const JSONStructField* field = desc->_fields + iField;
+    const char* ptr = data + field->_offset;
+    // Write the key
+    if ((!compact && !JSONIndent(writer, depth + 1)) ||
+      !JSONWriterAppendChar(writer, '"') ||
+      !JSONWriterAppendEscaped(writer, field->_name, 
+        strlen(field->_name)) ||
+      !JSONWriterAppend(writer, "\":", 2))
+      return false;
+    // If it's an array of structs, each struct is on its own lines in
+    // readable form, as in JSONSaveRecNode
+    if (field->_nb > 0 && field->_type == JSONFieldStruct) {
+      if (!JSONWriterAppendChar(writer, '[') || 
+        (!compact && !JSONWriterAppendChar(writer, '\n')))
+        return false;
+      for (long iElem = 0; iElem < field->_nb; ++iElem) {
+        if ((!compact && !JSONIndent(writer, depth + 2)) ||
+          !JSONStructSaveRec(ptr + iElem * JSONStructFieldElemSize(field), 
+          field->_desc, writer, compact, depth + 2) ||
+          (iElem + 1 < field->_nb && !JSONWriterAppendChar(writer, ',')) ||
+          (!compact && !JSONWriterAppendChar(writer, '\n')))
+          return false;
+      }
+      if ((!compact && !JSONIndent(writer, depth + 1)) ||
+        !JSONWriterAppendChar(writer, ']'))
+        return false;
+    // Else, if it's an array of values, they are on one line
+    } else if (field->_nb > 0) {
+      if (!JSONWriterAppendChar(writer, '['))
+        return false;
+      for (long iElem = 0; iElem < field->_nb; ++iElem) {
+        if ((iElem > 0 && !JSONWriterAppendChar(writer, ',')) ||
+          !JSONStructSaveElem(ptr + iElem * JSONStructFieldElemSize(field),
+          field, writer, compact, depth + 1))
+          return false;
+      }
+      if (!JSONWriterAppendChar(writer, ']'))
+        return false;
+    // Else, it's a single value or struct
+    } else if (!JSONStructSaveElem(ptr, field, writer, compact, 
+      depth + 1)) {
+      return false;
+    }
+    if ((iField + 1 < desc->_nb && !JSONWriterAppendChar(writer, ',')) ||
+      (!compact && !JSONWriterAppendChar(writer, '\n')))
+      return false;
+  }
+  if (!compact && !JSONIndent(writer, depth))
+    return false;
+  return JSONWriterAppendChar(writer, '}');
+}
+
+// Save the C struct 'data' described by 'desc' on the stream 'stream'
+// directly from its fields, without building a JSON tree. The output 
+// is the same as JSONSave of the equivalent JSON with typed values
+// If 'compact' equals true save in compact form, else save in easily 
+// readable form
+// Return true if it could save, false else
+bool JSONStructSave(const void* const data, 
+  const JSONStructDesc* const desc, FILE* const stream, 
+  const bool compact) {
+#if BUILDMODE == 0
+  if (data == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'data' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (desc == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'desc' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (stream == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'stream' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  // Declare a writer on the stream, as in JSONSave
+  JSONWriter writer;
+  JSONWriterInit(&writer, stream, 
+    PBErrMalloc(JSONErr, PBJSON_WRITEBLOCKSIZE), PBJSON_WRITEBLOCKSIZE,
+    false);
+  // Save the struct followed by a new line, as JSONSave
+  bool ret = JSONStructSaveRec(data, desc, &writer, compact, 0) &&
+    JSONWriterAppendChar(&writer, '\n');
+  // Write the remaining bytes
+  if (!JSONWriterFlush(&writer, 0))
+    ret = false;
+  free(writer._buf);
+  // Return the success code
+  return ret;
+}
+
+// Save the C struct 'data' described by 'desc' in a null terminated 
+// buffer allocated on the heap and return it, cf JSONStructSave
+// If 'len' is not null it's set to the length of the output (without 
+// the terminating '\0')
+char* JSONStructSaveToBuffer(const void* const data, 
+  const JSONStructDesc* const desc, size_t* const len, 
+  const bool compact) {
+#if BUILDMODE == 0
+  if (data == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'data' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (desc == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'desc' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  // Declare a writer in memory growing as needed
+  JSONWriter writer;
+  JSONWriterInit(&writer, NULL, PBErrMalloc(JSONErr, PBJSON_BLOCKSIZE),
+    PBJSON_BLOCKSIZE, true);
+  // Save the struct, writing in memory can't fail
+  (void)JSONStructSaveRec(data, desc, &writer, compact, 0);
+  (void)JSONWriterAppend(&writer, "\n", 2);
+  // Give back the unused bytes
+  JSONWriterShrink(&writer);
+  // Set the length of the output
+  if (len != NULL)
+    *len = writer._len - 1;
+  // Return the buffer
+  return writer._buf;
+}
+
+// Set the error for the invalid value of the field 'field' read from 
+// the reader 'reader'
+static void JSONStructSetErrVal(const JSONReader* const reader, 
+  const JSONStructField* const field) {
+  JSONErr->_type = PBErrTypeInvalidData;
+  char ctx[2 * PBJSON_CONTEXTSIZE + 1];
+  JSONGetContext(reader, ctx);
+  sprintf(JSONErr->_msg, 
+    "JSONStructLoad: Invalid value for '%.64s' near ...%s...", 
+    field->_name, ctx);
+}
+
+// Load the element at 'ptr' of the field 'field' from the value 
+// starting with the char 'c', already consumed, from the reader 
+// 'reader'. If 'flagEmpty' is true an empty string is accepted and 
+// leaves the element unchanged
+// Return true if it could load, false else
+static bool JSONStructLoadElem(char* const ptr, 
+  const JSONStructField* const field, JSONReader* const reader, 
+  const char c, const bool flagEmpty) {
+  // If it's a nested struct
+  if (field->_type == JSONFieldStruct) {
+    if (c != '{') {
+      JSONStructSetErrVal(reader, field);
+      return false;
+    }
+    return JSONStructLoadRec(ptr, field->_desc, reader);
+  }
+  // Get the value and its type, numbers and booleans can be quoted
+  JSONType type = JSONTypeStr;
+  JSONPayload val;
+  const char* str = NULL;
+  size_t len = 0;
+  if (c == '"') {
+    if (!JSONLoadStr(reader, &str, &len))
+      return false;
+    if (len == 0 && flagEmpty)
+      return true;
+    if (field->_type != JSONFieldStr) {
+      if (len == 4 && memcmp(str, "true", 4) == 0) {
+        type = JSONTypeBool;
+        val._bool = true;
+      } else if (len == 5 && memcmp(str, "false", 5) == 0) {
+        type = JSONTypeBool;
+        val._bool = false;
+      } else if (!JSONScanNumber(str, len, &type, &val)) {
+        JSONStructSetErrVal(reader, field);
+        return false;
+      }
+    }
+  } else if (!JSONLoadScalar(reader, c, &type, &val)) {
+    return false;
+  }
+  // Null leaves the element unchanged
+  if (type == JSONTypeNull)
+    return true;
+  // Convert the value to the type of the field
+  bool ret = true;
+  switch (field->_type) {
+    case JSONFieldInt:
+      ret = (type == JSONTypeInt && val._int >= INT32_MIN && 
+        val._int <= INT32_MAX);
+      if (ret)
+        *(int*)ptr = (int)(val._int);
+      break;
+    case JSONFieldInt64:
+      ret = (type == JSONTypeInt);
+      if (ret)
+        *(int64_t*)ptr = val._int;
+      break;
+    case JSONFieldFloat:
+    case JSONFieldDouble:
+      ret = (type == JSONTypeInt || type == JSONTypeReal);
+      if (ret) {
+        double real = 
+          (type == JSONTypeInt ? (double)(val._int) : val._real);
+        if (field->_type == JSONFieldFloat)
+          *(float*)ptr = (float)real;
+        else
+          *(double*)ptr = real;
+      }
+      break;
+    case JSONFieldBool:
+      ret = (type == JSONTypeBool);
+      if (ret)
+        *(bool*)ptr = val._bool;
+      break;
+    case JSONFieldStr:
+      // The string and its '\0' must fit in the array of char
+      ret = (type == JSONTypeStr && len < JSONStructFieldElemSize(field));
+      if (ret) {
+        memcpy(ptr, str, len);
+        ptr[len] = '\0';
+      }
+      break;
+    default:
+      ret = false;
+  }
+  if (!ret)
+    JSONStructSetErrVal(reader, field);
+  return ret;
+}
+
+// Load the field 'field' of the struct 'data' from the value starting 
+// with the char 'c', already consumed, from the reader 'reader'
+// Return true if it could load, false else
+static bool JSONStructLoadField(char* const data, 
+  const JSONStructField* const field, JSONReader* const reader, char c) {
+  char* ptr = data + field->_offset;
+  // If it's a single value or struct
+  if (field->_nb == 0)
+    return JSONStructLoadElem(ptr, field, reader, c, false);
+  // Else, if it's an array saved as a single value, or an empty string
+  // for an empty array, as JSONSave does
+  if (c != '[')
+    return JSONStructLoadElem(ptr, field, reader, c, true);
+  // Else, loop on the values of the array
+  size_t size = JSONStructFieldElemSize(field);
+  for (long iElem = 0; ; ++iElem) {
+    if (!JSONGetNextChar(reader, &c))
+      return false;
+    if (c == ']')
+      return true;
+    if (iElem >= field->_nb) {
+      JSONStructSetErrVal(reader, field);
+      return false;
+    }
+    if (!JSONStructLoadElem(ptr + iElem * size, field, reader, c, false))
+      return false;
+  }
+}
+
+// Load the struct 'data' described by 'desc' from the object whose 
+// opening char has been consumed from the reader 'reader'
+// Return true if it could load, false else
+static bool JSONStructLoadRec(char* const data, 
+  const JSONStructDesc* const desc, JSONReader* const reader) {
+  // Index of the field expected next, the keys usually come in the 
+  // order of the description
+  long iNext = 0;
+  while (true) {
+    // Read the key, or the end of the object
+    char c;
+    if (!JSONGetNextChar(reader, &c))
+      return false;
+    if (c == '}')
+      return true;
+    const char* key = NULL;
+    size_t lenKey = 0;
+    if (c != '"') {
+      JSONErr->_type = PBErrTypeInvalidData;
+      char ctx[2 * PBJSON_CONTEXTSIZE + 1];
+      JSONGetContext(reader, ctx);
+      sprintf(JSONErr->_msg, 
+        "JSONStructLoad: Expected '\"' but found '%c' near ...%s...", 
+        c, ctx);
+      return false;
+    }
+    if (!JSONLoadStr(reader, &key, &lenKey))
+      return false;
+    // Get the field of the key, first the expected one, else search it
+    // among all the fields
+    const JSONStructField* field = NULL;
+    for (long iTry = 0; iTry < desc->_nb && field == NULL; ++iTry) {
+      const JSONStructField* f = 
+        desc->_fields + (iNext + iTry) % desc->_nb;
+      if (strncmp(f->_name, key, lenKey) == 0 && 
+        f->_name[lenKey] == '\0') {
+        field = f;
+        iNext = (iNext + iTry + 1) % desc->_nb;
+      }
+    }
+    // Read the ':' and the first char of the value
+    if (!JSONGetNextChar(reader, &c))
+      return false;
+    if (c != ':') {
+      JSONErr->_type = PBErrTypeInvalidData;
+      char ctx[2 * PBJSON_CONTEXTSIZE + 1];
+      JSONGetContext(reader, ctx);
+      sprintf(JSONErr->_msg, 
+        "JSONStructLoad: Expected ':' but found '%c' near ...%s...", 
+        c, ctx);
+      return false;
+    }
+    if (!JSONGetNextChar(reader, &c))
+      return false;
+    // Load the value into the field, or skip it if the key is unknown
+    if (field != NULL) {
+      if (!JSONStructLoadField(data, field, reader, c))
+        return false;
+    } else if (!JSONPathSkipVal(reader, c)) {
+      return false;
+    }
+  }
+}
+
+// Load the C struct 'data' described by 'desc' from the reader 'reader'
+// Return true if it could load, false else
+static bool JSONStructLoadFromReader(void* const data, 
+  const JSONStructDesc* const desc, JSONReader* const reader) {
+  char c;
+  if (!JSONGetNextChar(reader, &c))
+    return false;
+  if (c != '{') {
+    JSONErr->_type = PBErrTypeInvalidData;
+    char ctx[2 * PBJSON_CONTEXTSIZE + 1];
+    JSONGetContext(reader, ctx);
+    sprintf(JSONErr->_msg, 
+      "JSONStructLoad: Expected '{' but found '%c' near ...%s...", 
+      c, ctx);
+    return false;
+  }
+  return JSONStructLoadRec(data, desc, reader);
+}
+
+// Load the C struct 'data' described by 'desc' from the stream 
+// 'stream' directly into its fields, without building a JSON tree
+// The keys are expected in the order of the description, others are 
+// found by a linear search. Unknown keys and null values are skipped, 
+// missing fields are left unchanged. Numbers can be quoted, and an 
+// array can be a single value or an empty string, as saved by JSONSave
+// Return true if it could load, false else
+bool JSONStructLoad(void* const data, const JSONStructDesc* const desc, 
+  FILE* const stream) {
+#if BUILDMODE == 0
+  if (data == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'data' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (desc == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'desc' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (stream == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'stream' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  // Declare a reader on the stream
+  JSONReader reader;
+  JSONReaderInitStream(&reader, stream);
+  // Load the struct from the reader
+  bool ret = JSONStructLoadFromReader(data, desc, &reader);
+  // Give back the unconsumed bytes to the stream
+  JSONReaderRelease(&reader);
+  // Return the success code
+  return ret;
+}
+
+// Load the C struct 'data' described by 'desc' from the 'len' first 
+// bytes of the buffer 'buf', cf JSONStructLoad
+// Return true if it could load, false else
+bool JSONStructLoadFromBuffer(void* const data, 
+  const JSONStructDesc* const desc, const char* const buf, 
+  const size_t len) {
+#if BUILDMODE == 0
+  if (data == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'data' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (desc == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'desc' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (buf == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'buf' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  // Declare a reader directly on the buffer
+  JSONReader reader;
+  JSONReaderInitBuffer(&reader, buf, len);
+  // Load the struct from the reader
+  bool ret = JSONStructLoadFromReader(data, desc, &reader);
+  // Free the memory used by the reader
+  JSONReaderRelease(&reader);
+  // Return the success code
+  return ret;
+}
+
+// Return a streaming writer saving a JSON, one object, array, key or 
+// value at a time, without building a JSON tree. The output is the 
+// same as JSONSave of the equivalent JSON in compact form if 'compact'
+// equals true, else in readable form, except that arrays with one or 
+// no value keep their brackets
+// If 'stream' is not null the output is written on it by blocks of 
+// 'size' bytes stored in 'buf', else it's written in 'buf' which must 
+// be large enough for the whole output and its terminating '\0'
+// The writer doesn't allocate memory
+JSONWriter JSONWriterCreateStatic(FILE* const stream, char* const buf, 
+  const size_t size, const bool compact) {
+#if BUILDMODE == 0
+  if (buf == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'buf' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (size == 0) {
+    JSONErr->_type = PBErrTypeInvalidArg;
+    sprintf(JSONErr->_msg, "'size' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  JSONWriter that;
+  JSONWriterInit(&that, stream, buf, size, false);
+  that._flagFixed = (stream == NULL);
+  that._compact = compact;
+  return that;
+}
+
+// Set the error for the call of the streaming writer function 'fun' 
+// while the writer is in a state where it's not allowed
+static void JSONWriterSetErrState(const char* const fun) {
+  JSONErr->_type = PBErrTypeInvalidArg;
+  sprintf(JSONErr->_msg, "%s: invalid call in the current state", fun);
+}
+
+// Write the separator before the next value of the writer 'that', 
+// 'flagNested' is true if it's an object or an array. 'fun' is the 
+// name of the calling function for the error message
+// Return false if a value can't be written there or there has been an
+// error
+static bool JSONWriterBeginVal(JSONWriter* const that, 
+  const bool flagNested, const char* const fun) {
+  JSONWriterLevel* level = that->_levels + that->_depth;
+  // At the root there is only one object or array
+  if (that->_depth == 0) {
+    if (!flagNested || level->_flagItem) {
+      JSONWriterSetErrState(fun);
+      return false;
+    }
+    level->_flagItem = true;
+    return true;
+  }
+  // In an object the value follows its key
+  if (level->_open == '{') {
+    if (!(that->_flagKey)) {
+      JSONWriterSetErrState(fun);
+      return false;
+    }
+    that->_flagKey = false;
+    return true;
+  }
+  // In an array the values are separated by a comma, and in readable 
+  // form the objects and arrays start on a new line as in 
+  // JSONSaveRecNode
+  if (level->_flagItem && !JSONWriterAppendChar(that, ','))
+    return false;
+  if (flagNested && !(that->_compact) && 
+    (!JSONWriterAppendChar(that, '\n') || 
+    !JSONIndent(that, that->_depth)))
+    return false;
+  level->_flagItem = true;
+  if (flagNested)
+    level->_flagNested = true;
+  return true;
+}
+
+// Open an object or an array, according to 'open', with the writer 
+// 'that'. 'fun' is the name of the calling function for the error 
+// message
+// Return true if it could write, false else
+static bool JSONWriterBegin(JSONWriter* const that, const char open, 
+  const char* const fun) {
+  if (that->_depth >= PBJSON_WRITERDEPTHMAX) {
+    JSONWriterSetErrState(fun);
+    return false;
+  }
+  if (!JSONWriterBeginVal(that, true, fun))
+    return false;
+  ++(that->_depth);
+  JSONWriterLevel* level = that->_levels + that->_depth;
+  level->_open = open;
+  level->_flagItem = false;
+  level->_flagNested = false;
+  return JSONWriterAppendChar(that, open);
+}
+
+// Close the current object or array, according to 'open', of the 
+// writer 'that'. 'fun' is the name of the calling function for the 
+// error message
+// Return true if it could write, false else
+static bool JSONWriterClose(JSONWriter* const that, const char open, 
+  const char* const fun) {
+  JSONWriterLevel* level = that->_levels + that->_depth;
+  if (that->_depth == 0 || level->_open != open || that->_flagKey) {
+    JSONWriterSetErrState(fun);
+    return false;
+  }
+  // In readable form the properties of an object and the objects and 
+  // arrays of an array are followed by a new line, and the closing 
+  // char is indented
+  bool flagNewLine = (open == '{' ? level->_flagItem : level->_flagNested);
+  --(that->_depth);
+  if (flagNewLine && !(that->_compact) && 
+    (!JSONWriterAppendChar(that, '\n') || 
+    !JSONIndent(that, that->_depth)))
+    return false;
+  if (!JSONWriterAppendChar(that, (open == '{' ? '}' : ']')))
+    return false;
+  // The root is followed by a new line. JSONSaveRecNode adds another 
+  // one in readable form for an array of values
+  if (that->_depth == 0) {
+    if (!JSONWriterAppendChar(that, '\n'))
+      return false;
+    if (open == '[' && !(level->_flagNested) && !(that->_compact) &&
+      !JSONWriterAppendChar(that, '\n'))
+      return false;
+  }
+  return true;
+}
+
+// Open an object with the writer 'that', at the root, as the value of 
+// the last key or as the next value of the current array
+// Return true if it could write, false else
+bool JSONWriterBeginObject(JSONWriter* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  return JSONWriterBegin(that, '{', "JSONWriterBeginObject");
+}
+
+// Close the current object of the writer 'that'
+// Return true if it could write, false else
+bool JSONWriterEndObject(JSONWriter* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  return JSONWriterClose(that, '{', "JSONWriterEndObject");
+}
+
+// Open an array with the writer 'that', at the root, as the value of 
+// the last key or as the next value of the current array
+// Return true if it could write, false else
+bool JSONWriterBeginArray(JSONWriter* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  return JSONWriterBegin(that, '[', "JSONWriterBeginArray");
+}
+
+// Close the current array of the writer 'that'
+// Return true if it could write, false else
+bool JSONWriterEndArray(JSONWriter* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  return JSONWriterClose(that, '[', "JSONWriterEndArray");
+}
+
+// Write the key 'key' of the next property of the current object of 
+// the writer 'that'
+// Return true if it could write, false else
+bool JSONWriterKey(JSONWriter* const that, const char* const key) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (key == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'key' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  JSONWriterLevel* level = that->_levels + that->_depth;
+  if (that->_depth == 0 || level->_open != '{' || that->_flagKey) {
+    JSONWriterSetErrState("JSONWriterKey");
+    return false;
+  }
+  // The properties are separated by a comma, and each one is on its 
+  // own indented line in readable form
+  if ((level->_flagItem && !JSONWriterAppendChar(that, ',')) ||
+    (!(that->_compact) && (!JSONWriterAppendChar(that, '\n') || 
+    !JSONIndent(that, that->_depth))) ||
+    !JSONWriterAppendChar(that, '"') ||
+    !JSONWriterAppendEscaped(that, key, strlen(key)) ||
+    !JSONWriterAppend(that, "\":", 2))
+    return false;
+  level->_flagItem = true;
+  that->_flagKey = true;
+  return true;
+}
+
+// Write the string 'val' with the writer 'that', as the value of the 
+// last key or as the next value of the current array
+// Return true if it could write, false else
+bool _JSONWriterValueStr(JSONWriter* const that, const char* const val) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+  if (val == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'val' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  if (!JSONWriterBeginVal(that, false, "JSONWriterValue"))
+    return false;
+  return JSONWriterAppendChar(that, '"') &&
+    JSONWriterAppendEscaped(that, val, strlen(val)) &&
+    JSONWriterAppendChar(that, '"');
+}
+
+// Same as _JSONWriterValueStr for an integer
+bool _JSONWriterValueInt(JSONWriter* const that, const int64_t val) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  if (!JSONWriterBeginVal(that, false, "JSONWriterValue"))
+    return false;
+  char num[PBJSON_SCALARSIZE];
+  return JSONWriterAppend(that, num, JSONFormatInt(val, num));
+}
+
+// Same as _JSONWriterValueStr for an unsigned integer, written exactly 
+// even above INT64_MAX
+bool _JSONWriterValueUInt(JSONWriter* const that, const uint64_t val) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  if (val <= (uint64_t)INT64_MAX)
+    return _JSONWriterValueInt(that, (int64_t)val);
+  if (!JSONWriterBeginVal(that, false, "JSONWriterValue"))
+    return false;
+  char num[PBJSON_SCALARSIZE];
+  int len = snprintf(num, PBJSON_SCALARSIZE, "%llu", 
+    (unsigned long long)val);
+  return JSONWriterAppend(that, num, (size_t)len);
+}
+
+// Same as _JSONWriterValueStr for a floating point number
+bool _JSONWriterValueReal(JSONWriter* const that, const double val) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  if (!JSONWriterBeginVal(that, false, "JSONWriterValue"))
+    return false;
+  char num[PBJSON_SCALARSIZE];
+  return JSONWriterAppend(that, num, JSONFormatReal(val, num));
+}
+
+// Same as _JSONWriterValueStr for a boolean
+bool _JSONWriterValueBool(JSONWriter* const that, const bool val) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  if (!JSONWriterBeginVal(that, false, "JSONWriterValue"))
+    return false;
+  if (val)
+    return JSONWriterAppend(that, "true", 4);
+  return JSONWriterAppend(that, "false", 5);
+}
+
+// Same as _JSONWriterValueStr for null
+bool JSONWriterValueNull(JSONWriter* const that) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  if (!JSONWriterBeginVal(that, false, "JSONWriterValue"))
+    return false;
+  return JSONWriterAppend(that, "null", 4);
+}
+
+// End the output of the writer 'that': flush the remaining bytes on 
+// its stream, or terminate its buffer with '\0'. If 'len' is not null
+// it's set to the number of bytes written (without the '\0')
+// Return false if the JSON is incomplete or there has been an error
+bool JSONWriterEnd(JSONWriter* const that, size_t* const len) {
+#if BUILDMODE == 0
+  if (that == NULL) {
+    JSONErr->_type = PBErrTypeNullPointer;
+    sprintf(JSONErr->_msg, "'that' is null");
+    PBErrCatch(JSONErr);
+  }
+#endif
+  if (len != NULL)
+    *len = JSONWriterGetNb(that);
+  // The root must have been written and closed
+  if (that->_depth != 0 || !(that->_levels[0]._flagItem)) {
+    JSONWriterSetErrState("JSONWriterEnd");
+    return false;
+  }
+  // Write the remaining bytes on the stream
+  if (that->_stream != NULL)
+    return JSONWriterFlush(that, 0);
+  // Else, terminate the buffer, without counting the '\0'
+  if (!JSONWriterAppendChar(that, '\0'))
+    return false;
+  --(that->_len);
+  return true;
+}
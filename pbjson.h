@@ -10,6 +10,9 @@
 #include <math.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/stat.h>
 #include "pberr.h"
 #include "gset.h"
 #include "gtree.h"
@@ -17,8 +20,19 @@
 // ================= Define ==================
 
 #define PBJSON_INDENT "  "
-#define PBJSON_MAXLENGTHLBL 1024
+#define PBJSON_STRBUFSIZE 64
+#define PBJSON_INDEXMIN 8
 #define PBJSON_CONTEXTSIZE 10
+#define PBJSON_BLOCKSIZE 4096
+#define PBJSON_WRITEBLOCKSIZE 65536
+#define PBJSON_ARENABLOCKSIZE 65536
+#define PBJSON_ARENAALIGN 16
+#define PBJSON_CHUNKPERTHREAD 4
+#define PBJSON_SCALARSIZE 64
+#define PBJSON_BINMAGIC "PBJB"
+#define PBJSON_BINVERSION 1
+#define PBJSON_BINHEADERSIZE 5
+#define PBJSON_WRITERDEPTHMAX 64
 
 // ================= Data structure ===================
 
@@ -26,18 +40,759 @@
 #define JSONArrayVal GSetStr
 #define JSONArrayStruct GSetGenTreeStr
 
+// Array of values stored as labels ready to be moved into nodes by 
+// JSONAddPropArrMove. It's a distinct type from JSONArrayVal as its 
+// values can only be added with JSONArrayLblAdd and freed with 
+// JSONArrayLblFlush
+typedef struct JSONArrayLbl {
+  // JSONLbl of the values
+  GSet _set;
+} JSONArrayLbl;
+
+// Block of memory of an arena, the allocated bytes follow the header
+typedef struct JSONArenaBlock {
+  // Next block
+  struct JSONArenaBlock* _next;
+  // Number of bytes available in the block
+  size_t _size;
+  // Number of bytes currently allocated in the block
+  size_t _used;
+} JSONArenaBlock;
+
+// File mapped in memory and released with an arena
+typedef struct JSONArenaMap {
+  // Address of the mapping
+  void* _addr;
+  // Size in bytes of the mapping
+  size_t _size;
+  // Next mapping
+  struct JSONArenaMap* _next;
+} JSONArenaMap;
+
+// Bump allocator for the nodes and labels of JSON trees
+typedef struct JSONArena {
+  // First block of memory
+  JSONArenaBlock* _head;
+  // Block currently used for allocation
+  JSONArenaBlock* _cur;
+  // Roots of the JSON trees created in the arena
+  JSONArrayStruct _roots;
+  // Files mapped in memory by JSONLoadMapped, whose bytes are borrowed
+  // by the labels of the trees in the arena
+  JSONArenaMap* _maps;
+  // Flag to memorize if the JSON trees of the arena are loaded lazily,
+  // see JSONArenaSetLazy
+  bool _flagLazy;
+} JSONArena;
+
+// Index on the subtrees of a JSON node
+typedef struct JSONIndex {
+  // Number of subtrees in '_nodes'
+  long _nb;
+  // Size of '_nodes'
+  long _size;
+  // Subtrees, in the same order as in the node
+  JSONNode** _nodes;
+  // Flag to memorize if a subtree has been relabelled since the hash 
+  // table was built, in which case it's rebuilt when used
+  bool _flagStale;
+  // Number of subtrees in the hash table
+  long _nbHashed;
+  // Hash table of the subtrees' labels (open addressing), each slot 
+  // contains the position in '_nodes' plus one, or 0 if it's empty
+  // NULL until the first call to JSONProperty
+  long* _slots;
+  // Number of slots, a power of 2
+  size_t _nbSlot;
+} JSONIndex;
+
+// Type of the value of a node
+typedef enum JSONType {
+  // String, stored in the label of the node
+  JSONTypeStr,
+  // Signed integer, saved as a JSON number
+  JSONTypeInt,
+  // Floating point number, saved as a JSON number
+  JSONTypeReal,
+  // Boolean, saved as true or false
+  JSONTypeBool,
+  // Null, saved as null
+  JSONTypeNull
+} JSONType;
+
+// Kind of the value of a node in the binary encoding, stored in the 
+// low bits of the tag byte starting each node. The bit 
+// JSONBinFlagChildren of the tag is set if the node has subtrees
+typedef enum JSONBinKind {
+  // Node without label
+  JSONBinNone,
+  // String, followed by its length and its chars
+  JSONBinStr,
+  // Signed integer, followed by its zigzag varint encoding
+  JSONBinInt,
+  // Floating point number, followed by its 8 bytes in little endian
+  JSONBinReal,
+  // Booleans and null, without payload
+  JSONBinFalse,
+  JSONBinTrue,
+  JSONBinNull,
+  // Flag set in the tag if the node has subtrees, the tag is then 
+  // followed by the payload and the number of subtrees
+  JSONBinFlagChildren = 0x08
+} JSONBinKind;
+
+// Native payload of a typed value
+typedef union JSONPayload {
+  int64_t _int;
+  double _real;
+  bool _bool;
+} JSONPayload;
+
+// Instruction sets used to scan the JSONs being loaded
+typedef enum JSONSimd {
+  // One byte at a time
+  JSONSimdScalar,
+  // 16 bytes at a time
+  JSONSimdSSE2,
+  // 32 bytes at a time
+  JSONSimdAVX2
+} JSONSimd;
+
+// Floating point number _f*2^_e with a 64 bits mantissa, used to 
+// convert the doubles to their shortest decimal representation
+typedef struct JSONDiyFp {
+  uint64_t _f;
+  int _e;
+} JSONDiyFp;
+
+// Power of ten 10^_k approximated by _f*2^_e
+typedef struct JSONCachedPow {
+  uint64_t _f;
+  int _e;
+  int _k;
+} JSONCachedPow;
+
+// Cache of the compact serialization of a node
+typedef struct JSONCache {
+  // Number of bytes of the serialization
+  size_t _len;
+  // Bytes of the serialization (not null terminated), NULL if only the
+  // length is cached
+  char* _bytes;
+  // Flag to memorize if the bytes are cached too
+  bool _flagBytes;
+  // Flag to memorize if the cache matches the subtree of the node
+  bool _flagValid;
+} JSONCache;
+
+// Data attached to each JSON node
+typedef struct JSONLbl {
+  // Label of the node (null terminated), NULL if the node has no label
+  char* _str;
+  // Number of chars (excluding the null char) which can be stored in 
+  // the storage of the label, right after the JSONLbl. If it's 0 there
+  // may be no storage at all
+  size_t _size;
+  // Arena in which the node and its label are allocated, NULL if they 
+  // are allocated on the heap
+  JSONArena* _arena;
+  // Index on the subtrees of the node, NULL if not built yet
+  JSONIndex* _index;
+  // Cache of the serialization of the node, NULL if not enabled
+  JSONCache* _cache;
+  // Type of the value of the node, if it's not JSONTypeStr the node 
+  // has no label and its value is in '_val'
+  JSONType _type;
+  // Native value of the node if it's typed
+  JSONPayload _val;
+  // Flag to memorize if '_str' is borrowed from a file mapped by 
+  // JSONLoadMapped instead of being stored after the JSONLbl. A 
+  // borrowed label is never written nor freed, it's released with the 
+  // mapping when the arena is reset or freed
+  bool _flagBorrowed;
+  // Bytes of the object or array of the node, which are loaded in its 
+  // subtrees when they're first accessed, NULL if the node is loaded. 
+  // They are in the arena of the node or in its mapped file
+  char* _lazy;
+  // Number of bytes in '_lazy'
+  size_t _lazyLen;
+} JSONLbl;
+
+// Number of nodes whose serialization is cached
+// When there is none the modifications of the JSONs don't need to 
+// invalidate caches
+extern _Atomic long JSONNbCache;
+
+// Statistics of the PBJSON functions: counters of the allocations, of
+// the bytes read and written and of the calls, and time spent in the 
+// phases of the loading, saving and freeing
+// The scan of the input and the building of the tree are done in one 
+// pass, the loading is split in reading the stream and the rest
+typedef struct JSONStats {
+  // Number of nodes created
+  long _nbNode;
+  // Number of JSONLbl allocated, on the heap or in an arena
+  long _nbLbl;
+  // Number of bytes allocated for these JSONLbl and their labels
+  long _nbLblByte;
+  // Number of bytes consumed by the readers
+  long _nbByteRead;
+  // Number of bytes written by JSONSave, JSONSaveToBuffer, 
+  // JSONSaveBinary and JSONSaveBinaryToBuffer
+  long _nbByteWritten;
+  // Maximum depth of the objects and arrays loaded
+  long _depthMax;
+  // Number of calls to JSONLoad, JSONLoadFromStr, JSONLoadFromBuffer,
+  // JSONLoadMapped, JSONLoadBinary and JSONLoadBinaryFromBuffer
+  long _nbLoad;
+  // Number of calls to the saving functions counted in _nbByteWritten
+  long _nbSave;
+  // Number of calls to JSONFree
+  long _nbFree;
+  // Time in seconds spent in the loading functions counted in _nbLoad
+  // The times are measured only if enabled with JSONStatsSetTiming
+  double _timeLoad;
+  // Part of _timeLoad spent reading the streams
+  double _timeRead;
+  // Time in seconds spent in the saving functions counted in _nbSave
+  double _timeSave;
+  // Part of _timeSave spent writing the streams
+  double _timeWrite;
+  // Time in seconds spent in JSONFree
+  double _timeFree;
+} JSONStats;
+
+// Statistics of the current thread
+// They're thread local so that loading in several threads doesn't 
+// contend on them
+extern _Thread_local JSONStats JSONStatsCur;
+
+// Growable null terminated string, using its local storage until it 
+// needs more than PBJSON_STRBUFSIZE chars
+typedef struct JSONStrBuf {
+  // The string, points either to '_local' or to the heap
+  char* _str;
+  // Number of chars in the string
+  size_t _len;
+  // Number of chars which can be stored in '_str', including the 
+  // null character
+  size_t _size;
+  // Local storage
+  char _local[PBJSON_STRBUFSIZE];
+} JSONStrBuf;
+
+// Cursor on the bytes of a JSON being loaded
+typedef struct JSONReader {
+  // Stream from which the bytes are read by block, NULL if the reader
+  // is on a buffer
+  FILE* _stream;
+  // Flag to memorize if the stream can be read by full block (regular 
+  // files and memory streams) or must be read line by line (terminals, 
+  // pipes, sockets) to avoid waiting for data after the JSON
+  bool _blockMode;
+  // Bytes currently available
+  const char* _buf;
+  // Number of bytes currently available
+  size_t _len;
+  // Position of the cursor in the available bytes
+  size_t _pos;
+  // Storage for the block read from the stream
+  char _block[PBJSON_BLOCKSIZE];
+  // Storage for the strings spanning several blocks
+  JSONStrBuf _scratch;
+  // Flag to memorize if the loading reuses the existing nodes of the 
+  // JSON instead of appending new ones
+  bool _flagReuse;
+  // File mapped in memory by JSONLoadMapped which the labels can 
+  // borrow, NULL if the reader is not on a mapping
+  char* _map;
+  // Size in bytes of the mapping
+  size_t _mapLen;
+  // Arena in which the nested objects and arrays are memorized 
+  // unloaded when the loading is lazy, NULL else
+  JSONArena* _arenaLazy;
+  // Number of bytes consumed in the blocks before the current one
+  size_t _nbRead;
+  // Current and maximum depths of the objects and arrays loaded
+  long _depth;
+  long _depthMax;
+} JSONReader;
+
+// Object or array opened with the streaming writer API
+typedef struct JSONWriterLevel {
+  // Opening char, '{' or '['
+  char _open;
+  // Flag to memorize if a key or a value has been written in it
+  bool _flagItem;
+  // Flag to memorize if an object or array has been written in it
+  bool _flagNested;
+} JSONWriterLevel;
+
+// Buffered writer used to save the JSON, the output is assembled in a 
+// block flushed to the stream when full, or in a buffer growing as 
+// needed, or in a buffer of fixed size, or only counted
+// It's also the streaming writer of JSONWriterCreateStatic, which 
+// memorizes the opened objects and arrays
+typedef struct JSONWriter {
+  // Stream on which the block is flushed, NULL if the output stays in
+  // memory or is only counted
+  FILE* _stream;
+  // Block of bytes not yet flushed, or buffer of the whole output
+  char* _buf;
+  // Number of bytes in the block
+  size_t _len;
+  // Size of the block
+  size_t _size;
+  // Number of bytes already flushed
+  size_t _nbFlushed;
+  // Flag to grow the buffer instead of flushing it
+  bool _flagGrow;
+  // Flag to fail instead of flushing the buffer when it's full
+  bool _flagFixed;
+  // Flag for the compact form of the streaming writer
+  bool _compact;
+  // Number of objects and arrays opened with the streaming writer
+  int _depth;
+  // Flag to memorize if a key is waiting for its value
+  bool _flagKey;
+  // Objects and arrays opened with the streaming writer, the first 
+  // level is the root
+  JSONWriterLevel _levels[PBJSON_WRITERDEPTHMAX + 1];
+} JSONWriter;
+
+// Cursor on the children of a node being loaded
+typedef struct JSONLoadCursor {
+  // Node receiving the children
+  JSONNode* _node;
+  // Number of children loaded
+  long _nb;
+  // Flag to memorize if the existing children are reused
+  bool _flagReuse;
+  // Flag to memorize if there are existing children left to reuse
+  bool _flagIter;
+  // Iterator on the existing children
+  GSetIterForward _iter;
+  // File mapped in memory which the labels of the children can borrow,
+  // NULL if the reader is not on a mapping
+  char* _map;
+  // Size in bytes of the mapping
+  size_t _mapLen;
+} JSONLoadCursor;
+
+// Reader of a stream of JSON records, one per line (NDJSON)
+// The records are loaded in the same tree, allocated in an arena, whose
+// nodes and labels are reused from one record to the next
+typedef struct JSONRecords {
+  // Reader on the input
+  JSONReader _reader;
+  // Arena in which the records are loaded
+  JSONArena* _arena;
+  // Current record
+  JSONNode* _record;
+  // Number of records read
+  long _nbRecord;
+  // Flag to memorize if an error occured
+  bool _flagError;
+} JSONRecords;
+
+// Callbacks called by the event parser (JSONParse...) while it reads a 
+// JSON. Any callback can be NULL, in which case the corresponding event
+// is ignored. The strings given to the callbacks are the 'len' chars 
+// of 'str', not null terminated and valid only during the call. If a 
+// callback returns false the parsing stops.
+typedef struct JSONEventHandler {
+  // Called on the opening '{' of an object
+  bool (*_objStart)(void* const data);
+  // Called on the closing '}' of an object
+  bool (*_objEnd)(void* const data);
+  // Called on the opening '[' of an array
+  bool (*_arrStart)(void* const data);
+  // Called on the closing ']' of an array
+  bool (*_arrEnd)(void* const data);
+  // Called on the key of a property, before the events of its value
+  bool (*_key)(void* const data, const char* const str, 
+    const size_t len);
+  // Called on a string value, and on a number, a boolean or null if 
+  // '_scalar' is NULL, with the chars of the value as in the JSON
+  bool (*_val)(void* const data, const char* const str, 
+    const size_t len);
+  // Called on a number, a boolean or null, with its type and native 
+  // value
+  bool (*_scalar)(void* const data, const JSONType type, 
+    const JSONPayload val);
+  // User data given to each callback
+  void* _data;
+} JSONEventHandler;
+
+// Types of the steps of a JSONPath
+typedef enum JSONPathStepType {
+  // Property with a given key: .key, ['key'] or ["key"]
+  JSONPathStepKey,
+  // All the properties or values: .* or [*]
+  JSONPathStepWild,
+  // Value at a given position, negative from the end: [i]
+  JSONPathStepIndex,
+  // Values in a range of positions: [start:end:step]
+  JSONPathStepSlice
+} JSONPathStepType;
+
+// Step of a JSONPath
+typedef struct JSONPathStep {
+  // Type of the step
+  JSONPathStepType _type;
+  // Key of a JSONPathStepKey (null terminated) and its length
+  char* _key;
+  size_t _lenKey;
+  // Position of a JSONPathStepIndex, or first position of a 
+  // JSONPathStepSlice. Negative positions are relative to the end
+  long _start;
+  // Position after the last one of a JSONPathStepSlice
+  long _end;
+  // Flags to memorize if the first and end positions of a 
+  // JSONPathStepSlice are given, else the slice starts at the first 
+  // value or ends after the last one
+  bool _flagStart;
+  bool _flagEnd;
+  // Increment of the positions of a JSONPathStepSlice, at least 1
+  long _step;
+} JSONPathStep;
+
+// Compiled path expression selecting nodes in a JSON, see 
+// JSONPathCompile
+typedef struct JSONPath {
+  // Number of steps
+  long _nb;
+  // Steps
+  JSONPathStep* _steps;
+  // Storage of the keys of the steps
+  char* _keys;
+} JSONPath;
+
+// Types of the fields of a C struct described for the struct codec
+typedef enum JSONFieldType {
+  // int
+  JSONFieldInt,
+  // int64_t
+  JSONFieldInt64,
+  // float
+  JSONFieldFloat,
+  // double
+  JSONFieldDouble,
+  // bool
+  JSONFieldBool,
+  // Null terminated string stored in an array of char
+  JSONFieldStr,
+  // Nested struct described by its own JSONStructDesc
+  JSONFieldStruct
+} JSONFieldType;
+
+struct JSONStructDesc;
+
+// Description of a field of a C struct for the struct codec, usually 
+// declared with JSONStructFieldDef
+typedef struct JSONStructField {
+  // Key of the field in the JSON
+  const char* _name;
+  // Position in bytes of the field in the struct
+  size_t _offset;
+  // Type of the field, or of its elements if it's an array
+  JSONFieldType _type;
+  // Number of elements if the field is an array, 0 else
+  long _nb;
+  // Size in bytes of the field (of the whole array if it's an array, 
+  // of the array of char if it's a string)
+  size_t _size;
+  // Description of the nested struct if the type is JSONFieldStruct, 
+  // NULL else
+  const struct JSONStructDesc* _desc;
+} JSONStructField;
+
+// Description of a C struct for the struct codec, usually declared 
+// with JSONStructDescDef
+typedef struct JSONStructDesc {
+  // Fields of the struct, in the order they are saved
+  const JSONStructField* _fields;
+  // Number of fields
+  long _nb;
+} JSONStructDesc;
+
+// Declare the description of the field 'Field' of the struct 'Struct'
+// of type 'Type' (JSONFieldType), with 'Nb' elements if it's an array 
+// (0 else) and 'Desc' the address of the JSONStructDesc of the nested 
+// struct (NULL else). The key of the field is its name
+#define JSONStructFieldDef(Struct, Field, Type, Nb, Desc) \
+  {#Field, offsetof(Struct, Field), Type, Nb, \
+  sizeof(((Struct*)0)->Field), Desc}
+
+// Declare the description of a struct from the array of its fields 
+// 'Fields'
+#define JSONStructDescDef(Fields) \
+  {Fields, sizeof(Fields) / sizeof(Fields[0])}
+
+// Result of JSONFeed
+typedef enum JSONFeedRet {
+  // The bytes are invalid JSON, JSONErr describes the error
+  JSONFeedError,
+  // The bytes have been consumed but the JSON is not complete yet
+  JSONFeedNeedMore,
+  // The JSON is complete
+  JSONFeedComplete
+} JSONFeedRet;
+
+// States of the incremental parser
+typedef enum JSONFeederState {
+  // Before the opening '{' or '[' of the JSON
+  JSONFeederStateStart,
+  // In an object, before a key or the closing '}'
+  JSONFeederStateObj,
+  // In a key
+  JSONFeederStateKey,
+  // After a key, before the ':'
+  JSONFeederStateColon,
+  // After the ':', before the value
+  JSONFeederStateValue,
+  // In a string value
+  JSONFeederStateValStr,
+  // In a number, a boolean or null value
+  JSONFeederStateValScalar,
+  // After the opening '[' of an array
+  JSONFeederStateArrFirst,
+  // In a string value of an array
+  JSONFeederStateArrStr,
+  // In a number, a boolean or null value of an array
+  JSONFeederStateArrScalar,
+  // In an array of values, before the next value or the closing ']'
+  JSONFeederStateArrValNext,
+  // In an array of objects, before the next object or the closing ']'
+  JSONFeederStateArrObjNext,
+  // The JSON is complete
+  JSONFeederStateDone,
+  // An error occured
+  JSONFeederStateError
+} JSONFeederState;
+
+// Element of the stack of nodes of the incremental parser
+typedef struct JSONFeederFrame {
+  // Node receiving the properties or values
+  JSONNode* _node;
+  // Type of the node: '{' object, '"' array of values, '[' array of 
+  // objects, '\0' root of a JSON made of an array
+  char _type;
+} JSONFeederFrame;
+
+// Incremental parser, loading a JSON from chunks of bytes of any size
+typedef struct JSONFeeder {
+  // JSON receiving the loaded nodes
+  JSONNode* _json;
+  // Current state
+  JSONFeederState _state;
+  // Stack of the nodes being loaded
+  JSONFeederFrame* _stack;
+  // Number of nodes in the stack
+  long _depth;
+  // Size of the stack
+  long _size;
+  // Key of the property being loaded
+  JSONStrBuf _key;
+  // String being loaded
+  JSONStrBuf _str;
+  // Flag to manage the escape char across chunks
+  bool _flagEsc;
+} JSONFeeder;
+
 // ================ Functions declaration ====================
 
 // Free the memory used by the JSON node 'that' and its subnodes
 // The memory used by the label of each node is freed too
+// If 'that' has a parent it's removed from the subtrees of its parent
+// If 'that' is allocated in an arena, the nodes and labels of the arena
+// are released only when the arena is reset or freed, but 'that' is 
+// removed from its parent all the same
 void JSONFree(JSONNode** that);
 
+// Create a new arena
+JSONArena* JSONArenaCreate(void);
+
+// Free the memory used by the arena 'that' and by all the JSON trees
+// allocated in it
+void JSONArenaFree(JSONArena** that);
+
+// Release all the JSON trees allocated in the arena 'that' at once
+// The memory of the arena is kept for the next allocations
+void JSONArenaReset(JSONArena* const that);
+
+// Set the flag memorizing if the JSON trees of the arena 'that' are 
+// loaded lazily to 'flag'
+// When loading lazily, the objects and arrays nested in the loaded 
+// object or array are not loaded: their bytes are only skipped and 
+// memorized on the node of their property. They are loaded (one level
+// at a time) when the subtrees of that node are first accessed, through
+// JSONProperty, JSONValue, JSONProperties, JSONGetNbValue, saving, ...
+// The bytes are borrowed from the file loaded with JSONLoadMapped, or
+// else copied in the arena. The content of an unloaded value is not 
+// checked, if it's invalid its loading stops at the error and leaves 
+// the values loaded so far
+// The loaded trees can't be read concurrently by several threads as 
+// reading them may load their values
+void JSONArenaSetLazy(JSONArena* const that, const bool flag);
+
+// Allocate 'size' bytes in the arena 'that'
+void* JSONArenaAlloc(JSONArena* const that, const size_t size);
+
+// Create a new JSON node allocated in the arena 'that'
+// The nodes and labels added later to this node by the JSONAddProp 
+// family and the loader are allocated in the same arena
+// Nodes allocated in an arena must only be attached to nodes of the 
+// same arena
+JSONNode* JSONCreateInArena(JSONArena* const that);
+
+// Create a new JSON node to be attached to the node 'that'
+// The new node is allocated in the arena of 'that' if any, else on the 
+// heap
+JSONNode* JSONCreateChild(const JSONNode* const that);
+
+// Return the label of the JSON node 'that', NULL if it has no label
+#if BUILDMODE != 0
+static inline
+#endif
+char* JSONGetLabel(const JSONNode* const that);
+
 // Set the label of the JSON node 'that' to a copy of 'lbl'
 #if BUILDMODE != 0
 static inline
 #endif
 void JSONSetLabel(JSONNode* const that, const char* const lbl);
 
+// Set the label of the JSON node 'that' to a copy of the 'len' first 
+// chars of 'lbl', which doesn't need to be null terminated
+#if BUILDMODE != 0
+static inline
+#endif
+void JSONSetLabelLen(JSONNode* const that, const char* const lbl, 
+  const size_t len);
+
+// Append the node 'val' to the subtrees of the node 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+void JSONAppendVal(JSONNode* const that, JSONNode* const val);
+
+// Enable the cache of the serialization in compact form of the node 
+// 'that' when it's not the root of the saved JSON, which lets JSONSave
+// and JSONGetSaveSize skip it while it's unchanged
+// The length of the serialization is always cached, its bytes are 
+// cached too if 'flagBytes' equals true
+// The cache is invalidated when the node or one of its subtrees is 
+// modified through JSONSetLabel, JSONAddProp, JSONAppendVal, JSONFree
+// or a load
+void JSONCacheEnable(JSONNode* const that, const bool flagBytes);
+
+// Disable and free the cache of the serialization of the node 'that'
+void JSONCacheDisable(JSONNode* const that);
+
+// Invalidate the cache of the serialization of the node 'that' and of 
+// its parents
+// To be used after modifying the JSON 'that' without the functions of 
+// PBJSON
+#if BUILDMODE != 0
+static inline
+#endif
+void JSONCacheInvalidate(JSONNode* const that);
+
+// Return the type of the value of the JSON node 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+JSONType JSONGetType(const JSONNode* const that);
+
+// Set the value of the JSON node 'that' to the integer 'val'
+// The node loses its label
+#if BUILDMODE != 0
+static inline
+#endif
+void JSONSetInt(JSONNode* const that, const int64_t val);
+
+// Set the value of the JSON node 'that' to the floating point number 
+// 'val'. The node loses its label
+#if BUILDMODE != 0
+static inline
+#endif
+void JSONSetReal(JSONNode* const that, const double val);
+
+// Set the value of the JSON node 'that' to the boolean 'val'
+// The node loses its label
+#if BUILDMODE != 0
+static inline
+#endif
+void JSONSetBool(JSONNode* const that, const bool val);
+
+// Set the value of the JSON node 'that' to null
+// The node loses its label
+#if BUILDMODE != 0
+static inline
+#endif
+void JSONSetNull(JSONNode* const that);
+
+// Return the value of the JSON node 'that' as an integer
+// Floating point values are truncated, NaN is 0, out of range values 
+// are clamped to INT64_MIN and INT64_MAX, booleans are 0 or 1, null is 0,
+// strings are converted from their label if it's a number
+#if BUILDMODE != 0
+static inline
+#endif
+int64_t JSONGetInt(const JSONNode* const that);
+
+// Return the value of the JSON node 'that' as a floating point number
+// Booleans are 0.0 or 1.0, null is 0.0, strings are converted from 
+// their label if it's a number
+#if BUILDMODE != 0
+static inline
+#endif
+double JSONGetReal(const JSONNode* const that);
+
+// Return the value of the JSON node 'that' as a boolean
+// Numbers are true if not null, null is false, strings are true if 
+// their label is "true"
+#if BUILDMODE != 0
+static inline
+#endif
+bool JSONGetBool(const JSONNode* const that);
+
+// Return the instruction set used to scan the JSONs being loaded, by 
+// default the best one supported by the processor
+JSONSimd JSONGetSimd(void);
+
+// Use the instruction set 'simd' to scan the JSONs being loaded, or the
+// best one supported by the processor if it doesn't support 'simd'
+// Must not be called while JSONs are being loaded
+// Return the instruction set actually used
+JSONSimd JSONSetSimd(const JSONSimd simd);
+
+// Write in 'str' the integer 'val' in decimal, followed by '\0'
+// 'str' must have room for PBJSON_SCALARSIZE chars
+// Return the number of chars written, excluding the '\0'
+size_t JSONFormatInt(const int64_t val, char* const str);
+
+// Write in 'str' the shortest decimal representation of the floating 
+// point number 'val' which converts back to 'val', followed by '\0'
+// It's the shortest for 99.9% of the numbers, one digit longer for the
+// others (Grisu2 algorithm)
+// The representation always has a decimal point or an exponent, and
+// infinity and NaN, which can't be represented in JSON, are written as 
+// null. It doesn't depend on the locale
+// 'str' must have room for PBJSON_SCALARSIZE chars
+// Return the number of chars written, excluding the '\0'
+size_t JSONFormatReal(const double val, char* const str);
+
+// Convert the 'len' first chars of 'str', a JSON number, to its native 
+// value. Numbers without fraction nor exponent which fit in 64 bits are
+// integers, other numbers are floating point numbers. On success 
+// '*type' and '*val' are set to the type and value of the number
+// The conversion doesn't depend on the locale
+// Return false if 'str' is not a valid JSON number
+bool JSONScanNumber(const char* const str, const size_t len, 
+  JSONType* const type, JSONPayload* const val);
+
 // Add a property to the node 'that'. The property's key is a copy of a 
 // 'key' and its value is a copy of 'val'
 #if BUILDMODE != 0
@@ -46,6 +801,47 @@ static inline
 void _JSONAddPropStr(JSONNode* const that, const char* const key, 
   char* const val);
 
+// Add a property to the node 'that'. The property's key is a copy of a 
+// 'key' and its value is the integer 'val'
+#if BUILDMODE != 0
+static inline
+#endif
+void _JSONAddPropInt(JSONNode* const that, const char* const key, 
+  const int64_t val);
+
+// Add a property to the node 'that'. The property's key is a copy of a 
+// 'key' and its value is the unsigned integer 'val'
+// Values above INT64_MAX don't fit in an integer node and are stored as 
+// a floating point number, which may round them
+#if BUILDMODE != 0
+static inline
+#endif
+void _JSONAddPropUInt(JSONNode* const that, const char* const key, 
+  const uint64_t val);
+
+// Add a property to the node 'that'. The property's key is a copy of a 
+// 'key' and its value is the floating point number 'val'
+#if BUILDMODE != 0
+static inline
+#endif
+void _JSONAddPropReal(JSONNode* const that, const char* const key, 
+  const double val);
+
+// Add a property to the node 'that'. The property's key is a copy of a 
+// 'key' and its value is the boolean 'val'
+#if BUILDMODE != 0
+static inline
+#endif
+void _JSONAddPropBool(JSONNode* const that, const char* const key, 
+  const bool val);
+
+// Add a property to the node 'that'. The property's key is a copy of a 
+// 'key' and its value is null
+#if BUILDMODE != 0
+static inline
+#endif
+void JSONAddPropNull(JSONNode* const that, const char* const key);
+
 // Add a property to the node 'that'. The property's key is a copy of a 
 // 'key' and its value is the JSON node 'val'
 #if BUILDMODE != 0
@@ -59,6 +855,15 @@ void _JSONAddPropObj(JSONNode* const that, const char* const key,
 void _JSONAddPropArr(JSONNode* const that, const char* const key, 
   const GSetStr* const set);
 
+// Add a property to the node 'that'. The property's key is a copy of a 
+// 'key' and its values are the values of the array of values 'set', 
+// moved into the new nodes instead of being copied. 'set' is empty 
+// after the call
+// If 'that' is in an arena the values are copied in the arena and 
+// freed
+void JSONAddPropArrMove(JSONNode* const that, const char* const key, 
+  JSONArrayLbl* const set);
+
 // Add a property to the node 'that'. The property's key is a copy of a 
 // 'key' and its values are the GenTreeStr in the GSetGenTreeStr 'set'
 void _JSONAddPropArrObj(JSONNode* const that, const char* const key, 
@@ -75,10 +880,182 @@ bool JSONSave(const JSONNode* const that, FILE* const stream,
 // Return true if it could load, false else
 bool JSONLoad(JSONNode* const that, FILE* const stream);
 
-// Load the JSON 'that' from the string 'str' seen as a stream
+// Load the JSON 'that' from the string 'str'
 // Return true if it could load, false else
 bool JSONLoadFromStr(JSONNode* const that, const char* const str);
 
+// Load the JSON 'that' from the 'len' first bytes of the buffer 'buf'
+// The buffer doesn't need to be null terminated
+// Return true if it could load, false else
+bool JSONLoadFromBuffer(JSONNode* const that, const char* const buf, 
+  const size_t len);
+
+// Load the JSON 'that' from the file at path 'path' mapped in memory
+// 'that' must be allocated in an arena. The labels without escape 
+// sequence borrow their chars from the mapping instead of being 
+// copied, they stay valid until the arena is reset or freed, which 
+// also unmaps the file
+// The mapping is private and each borrowed label is null terminated in
+// place, which copies on write every page holding a label. For a usual
+// JSON the whole file ends up as private anonymous memory: it's not 
+// shared with other processes mapping the same file and can't be 
+// dropped and read again under memory pressure. It saves the copy of 
+// the labels and their JSONLbl, not the memory of the file
+// Return true if it could load, false else
+bool JSONLoadMapped(JSONNode* const that, const char* const path);
+
+// Load the subtrees of the node 'that' if they have not been loaded yet
+// by a lazy loading, see JSONArenaSetLazy
+// Return true if they are loaded, false if their bytes are invalid
+bool JSONLoadLazy(JSONNode* const that);
+
+// Return the node 'that' after loading its subtrees if they have not 
+// been loaded yet by a lazy loading
+#if BUILDMODE != 0
+static inline
+#endif
+JSONNode* JSONGetLoaded(const JSONNode* const that);
+
+// Parse the JSON in the stream 'stream' and call the callbacks of the 
+// handler 'handler' on each event, without building the JSON tree
+// The memory used is independent of the size of the JSON
+// Return true if it could parse, false if the JSON is invalid or a 
+// callback stopped the parsing
+bool JSONParse(const JSONEventHandler* const handler, 
+  FILE* const stream);
+
+// Parse the JSON in the null terminated string 'str' and call the 
+// callbacks of the handler 'handler' on each event
+// Return true if it could parse, false else
+bool JSONParseFromStr(const JSONEventHandler* const handler, 
+  const char* const str);
+
+// Parse the JSON in the 'len' first bytes of the buffer 'buf' and call 
+// the callbacks of the handler 'handler' on each event
+// The buffer doesn't need to be null terminated
+// Return true if it could parse, false else
+bool JSONParseFromBuffer(const JSONEventHandler* const handler, 
+  const char* const buf, const size_t len);
+
+// Create an incremental parser loading its input into the JSON 'json'
+JSONFeeder* JSONFeederCreate(JSONNode* const json);
+
+// Free the memory used by the incremental parser 'that'
+// The JSON it has loaded is not freed
+void JSONFeederFree(JSONFeeder** that);
+
+// Reset the incremental parser 'that' to load a new JSON into 'json'
+void JSONFeederReset(JSONFeeder* const that, JSONNode* const json);
+
+// Feed the 'len' bytes of 'buf' to the incremental parser 'that'
+// The bytes can be any piece of the JSON, they are loaded as they 
+// arrive, without seeking or buffering the whole JSON
+// If 'nbUsed' is not NULL, it's set to the number of bytes consumed, 
+// which is less than 'len' only if the JSON is complete before the 
+// end of 'buf'
+// Return JSONFeedNeedMore until the JSON is complete, JSONFeedComplete 
+// once it is, or JSONFeedError if the bytes are not a valid JSON
+JSONFeedRet JSONFeed(JSONFeeder* const that, const char* const buf, 
+  const size_t len, size_t* const nbUsed);
+
+// Create a reader of JSON records, one per line, on the stream 
+// 'stream'
+JSONRecords* JSONRecordsCreate(FILE* const stream);
+
+// Create a reader of JSON records, one per line, on the 'len' first 
+// bytes of the buffer 'buf'
+// The buffer must stay valid until the reader is freed
+JSONRecords* JSONRecordsCreateFromBuffer(const char* const buf, 
+  const size_t len);
+
+// Free the memory used by the reader of records 'that' and its records
+// The unconsumed bytes are given back to the stream
+void JSONRecordsFree(JSONRecords** that);
+
+// Load the next record of the reader 'that'
+// Empty lines are skipped
+// Return the record, or NULL if there is no more record or if the 
+// record is invalid (in which case JSONRecordsIsError() is true)
+// The record belongs to the reader and is valid until the next call, 
+// its nodes are reused for the next record
+JSONNode* JSONRecordsNext(JSONRecords* const that);
+
+// Return the number of records read by the reader 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+long JSONRecordsGetNb(const JSONRecords* const that);
+
+// Return true if the reader of records 'that' has met an invalid 
+// record, false else
+#if BUILDMODE != 0
+static inline
+#endif
+bool JSONRecordsIsError(const JSONRecords* const that);
+
+// Set the error used by the JSON functions in the calling thread to 
+// 'err', or back to the global JSONErr if 'err' is NULL
+// Each thread loading JSONs concurrently must use its own error
+void JSONSetThreadErr(PBErr* const err);
+
+// Return the error used by the JSON functions in the calling thread
+PBErr* JSONGetThreadErr(void);
+
+// Return the statistics of the JSON functions in the calling thread, 
+// cumulated since the last call to JSONStatsReset
+// The statistics of one call are got by resetting them before the call
+// The statistics of the threads of JSONLoadBuffersParallel and 
+// JSONRecordsParallel are added to the ones of the calling thread, 
+// their times are summed over the threads
+JSONStats JSONStatsGet(void);
+
+// Reset the statistics of the JSON functions in the calling thread
+void JSONStatsReset(void);
+
+// Enable the timing of the phases in the statistics of the calling 
+// thread if 'flag' is true, disable it else. It's disabled by default 
+// as it reads the clock at each call and each block read or written
+void JSONStatsSetTiming(const bool flag);
+
+// Return true if the timing of the phases is enabled in the calling 
+// thread, false else
+bool JSONStatsGetTiming(void);
+
+// Save the statistics 'that' as a JSON object on the stream 'stream', 
+// with one property per field named as the field without its leading 
+// underscore
+// If 'compact' equals true save in compact form, else save in easily 
+// readable form
+// Return true if it could save, false else
+bool JSONStatsSave(const JSONStats* const that, FILE* const stream, 
+  const bool compact);
+
+// Load in parallel with 'nbThread' threads the 'nb' JSONs in the 
+// buffers 'bufs' of 'lens' bytes into the JSONs 'jsons'
+// Each JSON must be used by only one buffer
+// If 'errs' is not NULL, the error of each buffer is stored in the 
+// array of 'nb' PBErr 'errs'
+// Return true if all the buffers could be loaded, false else, in which 
+// case the error of the first invalid buffer is copied in the error of
+// the calling thread
+bool JSONLoadBuffersParallel(JSONNode** const jsons, 
+  const char* const* const bufs, const size_t* const lens, 
+  const long nb, const int nbThread, PBErr* const errs);
+
+// Read in parallel with 'nbThread' threads the records, one per line, 
+// in the 'len' bytes of the buffer 'buf'
+// The buffer is split in chunks at line boundaries, each thread reads 
+// its chunks with its own JSONRecords and error, and calls 'fun' on 
+// each record with the index of the thread (to manage per-thread data) 
+// and 'data'. The records are not given in the order of the buffer. If
+// 'fun' returns false the reading stops.
+// Return true if all the records could be read, false else, in which 
+// case the error of the first invalid record is copied in the error of
+// the calling thread
+bool JSONRecordsParallel(const char* const buf, const size_t len, 
+  const int nbThread, bool (*fun)(JSONNode* const record, 
+  const int iThread, void* const data), void* const data);
+
 // Save the JSON 'that' in the string 'str' of length at least equal to 
 // 'strLen'
 // If 'compact' equals true save in compact form, else save in easily 
@@ -87,11 +1064,212 @@ bool JSONLoadFromStr(JSONNode* const that, const char* const str);
 bool JSONSaveToStr(const JSONNode* const that, char* const str, 
   const size_t strLen, const bool compact);
 
+// Save the JSON 'that' in a null terminated buffer sized exactly to 
+// the output and return it
+// If 'arena' is not null the buffer is allocated in it, else it is 
+// allocated on the heap and must be freed by the user
+// If 'len' is not null it's set to the length of the output (without 
+// the terminating '\0')
+// If 'compact' equals true save in compact form, else save in easily 
+// readable form
+char* JSONSaveToBuffer(const JSONNode* const that, 
+  JSONArena* const arena, size_t* const len, const bool compact);
+
+// Return the number of bytes of the JSON 'that' saved in compact form 
+// if 'compact' equals true, else in easily readable form, without 
+// writing it
+size_t JSONGetSaveSize(const JSONNode* const that, const bool compact);
+
+// Save the JSON 'that' on the stream 'stream' in the binary encoding: 
+// the header PBJSON_BINMAGIC and PBJSON_BINVERSION, the number of 
+// subtrees of 'that' then each subtree in depth first order as a tag 
+// byte (cf JSONBinKind), its payload and its number of subtrees. 
+// Lengths and numbers of subtrees are LEB128 varints
+// Return true if it could save, false else
+bool JSONSaveBinary(const JSONNode* const that, FILE* const stream);
+
+// Save the JSON 'that' in the binary encoding in a buffer sized 
+// exactly to the output and return it
+// If 'arena' is not null the buffer is allocated in it, else it is 
+// allocated on the heap and must be freed by the user
+// If 'len' is not null it's set to the length of the output
+char* JSONSaveBinaryToBuffer(const JSONNode* const that, 
+  JSONArena* const arena, size_t* const len);
+
+// Load the JSON 'that' from the binary encoding in the stream 'stream'
+// Return true if it could load, false else
+bool JSONLoadBinary(JSONNode* const that, FILE* const stream);
+
+// Load the JSON 'that' from the binary encoding in the 'len' first 
+// bytes of the buffer 'buf'
+// Return true if it could load, false else
+bool JSONLoadBinaryFromBuffer(JSONNode* const that, 
+  const char* const buf, const size_t len);
+
+// Save the C struct 'data' described by 'desc' on the stream 'stream'
+// directly from its fields, without building a JSON tree. The output 
+// is the same as JSONSave of the equivalent JSON with typed values
+// If 'compact' equals true save in compact form, else save in easily 
+// readable form
+// Return true if it could save, false else
+bool JSONStructSave(const void* const data, 
+  const JSONStructDesc* const desc, FILE* const stream, 
+  const bool compact);
+
+// Save the C struct 'data' described by 'desc' in a null terminated 
+// buffer allocated on the heap and return it, cf JSONStructSave
+// If 'len' is not null it's set to the length of the output (without 
+// the terminating '\0')
+char* JSONStructSaveToBuffer(const void* const data, 
+  const JSONStructDesc* const desc, size_t* const len, 
+  const bool compact);
+
+// Load the C struct 'data' described by 'desc' from the stream 
+// 'stream' directly into its fields, without building a JSON tree
+// The keys are expected in the order of the description, others are 
+// found by a linear search. Unknown keys and null values are skipped, 
+// missing fields are left unchanged. Numbers can be quoted, and an 
+// array can be a single value or an empty string, as saved by JSONSave
+// Return true if it could load, false else
+bool JSONStructLoad(void* const data, const JSONStructDesc* const desc, 
+  FILE* const stream);
+
+// Load the C struct 'data' described by 'desc' from the 'len' first 
+// bytes of the buffer 'buf', cf JSONStructLoad
+// Return true if it could load, false else
+bool JSONStructLoadFromBuffer(void* const data, 
+  const JSONStructDesc* const desc, const char* const buf, 
+  const size_t len);
+
+// Return a streaming writer saving a JSON, one object, array, key or 
+// value at a time, without building a JSON tree. The output is the 
+// same as JSONSave of the equivalent JSON in compact form if 'compact'
+// equals true, else in readable form, except that arrays with one or 
+// no value keep their brackets
+// If 'stream' is not null the output is written on it by blocks of 
+// 'size' bytes stored in 'buf', else it's written in 'buf' which must 
+// be large enough for the whole output and its terminating '\0'
+// The writer doesn't allocate memory
+JSONWriter JSONWriterCreateStatic(FILE* const stream, char* const buf, 
+  const size_t size, const bool compact);
+
+// Open an object with the writer 'that', at the root, as the value of 
+// the last key or as the next value of the current array
+// Return true if it could write, false else
+bool JSONWriterBeginObject(JSONWriter* const that);
+
+// Close the current object of the writer 'that'
+// Return true if it could write, false else
+bool JSONWriterEndObject(JSONWriter* const that);
+
+// Open an array with the writer 'that', at the root, as the value of 
+// the last key or as the next value of the current array
+// Return true if it could write, false else
+bool JSONWriterBeginArray(JSONWriter* const that);
+
+// Close the current array of the writer 'that'
+// Return true if it could write, false else
+bool JSONWriterEndArray(JSONWriter* const that);
+
+// Write the key 'key' of the next property of the current object of 
+// the writer 'that'
+// Return true if it could write, false else
+bool JSONWriterKey(JSONWriter* const that, const char* const key);
+
+// Write the string 'val' with the writer 'that', as the value of the 
+// last key or as the next value of the current array
+// Return true if it could write, false else
+bool _JSONWriterValueStr(JSONWriter* const that, const char* const val);
+
+// Same as _JSONWriterValueStr for an integer
+bool _JSONWriterValueInt(JSONWriter* const that, const int64_t val);
+
+// Same as _JSONWriterValueStr for an unsigned integer, written exactly 
+// even above INT64_MAX
+bool _JSONWriterValueUInt(JSONWriter* const that, const uint64_t val);
+
+// Same as _JSONWriterValueStr for a floating point number
+bool _JSONWriterValueReal(JSONWriter* const that, const double val);
+
+// Same as _JSONWriterValueStr for a boolean
+bool _JSONWriterValueBool(JSONWriter* const that, const bool val);
+
+// Same as _JSONWriterValueStr for null
+bool JSONWriterValueNull(JSONWriter* const that);
+
+// End the output of the writer 'that': flush the remaining bytes on 
+// its stream, or terminate its buffer with '\0'. If 'len' is not null
+// it's set to the number of bytes written (without the '\0')
+// Return false if the JSON is incomplete or there has been an error
+bool JSONWriterEnd(JSONWriter* const that, size_t* const len);
+
 // Return the JSONNode of the property with label 'lbl' of the 
 // JSON 'that'
 // If the property doesn't exist return NULL
+// If 'that' has at least PBJSON_INDEXMIN properties, the first call 
+// builds a hash index on its properties which makes the following 
+// calls constant time. The index is updated automatically when 
+// properties are added or relabelled
 JSONNode* JSONProperty(const JSONNode* const that, const char* const lbl);
 
+// Compile the path expression 'expr' which selects nodes in a JSON
+// The expression starts with '$', the root node, followed by steps 
+// each selecting among the subtrees of the nodes selected so far:
+//   .key, ['key'] or ["key"]: the property 'key', like JSONProperty
+//   .* or [*]: all the properties or values
+//   [i]: the 'i'-th value, like JSONValue, negative from the end
+//   [start:end:step]: the values from 'start' to 'end' (excluded) every
+//     'step' (at least 1), each part being optional as in Python
+// For example "$.a.b[3].c" is the property 'c' of the fourth struct of 
+// the array of structs 'b' in the property 'a'. As in JSONProperty 
+// the selected properties are the nodes of their key, and the values 
+// of an array are its subtrees
+// The compiled path can be evaluated on any number of JSON
+// Return the compiled path, or NULL if the expression is invalid
+JSONPath* JSONPathCompile(const char* const expr);
+
+// Free the memory used by the compiled path 'that'
+void JSONPathFree(JSONPath** that);
+
+// Append to 'matches' the nodes of the JSON 'json' selected by the 
+// compiled path 'that', in the order of the JSON. The nodes still 
+// belong to 'json'. The properties are looked up with the index of 
+// their parent if it has one
+// Return the number of nodes appended
+long JSONPathEval(const JSONPath* const that, const JSONNode* const json, 
+  JSONArrayStruct* const matches);
+
+// Return the first node of the JSON 'json' selected by the compiled 
+// path 'that', NULL if there is none
+JSONNode* JSONPathGet(const JSONPath* const that, 
+  const JSONNode* const json);
+
+// Parse the JSON in the stream 'stream' and append to the node 
+// 'matches' a copy of each node selected by the compiled path 'that', 
+// with its subtrees, as JSONPathEval would select them in the loaded 
+// JSON. The rest of the JSON is skipped without being loaded nor fully
+// checked
+// The positions of the steps must not be relative to the end
+// Return true if it could parse, false else
+bool JSONPathLoad(const JSONPath* const that, JSONNode* const matches, 
+  FILE* const stream);
+
+// Same as JSONPathLoad on the 'len' first bytes of the buffer 'buf'
+bool JSONPathLoadFromBuffer(const JSONPath* const that, 
+  JSONNode* const matches, const char* const buf, const size_t len);
+
+// Return the 'iVal'-th value of the JSON 'that'
+// If 'that' has at least PBJSON_INDEXMIN values, the first call builds 
+// an array of its values which makes the following calls constant time. 
+// The array is updated automatically when values are appended
+JSONNode* JSONValue(const JSONNode* const that, const long iVal);
+
+// Return the values of the JSON 'that' as an array of 
+// JSONGetNbValue(that) nodes, in order
+// The array belongs to 'that' and is valid until values are added to 
+// or removed from 'that'
+JSONNode* const* JSONGetValues(const JSONNode* const that);
+
 // Add a copy of the value 'val' to the array of value 'that'
 #if BUILDMODE != 0
 static inline
@@ -104,16 +1282,30 @@ static inline
 #endif
 void JSONArrayValFlush(JSONArrayVal* const that);
 
+// Add a copy of the value 'val' to the array of labels 'that'
+// The copy is stored as a label ready to be moved into a node by 
+// JSONAddPropArrMove
+#if BUILDMODE != 0
+static inline
+#endif
+void JSONArrayLblAdd(JSONArrayLbl* const that, const char* const val);
+
+// Free memory used by the static array of labels 'that'
+#if BUILDMODE != 0
+static inline
+#endif
+void JSONArrayLblFlush(JSONArrayLbl* const that);
+
 // Wrapping of GenTreeStr functions
 #define JSONCreate() ((JSONNode*)GenTreeStrCreate())
-#define JSONLabel(Node) GenTreeData(Node)
-#define JSONAppendVal(Key, Val) GenTreeAppendSubtree(Key, Val)
-#define JSONProperties(JSON) GenTreeSubtrees(JSON)
-#define JSONValue(JSON, Index) GenTreeSubtree(JSON, Index)
-#define JSONGetNbValue(JSON) GSetNbElem(GenTreeSubtrees(JSON))
+#define JSONLabel(Node) JSONGetLabel(Node)
+#define JSONProperties(JSON) GenTreeSubtrees(JSONGetLoaded(JSON))
+#define JSONGetNbValue(JSON) GSetNbElem(JSONProperties(JSON))
 
 // Wrapping of GSetStr functions
 #define JSONArrayValCreateStatic() GSetStrCreateStatic()
+#define JSONArrayLblCreateStatic() \
+  ((JSONArrayLbl){._set = GSetCreateStatic()})
 
 // Wrapping of GSetGenTreeStr functions
 #define JSONArrayStructCreateStatic() GSetGenTreeStrCreateStatic()
@@ -123,8 +1315,18 @@ void JSONArrayValFlush(JSONArrayVal* const that);
 // Shortcut to get the label of the first value of the JSONNode 'node'
 #define JSONLblVal(node) (JSONLabel(JSONValue((node), 0)))
 
+// Shortcuts to get the first value of the JSONNode 'node' as a native 
+// type
+#define JSONIntVal(node) (JSONGetInt(JSONValue((node), 0)))
+#define JSONRealVal(node) (JSONGetReal(JSONValue((node), 0)))
+#define JSONBoolVal(node) (JSONGetBool(JSONValue((node), 0)))
+
 // ================= Polymorphism ==================
 
+// Add a property with key 'Key' and value 'Val' to the node 'Node'
+// Numbers are added as typed values. The constants true and false are
+// int in C, so booleans must be bool variables or casted to bool. A 
+// null value is added with NULL
 #define JSONAddProp(Node, Key, Val) _Generic(Val, \
   char*: _JSONAddPropStr, \
   const char*: _JSONAddPropStr, \
@@ -134,8 +1336,31 @@ void JSONArrayValFlush(JSONArrayVal* const that);
   const GSetStr*: _JSONAddPropArr, \
   GSetGenTreeStr*: _JSONAddPropArrObj, \
   const GSetGenTreeStr*: _JSONAddPropArrObj, \
+  int: _JSONAddPropInt, \
+  unsigned int: _JSONAddPropInt, \
+  long: _JSONAddPropInt, \
+  unsigned long: _JSONAddPropUInt, \
+  long long: _JSONAddPropInt, \
+  unsigned long long: _JSONAddPropUInt, \
+  float: _JSONAddPropReal, \
+  double: _JSONAddPropReal, \
+  bool: _JSONAddPropBool, \
   default: PBErrInvalidPolymorphism) (Node, Key, Val)
 
+#define JSONWriterValue(Writer, Val) _Generic(Val, \
+  char*: _JSONWriterValueStr, \
+  const char*: _JSONWriterValueStr, \
+  int: _JSONWriterValueInt, \
+  unsigned int: _JSONWriterValueInt, \
+  long: _JSONWriterValueInt, \
+  unsigned long: _JSONWriterValueUInt, \
+  long long: _JSONWriterValueInt, \
+  unsigned long long: _JSONWriterValueUInt, \
+  float: _JSONWriterValueReal, \
+  double: _JSONWriterValueReal, \
+  bool: _JSONWriterValueBool, \
+  default: PBErrInvalidPolymorphism) (Writer, Val)
+
 // ================ static inliner ====================
 
 #if BUILDMODE != 0